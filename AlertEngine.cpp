@@ -0,0 +1,287 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+AlertEngine.cpp
+
+This file contains the sources for the threshold alerts.
+*/
+
+#include "AlertEngine.h"
+
+#include <math.h>
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+AlertEngine::AlertEngine()
+    : mTerminalCount( 0 )
+{
+}
+
+//!************************************************************************
+//! Get the stock rules
+//!
+//! @returns: the rules for a single terminal on a stock installation
+//!************************************************************************
+std::vector<AlertRule> AlertEngine::defaultRules()
+{
+    const AlertRule RULES[] =
+    {
+        //  Name                        Watched                         Condition                   Threshold           Hysteresis  MinDurationMs   HoldMs
+        {   "Low Rx SNR",               METRIC_RX_SNR_DB,               ALERT_CONDITION_BELOW,      4.0,                1.0,        10000,          0       },
+        {   "Low Rx power",             METRIC_RX_PWR_DBM,              ALERT_CONDITION_BELOW,      -70.0,              2.0,        10000,          0       },
+        {   "High TRIA temperature",    METRIC_TEMPERATURE_C,           ALERT_CONDITION_ABOVE,      70.0,               5.0,        30000,          0       },
+        {   "High cable resistance",    METRIC_CABLE_RESISTANCE_OHM,    ALERT_CONDITION_ABOVE,      20.0,               2.0,        30000,          0       },
+        {   "Loss of sync",             METRIC_LOSS_OF_SYNC_COUNT,      ALERT_CONDITION_RISING,     0.0,                0.0,        0,              60000   },
+        {   "Modem offline",            METRIC_MODEM_STATE,             ALERT_CONDITION_NOT_EQUAL,  MODEM_STATE_ONLINE, 0.0,        5000,           0       }
+    };
+
+    return std::vector<AlertRule>( RULES, RULES + sizeof( RULES ) / sizeof( RULES[0] ) );
+}
+
+//!************************************************************************
+//! Compile a rule. The states of the terminals added before get a fresh
+//! state for the new rule.
+//!
+//! @returns: the rule index
+//!************************************************************************
+size_t AlertEngine::addRule
+    (
+    const AlertRule&    aRule       //!< rule to compile
+    )
+{
+    CompiledRule compiled;
+    compiled.Watched = static_cast<uint8_t>( aRule.Watched );
+    compiled.Condition = static_cast<uint8_t>( aRule.Condition );
+    compiled.RaiseLevel = aRule.Threshold;
+    compiled.ClearLevel = aRule.Threshold;
+    compiled.MinDurationMs = aRule.MinDurationMs;
+    compiled.HoldMs = aRule.HoldMs;
+
+    switch( aRule.Condition )
+    {
+        case ALERT_CONDITION_ABOVE:
+            compiled.ClearLevel = aRule.Threshold - fabs( aRule.Hysteresis );
+            break;
+
+        case ALERT_CONDITION_BELOW:
+            compiled.ClearLevel = aRule.Threshold + fabs( aRule.Hysteresis );
+            break;
+
+        default:
+            break;
+    }
+
+    const size_t oldRuleCount = mRules.size();
+    const size_t newRuleCount = oldRuleCount + 1;
+
+    if( mTerminalCount > 0 )
+    {
+        std::vector<RuleState> states( mTerminalCount * newRuleCount, initialState() );
+
+        for( size_t terminal = 0; terminal < mTerminalCount; terminal++ )
+        {
+            for( size_t i = 0; i < oldRuleCount; i++ )
+            {
+                states[terminal * newRuleCount + i] = mStates[terminal * oldRuleCount + i];
+            }
+        }
+
+        mStates.swap( states );
+    }
+
+    mRules.push_back( aRule );
+    mCompiledRules.push_back( compiled );
+
+    return oldRuleCount;
+}
+
+//!************************************************************************
+//! Add a terminal, with all its alerts cleared
+//!
+//! @returns: the terminal index
+//!************************************************************************
+size_t AlertEngine::addTerminal()
+{
+    mStates.resize( mStates.size() + mRules.size(), initialState() );
+    return mTerminalCount++;
+}
+
+//!************************************************************************
+//! Evaluate all rules on a sample of a terminal. Metrics not reported by
+//! the sample leave the state of their rules unchanged.
+//!
+//! @returns: nothing
+//!************************************************************************
+void AlertEngine::evaluate
+    (
+    const size_t                aTerminal,  //!< terminal index
+    const MetricSample&         aSample,    //!< decoded sample
+    std::vector<AlertEvent>&    aEvents     //!< appended changes of the alert states
+    )
+{
+    const size_t ruleCount = mCompiledRules.size();
+    const CompiledRule* rules = mCompiledRules.data();
+    RuleState* states = mStates.data() + aTerminal * ruleCount;
+    const int64_t timeMs = aSample.TimeMs;
+
+    for( size_t i = 0; i < ruleCount; i++ )
+    {
+        const CompiledRule& rule = rules[i];
+        RuleState& state = states[i];
+        const double value = aSample.Values[rule.Watched];
+
+        if( isnan( value ) )
+        {
+            continue;
+        }
+
+        bool breach = false;
+        bool clear = false;
+
+        switch( rule.Condition )
+        {
+            case ALERT_CONDITION_ABOVE:
+                breach = value > rule.RaiseLevel;
+                clear = value <= rule.ClearLevel;
+                break;
+
+            case ALERT_CONDITION_BELOW:
+                breach = value < rule.RaiseLevel;
+                clear = value >= rule.ClearLevel;
+                break;
+
+            case ALERT_CONDITION_NOT_EQUAL:
+                breach = value != rule.RaiseLevel;
+                clear = !breach;
+                break;
+
+            case ALERT_CONDITION_RISING:
+                breach = state.HasPrevious && value > state.Previous;
+                clear = !breach;
+                state.Previous = value;
+                state.HasPrevious = true;
+                break;
+
+            default:
+                break;
+        }
+
+        if( breach )
+        {
+            state.LastBreachMs = timeMs;
+
+            if( state.ConditionSinceMs < 0 )
+            {
+                state.ConditionSinceMs = timeMs;
+            }
+        }
+        else
+        {
+            state.ConditionSinceMs = -1;
+        }
+
+        bool changed = false;
+
+        if( !state.Active )
+        {
+            changed = breach && ( timeMs - state.ConditionSinceMs >= rule.MinDurationMs );
+        }
+        else
+        {
+            changed = clear && ( timeMs - state.LastBreachMs >= rule.HoldMs );
+        }
+
+        if( changed )
+        {
+            state.Active = !state.Active;
+
+            AlertEvent event;
+            event.Terminal = aTerminal;
+            event.Rule = i;
+            event.TimeMs = timeMs;
+            event.Value = value;
+            event.Raised = state.Active;
+            aEvents.push_back( event );
+        }
+    }
+}
+
+//!************************************************************************
+//! Get the state of a rule before any sample
+//!
+//! @returns: a cleared state
+//!************************************************************************
+AlertEngine::RuleState AlertEngine::initialState()
+{
+    RuleState state;
+    state.ConditionSinceMs = -1;
+    state.LastBreachMs = -1;
+    state.Previous = 0.0;
+    state.HasPrevious = false;
+    state.Active = false;
+    return state;
+}
+
+//!************************************************************************
+//! Check whether an alert is raised
+//!
+//! @returns: true if the rule is raised for the terminal
+//!************************************************************************
+bool AlertEngine::isActive
+    (
+    const size_t    aTerminal,  //!< terminal index
+    const size_t    aRule       //!< rule index
+    ) const
+{
+    return mStates[aTerminal * mRules.size() + aRule].Active;
+}
+
+//!************************************************************************
+//! Get a rule, as configured
+//!
+//! @returns: the rule
+//!************************************************************************
+const AlertRule& AlertEngine::rule
+    (
+    const size_t    aRule       //!< rule index
+    ) const
+{
+    return mRules[aRule];
+}
+
+//!************************************************************************
+//! Get the number of rules
+//!
+//! @returns: the number of rules
+//!************************************************************************
+size_t AlertEngine::ruleCount() const
+{
+    return mRules.size();
+}
+
+//!************************************************************************
+//! Get the number of terminals
+//!
+//! @returns: the number of terminals
+//!************************************************************************
+size_t AlertEngine::terminalCount() const
+{
+    return mTerminalCount;
+}
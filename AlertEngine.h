@@ -0,0 +1,152 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+AlertEngine.h
+
+This file contains the definitions for the threshold alerts.
+*/
+
+#ifndef AlertEngine_h
+#define AlertEngine_h
+
+#include <cstdint>
+#include <vector>
+
+#include <QString>
+
+#include "SurfBeam2Types.h"
+
+
+enum AlertCondition
+{
+    ALERT_CONDITION_ABOVE,          //!< raised above the threshold, cleared at or below threshold - hysteresis
+    ALERT_CONDITION_BELOW,          //!< raised below the threshold, cleared at or above threshold + hysteresis
+    ALERT_CONDITION_NOT_EQUAL,      //!< raised while different from the threshold, e.g. a modem state
+    ALERT_CONDITION_RISING,         //!< raised when the value increases, e.g. a counter
+
+    ALERT_CONDITION_COUNT           //!< number of defined conditions
+};
+
+//************************************************************************
+// Alert rule, as configured
+//************************************************************************
+typedef struct
+{
+    QString                     Name;           //!< text shown when the alert is raised
+    Metric                      Watched;        //!< metric the rule watches
+    AlertCondition              Condition;      //!< comparison of the metric to the threshold
+    double                      Threshold;      //!< level raising the alert
+    double                      Hysteresis;     //!< distance of the clearing level from the threshold
+    int64_t                     MinDurationMs;  //!< time the condition must hold before the alert is raised
+    int64_t                     HoldMs;         //!< time the alert stays raised after the condition last held
+}AlertRule;
+
+//************************************************************************
+// Change of the state of an alert
+//************************************************************************
+typedef struct
+{
+    size_t                      Terminal;       //!< terminal index
+    size_t                      Rule;           //!< rule index
+    int64_t                     TimeMs;         //!< time of the sample causing the change
+    double                      Value;          //!< value of the metric
+    bool                        Raised;         //!< true if raised, false if cleared
+}AlertEvent;
+
+//************************************************************************
+// Class for evaluating alert rules on the samples of many terminals. The
+// rules are compiled into one flat array of raise and clear levels, and
+// the state of each terminal is a contiguous block of the state array,
+// so that a sample is evaluated in a single pass without allocating.
+//************************************************************************
+class AlertEngine
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    private:
+        typedef struct
+        {
+            uint8_t                     Watched;        //!< metric index
+            uint8_t                     Condition;      //!< AlertCondition
+            double                      RaiseLevel;     //!< level raising the alert
+            double                      ClearLevel;     //!< level clearing the alert
+            int64_t                     MinDurationMs;  //!< time the condition must hold before raising
+            int64_t                     HoldMs;         //!< time the alert stays raised after the condition last held
+        }CompiledRule;
+
+        typedef struct
+        {
+            int64_t                     ConditionSinceMs;   //!< start of the current breach, -1 if none
+            int64_t                     LastBreachMs;       //!< last time the condition held
+            double                      Previous;           //!< previous value, for rising conditions
+            bool                        HasPrevious;        //!< true if Previous is set
+            bool                        Active;             //!< true if the alert is raised
+        }RuleState;
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        AlertEngine();
+
+        static std::vector<AlertRule> defaultRules();
+
+        size_t addRule
+            (
+            const AlertRule&            aRule       //!< rule to compile
+            );
+
+        size_t addTerminal();
+
+        void evaluate
+            (
+            const size_t                aTerminal,  //!< terminal index
+            const MetricSample&         aSample,    //!< decoded sample
+            std::vector<AlertEvent>&    aEvents     //!< appended changes of the alert states
+            );
+
+        bool isActive
+            (
+            const size_t                aTerminal,  //!< terminal index
+            const size_t                aRule       //!< rule index
+            ) const;
+
+        const AlertRule& rule
+            (
+            const size_t                aRule       //!< rule index
+            ) const;
+
+        size_t ruleCount() const;
+
+        size_t terminalCount() const;
+
+    private:
+        static RuleState initialState();
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        std::vector<AlertRule>          mRules;             //!< rules, as configured
+        std::vector<CompiledRule>       mCompiledRules;     //!< rules, as evaluated
+        std::vector<RuleState>          mStates;            //!< rule states, one block of ruleCount() per terminal
+        size_t                          mTerminalCount;     //!< number of terminals
+};
+
+#endif // AlertEngine_h
@@ -0,0 +1,318 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+BatchDecoder.cpp
+
+This file contains the sources for decoding many modem and TRIA replies at
+once into column arrays.
+*/
+
+#include "BatchDecoder.h"
+#include "CgiPayload.h"
+#include "FieldScanner.h"
+
+
+// modem fields decoded in bulk, in the order of the span columns
+static const int MODEM_COLUMN_INDEXES[] =
+{
+    MODEM_INDEX_TX_PACKETS,
+    MODEM_INDEX_TX_BYTES,
+    MODEM_INDEX_RX_PACKETS,
+    MODEM_INDEX_RX_BYTES,
+    MODEM_INDEX_ONLINE_TIME,
+    MODEM_INDEX_LOSS_OF_SYNC_COUNT,
+    MODEM_INDEX_RX_SNR_DB,
+    MODEM_INDEX_RX_SNR_PERCENT,
+    MODEM_INDEX_RX_PWR_DBM,
+    MODEM_INDEX_RX_PWR_PERCENT,
+    MODEM_INDEX_CABLE_RESISTANCE_OHM,
+    MODEM_INDEX_CABLE_RESISTANCE_PERCENT,
+    MODEM_INDEX_CABLE_ATTEN_DB,
+    MODEM_INDEX_CABLE_ATTEN_PERCENT,
+    MODEM_INDEX_MODEM_STATUS,
+    MODEM_INDEX_SATELLITE_STATUS,
+    MODEM_INDEX_UPLINK_SYMBOL_RATE,
+    MODEM_INDEX_DOWNLINK_SYMBOL_RATE
+};
+
+enum ModemColumn
+{
+    MODEM_COLUMN_TX_PACKETS,
+    MODEM_COLUMN_TX_BYTES,
+    MODEM_COLUMN_RX_PACKETS,
+    MODEM_COLUMN_RX_BYTES,
+    MODEM_COLUMN_ONLINE_TIME,
+    MODEM_COLUMN_LOSS_OF_SYNC_COUNT,
+    MODEM_COLUMN_RX_SNR_DB,
+    MODEM_COLUMN_RX_SNR_PERCENT,
+    MODEM_COLUMN_RX_PWR_DBM,
+    MODEM_COLUMN_RX_PWR_PERCENT,
+    MODEM_COLUMN_CABLE_RESISTANCE_OHM,
+    MODEM_COLUMN_CABLE_RESISTANCE_PERCENT,
+    MODEM_COLUMN_CABLE_ATTEN_DB,
+    MODEM_COLUMN_CABLE_ATTEN_PERCENT,
+    MODEM_COLUMN_MODEM_STATUS,
+    MODEM_COLUMN_SATELLITE_STATUS,
+    MODEM_COLUMN_UPLINK_SYMBOL_RATE,
+    MODEM_COLUMN_DOWNLINK_SYMBOL_RATE,
+
+    MODEM_COLUMN_COUNT
+};
+
+// TRIA fields decoded in bulk, in the order of the span columns
+static const int TRIA_COLUMN_INDEXES[] =
+{
+    TRIA_INDEX_TX_IF_PWR_DBM,
+    TRIA_INDEX_TEMPERATURE_C,
+    TRIA_INDEX_TX_RF_PWR_DBM,
+    TRIA_INDEX_TX_IF_PWR_PERCENT,
+    TRIA_INDEX_TX_RF_PWR_PERCENT,
+    TRIA_INDEX_SATELLITE_STATUS,
+    TRIA_INDEX_POLARIZATION_TYPE
+};
+
+enum TriaColumn
+{
+    TRIA_COLUMN_TX_IF_PWR_DBM,
+    TRIA_COLUMN_TEMPERATURE_C,
+    TRIA_COLUMN_TX_RF_PWR_DBM,
+    TRIA_COLUMN_TX_IF_PWR_PERCENT,
+    TRIA_COLUMN_TX_RF_PWR_PERCENT,
+    TRIA_COLUMN_SATELLITE_STATUS,
+    TRIA_COLUMN_POLARIZATION_TYPE,
+
+    TRIA_COLUMN_COUNT
+};
+
+static_assert( sizeof( MODEM_COLUMN_INDEXES ) / sizeof( MODEM_COLUMN_INDEXES[0] ) == MODEM_COLUMN_COUNT, "modem columns out of sync" );
+static_assert( sizeof( TRIA_COLUMN_INDEXES ) / sizeof( TRIA_COLUMN_INDEXES[0] ) == TRIA_COLUMN_COUNT, "TRIA columns out of sync" );
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+BatchDecoder::BatchDecoder()
+    : mSpanStride( 0 )
+    , mBeamColorClassifier( FieldClassifier::beamColor() )
+    , mModemStateClassifier( FieldClassifier::modemState() )
+    , mPolarizationClassifier( FieldClassifier::polarization() )
+{
+}
+
+//!************************************************************************
+//! Classify a text field of all replies
+//!
+//! @returns: nothing
+//!************************************************************************
+void BatchDecoder::classify
+    (
+    const QByteArray*       aPayloads,      //!< raw replies
+    const size_t            aCount,         //!< number of replies
+    const int               aColumn,        //!< position of the field in the wanted indexes
+    FieldClassifier&        aClassifier,    //!< classifier of the field
+    std::vector<uint8_t>&   aValues         //!< column, appended
+    )
+{
+    const size_t offset = aValues.size();
+    aValues.resize( offset + aCount );
+
+    for( size_t i = 0; i < aCount; i++ )
+    {
+        const Span& span = mSpans[i * mSpanStride + aColumn];
+        aValues[offset + i] = static_cast<uint8_t>( aClassifier.classify( aPayloads[i].constData() + span.Start, span.Length ) );
+    }
+}
+
+//!************************************************************************
+//! Split all replies and keep the spans of the wanted fields. Replies
+//! with an unexpected field count get empty spans, which decode as 0.
+//!
+//! @returns: nothing
+//!************************************************************************
+void BatchDecoder::collectSpans
+    (
+    const QByteArray*       aPayloads,      //!< raw replies
+    const size_t            aCount,         //!< number of replies
+    const int               aFieldCount,    //!< expected number of fields
+    const int*              aIndexes,       //!< wanted field indexes
+    const int               aIndexCount,    //!< number of wanted fields
+    std::vector<uint8_t>&   aValid          //!< validity column, appended
+    )
+{
+    const size_t offset = aValid.size();
+    aValid.resize( offset + aCount );
+
+    mSpanStride = aIndexCount;
+    mSpans.resize( aCount * aIndexCount );
+
+    for( size_t i = 0; i < aCount; i++ )
+    {
+        mFieldStart.clear();
+        mFieldStart.push_back( 0 );
+        FieldScanner::scan( aPayloads[i].constData(), aPayloads[i].size(), mFieldStart );
+        mFieldStart.push_back( aPayloads[i].size() + 2 );
+
+        // Important: the field count needs to be checked after each firmware update
+        const bool valid = ( aFieldCount == static_cast<int>( mFieldStart.size() ) - 1 );
+        aValid[offset + i] = valid ? 1 : 0;
+
+        Span* row = &mSpans[i * aIndexCount];
+
+        for( int j = 0; j < aIndexCount; j++ )
+        {
+            if( valid )
+            {
+                row[j].Start = mFieldStart[aIndexes[j]];
+                row[j].Length = mFieldStart[aIndexes[j] + 1] - mFieldStart[aIndexes[j]] - 2;
+            }
+            else
+            {
+                row[j].Start = 0;
+                row[j].Length = 0;
+            }
+        }
+    }
+}
+
+//!************************************************************************
+//! Convert a floating point field of all replies
+//!
+//! @returns: nothing
+//!************************************************************************
+template<typename T>
+void BatchDecoder::convertDouble
+    (
+    const QByteArray*   aPayloads,      //!< raw replies
+    const size_t        aCount,         //!< number of replies
+    const int           aColumn,        //!< position of the field in the wanted indexes
+    std::vector<T>&     aValues         //!< column, appended
+    )
+{
+    const size_t offset = aValues.size();
+    aValues.resize( offset + aCount );
+
+    for( size_t i = 0; i < aCount; i++ )
+    {
+        const Span& span = mSpans[i * mSpanStride + aColumn];
+        aValues[offset + i] = static_cast<T>( CgiPayload::parseDouble( aPayloads[i].constData() + span.Start, span.Length ) );
+    }
+}
+
+//!************************************************************************
+//! Convert a duration field of all replies
+//!
+//! @returns: nothing
+//!************************************************************************
+void BatchDecoder::convertDuration
+    (
+    const QByteArray*       aPayloads,      //!< raw replies
+    const size_t            aCount,         //!< number of replies
+    const int               aColumn,        //!< position of the field in the wanted indexes
+    std::vector<int64_t>&   aValues         //!< column, appended
+    )
+{
+    const size_t offset = aValues.size();
+    aValues.resize( offset + aCount );
+
+    for( size_t i = 0; i < aCount; i++ )
+    {
+        const Span& span = mSpans[i * mSpanStride + aColumn];
+        aValues[offset + i] = CgiPayload::parseDuration( aPayloads[i].constData() + span.Start, span.Length );
+    }
+}
+
+//!************************************************************************
+//! Convert an unsigned integer field of all replies
+//!
+//! @returns: nothing
+//!************************************************************************
+template<typename T>
+void BatchDecoder::convertUnsigned
+    (
+    const QByteArray*   aPayloads,      //!< raw replies
+    const size_t        aCount,         //!< number of replies
+    const int           aColumn,        //!< position of the field in the wanted indexes
+    std::vector<T>&     aValues         //!< column, appended
+    )
+{
+    const size_t offset = aValues.size();
+    aValues.resize( offset + aCount );
+
+    for( size_t i = 0; i < aCount; i++ )
+    {
+        const Span& span = mSpans[i * mSpanStride + aColumn];
+        aValues[offset + i] = static_cast<T>( CgiPayload::parseUnsigned( aPayloads[i].constData() + span.Start, span.Length ) );
+    }
+}
+
+//!************************************************************************
+//! Decode modem replies and append their numeric fields to the columns
+//!
+//! @returns: nothing
+//!************************************************************************
+void BatchDecoder::decodeModem
+    (
+    const QByteArray*   aPayloads,      //!< raw modem replies
+    const size_t        aCount,         //!< number of replies
+    ModemColumns&       aColumns        //!< columns the decoded replies are appended to
+    )
+{
+    collectSpans( aPayloads, aCount, FIELD_COUNT_MODEM, MODEM_COLUMN_INDEXES, MODEM_COLUMN_COUNT, aColumns.Valid );
+
+    convertUnsigned( aPayloads, aCount, MODEM_COLUMN_TX_PACKETS, aColumns.TxPackets );
+    convertUnsigned( aPayloads, aCount, MODEM_COLUMN_TX_BYTES, aColumns.TxBytes );
+    convertUnsigned( aPayloads, aCount, MODEM_COLUMN_RX_PACKETS, aColumns.RxPackets );
+    convertUnsigned( aPayloads, aCount, MODEM_COLUMN_RX_BYTES, aColumns.RxBytes );
+    convertDuration( aPayloads, aCount, MODEM_COLUMN_ONLINE_TIME, aColumns.OnlineTimeSeconds );
+    convertUnsigned( aPayloads, aCount, MODEM_COLUMN_LOSS_OF_SYNC_COUNT, aColumns.LossOfSyncCount );
+    convertDouble( aPayloads, aCount, MODEM_COLUMN_RX_SNR_DB, aColumns.RxSnrDb );
+    convertUnsigned( aPayloads, aCount, MODEM_COLUMN_RX_SNR_PERCENT, aColumns.RxSnrPercent );
+    convertDouble( aPayloads, aCount, MODEM_COLUMN_RX_PWR_DBM, aColumns.RxPwrDbm );
+    convertUnsigned( aPayloads, aCount, MODEM_COLUMN_RX_PWR_PERCENT, aColumns.RxPwrPercent );
+    convertDouble( aPayloads, aCount, MODEM_COLUMN_CABLE_RESISTANCE_OHM, aColumns.CableResistanceOhm );
+    convertUnsigned( aPayloads, aCount, MODEM_COLUMN_CABLE_RESISTANCE_PERCENT, aColumns.CableResistancePercent );
+    convertDouble( aPayloads, aCount, MODEM_COLUMN_CABLE_ATTEN_DB, aColumns.CableAttenuationDb );
+    convertUnsigned( aPayloads, aCount, MODEM_COLUMN_CABLE_ATTEN_PERCENT, aColumns.CableAttenuationPercent );
+    classify( aPayloads, aCount, MODEM_COLUMN_MODEM_STATUS, mModemStateClassifier, aColumns.ModemStatus );
+    classify( aPayloads, aCount, MODEM_COLUMN_SATELLITE_STATUS, mBeamColorClassifier, aColumns.SatStatusBeamColor );
+    convertUnsigned( aPayloads, aCount, MODEM_COLUMN_UPLINK_SYMBOL_RATE, aColumns.UplinkSymbolRate );
+    convertUnsigned( aPayloads, aCount, MODEM_COLUMN_DOWNLINK_SYMBOL_RATE, aColumns.DownlinkSymbolRate );
+}
+
+//!************************************************************************
+//! Decode TRIA replies and append their numeric fields to the columns
+//!
+//! @returns: nothing
+//!************************************************************************
+void BatchDecoder::decodeTria
+    (
+    const QByteArray*   aPayloads,      //!< raw TRIA replies
+    const size_t        aCount,         //!< number of replies
+    TriaColumns&        aColumns        //!< columns the decoded replies are appended to
+    )
+{
+    collectSpans( aPayloads, aCount, FIELD_COUNT_TRIA, TRIA_COLUMN_INDEXES, TRIA_COLUMN_COUNT, aColumns.Valid );
+
+    convertDouble( aPayloads, aCount, TRIA_COLUMN_TX_IF_PWR_DBM, aColumns.TxIfPwrDbm );
+    convertDouble( aPayloads, aCount, TRIA_COLUMN_TEMPERATURE_C, aColumns.TemperatureCelsius );
+    convertDouble( aPayloads, aCount, TRIA_COLUMN_TX_RF_PWR_DBM, aColumns.TxRfPwrDbm );
+    convertUnsigned( aPayloads, aCount, TRIA_COLUMN_TX_IF_PWR_PERCENT, aColumns.TxIfPwrPercent );
+    convertUnsigned( aPayloads, aCount, TRIA_COLUMN_TX_RF_PWR_PERCENT, aColumns.TxRfPwrPercent );
+    classify( aPayloads, aCount, TRIA_COLUMN_SATELLITE_STATUS, mBeamColorClassifier, aColumns.SatStatusBeamColor );
+    classify( aPayloads, aCount, TRIA_COLUMN_POLARIZATION_TYPE, mPolarizationClassifier, aColumns.Polarization );
+}
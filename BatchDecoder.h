@@ -0,0 +1,178 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+BatchDecoder.h
+
+This file contains the definitions for decoding many modem and TRIA
+replies at once into column arrays.
+*/
+
+#ifndef BatchDecoder_h
+#define BatchDecoder_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <QByteArray>
+
+#include "FieldClassifier.h"
+#include "SurfBeam2Types.h"
+
+
+//************************************************************************
+// Numeric modem fields of many replies, one array per field. Element i of
+// every array belongs to the same reply.
+//************************************************************************
+typedef struct
+{
+    std::vector<uint8_t>        Valid;                      //!< 1 if the reply had the expected field count
+    std::vector<uint64_t>       TxPackets;
+    std::vector<uint64_t>       TxBytes;
+    std::vector<uint64_t>       RxPackets;
+    std::vector<uint64_t>       RxBytes;
+    std::vector<int64_t>        OnlineTimeSeconds;          //!< -1 if not a duration
+    std::vector<uint32_t>       LossOfSyncCount;
+    std::vector<double>         RxSnrDb;
+    std::vector<uint8_t>        RxSnrPercent;
+    std::vector<double>         RxPwrDbm;
+    std::vector<uint8_t>        RxPwrPercent;
+    std::vector<double>         CableResistanceOhm;
+    std::vector<uint8_t>        CableResistancePercent;
+    std::vector<double>         CableAttenuationDb;
+    std::vector<uint8_t>        CableAttenuationPercent;
+    std::vector<uint8_t>        ModemStatus;                //!< ModemState values
+    std::vector<uint8_t>        SatStatusBeamColor;         //!< SatelliteStatusBeamColor values
+    std::vector<uint32_t>       UplinkSymbolRate;
+    std::vector<uint32_t>       DownlinkSymbolRate;
+}ModemColumns;
+
+//************************************************************************
+// Numeric TRIA fields of many replies, one array per field
+//************************************************************************
+typedef struct
+{
+    std::vector<uint8_t>        Valid;                      //!< 1 if the reply had the expected field count
+    std::vector<double>         TxIfPwrDbm;
+    std::vector<double>         TemperatureCelsius;
+    std::vector<double>         TxRfPwrDbm;
+    std::vector<uint8_t>        TxIfPwrPercent;
+    std::vector<uint8_t>        TxRfPwrPercent;
+    std::vector<uint8_t>        SatStatusBeamColor;         //!< SatelliteStatusBeamColor values
+    std::vector<uint8_t>        Polarization;               //!< AntennaPolarization values
+}TriaColumns;
+
+//************************************************************************
+// Class for decoding replies in bulk, e.g. when replaying captures. All
+// replies are split first, keeping only the spans of the numeric fields,
+// and then each field is converted for all replies in one tight loop,
+// instead of walking the whole schema once per reply.
+//************************************************************************
+class BatchDecoder
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    private:
+        typedef struct
+        {
+            int                         Start;      //!< offset of the field in the reply
+            int                         Length;     //!< field length
+        }Span;
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        BatchDecoder();
+
+        void decodeModem
+            (
+            const QByteArray*   aPayloads,      //!< raw modem replies
+            const size_t        aCount,         //!< number of replies
+            ModemColumns&       aColumns        //!< columns the decoded replies are appended to
+            );
+
+        void decodeTria
+            (
+            const QByteArray*   aPayloads,      //!< raw TRIA replies
+            const size_t        aCount,         //!< number of replies
+            TriaColumns&        aColumns        //!< columns the decoded replies are appended to
+            );
+
+    private:
+        void collectSpans
+            (
+            const QByteArray*   aPayloads,      //!< raw replies
+            const size_t        aCount,         //!< number of replies
+            const int           aFieldCount,    //!< expected number of fields
+            const int*          aIndexes,       //!< wanted field indexes
+            const int           aIndexCount,    //!< number of wanted fields
+            std::vector<uint8_t>& aValid        //!< validity column, appended
+            );
+
+        template<typename T>
+        void convertDouble
+            (
+            const QByteArray*   aPayloads,      //!< raw replies
+            const size_t        aCount,         //!< number of replies
+            const int           aColumn,        //!< position of the field in the wanted indexes
+            std::vector<T>&     aValues         //!< column, appended
+            );
+
+        void convertDuration
+            (
+            const QByteArray*   aPayloads,      //!< raw replies
+            const size_t        aCount,         //!< number of replies
+            const int           aColumn,        //!< position of the field in the wanted indexes
+            std::vector<int64_t>& aValues       //!< column, appended
+            );
+
+        template<typename T>
+        void convertUnsigned
+            (
+            const QByteArray*   aPayloads,      //!< raw replies
+            const size_t        aCount,         //!< number of replies
+            const int           aColumn,        //!< position of the field in the wanted indexes
+            std::vector<T>&     aValues         //!< column, appended
+            );
+
+        void classify
+            (
+            const QByteArray*   aPayloads,      //!< raw replies
+            const size_t        aCount,         //!< number of replies
+            const int           aColumn,        //!< position of the field in the wanted indexes
+            FieldClassifier&    aClassifier,    //!< classifier of the field
+            std::vector<uint8_t>& aValues       //!< column, appended
+            );
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        std::vector<int>        mFieldStart;            //!< field offsets of the reply being split
+        std::vector<Span>       mSpans;                 //!< wanted field spans, one row of columns per reply
+
+        int                     mSpanStride;            //!< number of wanted fields per reply
+
+        FieldClassifier         mBeamColorClassifier;   //!< classifier of the satellite status beam color
+        FieldClassifier         mModemStateClassifier;  //!< classifier of the modem state
+        FieldClassifier         mPolarizationClassifier;//!< classifier of the antenna polarization
+};
+
+#endif // BatchDecoder_h
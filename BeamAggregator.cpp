@@ -0,0 +1,243 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+BeamAggregator.cpp
+
+This file contains the sources for the live aggregates of the
+terminals sharing a satellite beam.
+*/
+
+#include "BeamAggregator.h"
+
+#include <math.h>
+#include <string.h>
+
+
+const StringInterner::Id BeamAggregator::NO_BDT;
+constexpr double BeamAggregator::SCALE;
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+BeamAggregator::BeamAggregator()
+{
+    memset( mBeams, 0, sizeof( mBeams ) );
+}
+
+//!************************************************************************
+//! Add a terminal, counted in the unknown beam color until it reports
+//!
+//! @returns: the terminal index
+//!************************************************************************
+size_t BeamAggregator::addTerminal()
+{
+    Contribution contribution;
+    contribution.BeamColor = SATELLITE_STATUS_BEAM_COLOR_UNKNOWN;
+    contribution.Bdt = NO_BDT;
+    contribution.Online = false;
+    contribution.HasSnr = false;
+    contribution.Snr = 0;
+    contribution.HasRxPwr = false;
+    contribution.RxPwr = 0;
+
+    mTerminals.push_back( contribution );
+    apply( contribution, 1 );
+
+    return mTerminals.size() - 1;
+}
+
+//!************************************************************************
+//! Add or take out a contribution from the groups of a terminal
+//!
+//! @returns: nothing
+//!************************************************************************
+void BeamAggregator::apply
+    (
+    const Contribution&             aContribution,  //!< contribution of a terminal
+    const int                       aSign           //!< 1 to add it, -1 to take it out
+    )
+{
+    applyTo( mBeams[aContribution.BeamColor], aContribution, aSign );
+
+    if( NO_BDT != aContribution.Bdt )
+    {
+        if( aContribution.Bdt >= mBdts.size() )
+        {
+            BeamSums empty;
+            memset( &empty, 0, sizeof( empty ) );
+
+            mBdts.resize( aContribution.Bdt + 1, empty );
+        }
+
+        applyTo( mBdts[aContribution.Bdt], aContribution, aSign );
+    }
+}
+
+//!************************************************************************
+//! Add or take out a contribution from the sums of a group
+//!
+//! @returns: nothing
+//!************************************************************************
+/* static */ void BeamAggregator::applyTo
+    (
+    BeamSums&                       aSums,          //!< sums of a group
+    const Contribution&             aContribution,  //!< contribution of a terminal
+    const int                       aSign           //!< 1 to add it, -1 to take it out
+    )
+{
+    aSums.TerminalCount += aSign;
+    aSums.OnlineCount += aContribution.Online ? aSign : 0;
+
+    if( aContribution.HasSnr )
+    {
+        aSums.SnrCount += aSign;
+        aSums.SnrSum += aSign * aContribution.Snr;
+    }
+
+    if( aContribution.HasRxPwr )
+    {
+        aSums.RxPwrCount += aSign;
+        aSums.RxPwrSum += aSign * aContribution.RxPwr;
+    }
+}
+
+//!************************************************************************
+//! Get the sums of the terminals with a BDT version
+//!
+//! @returns: the sums, empty if no terminal reported the version
+//!************************************************************************
+BeamSums BeamAggregator::bdtSums
+    (
+    const StringInterner::Id        aBdt        //!< interned BDT version
+    ) const
+{
+    if( aBdt < mBdts.size() )
+    {
+        return mBdts[aBdt];
+    }
+
+    BeamSums empty;
+    memset( &empty, 0, sizeof( empty ) );
+    return empty;
+}
+
+//!************************************************************************
+//! Get the sums of the terminals on a beam color
+//!
+//! @returns: the sums
+//!************************************************************************
+BeamSums BeamAggregator::beamSums
+    (
+    const SatelliteStatusBeamColor  aBeamColor  //!< beam color
+    ) const
+{
+    return mBeams[aBeamColor];
+}
+
+//!************************************************************************
+//! Get the mean Rx power of a group
+//!
+//! @returns: the mean Rx power [dBm], NaN if no terminal reported one
+//!************************************************************************
+/* static */ double BeamAggregator::meanRxPwr
+    (
+    const BeamSums&                 aSums       //!< sums of a group
+    )
+{
+    return aSums.RxPwrCount > 0 ? aSums.RxPwrSum / SCALE / aSums.RxPwrCount : NAN;
+}
+
+//!************************************************************************
+//! Get the mean Rx SNR of a group
+//!
+//! @returns: the mean Rx SNR [dB], NaN if no terminal reported one
+//!************************************************************************
+/* static */ double BeamAggregator::meanSnr
+    (
+    const BeamSums&                 aSums       //!< sums of a group
+    )
+{
+    return aSums.SnrCount > 0 ? aSums.SnrSum / SCALE / aSums.SnrCount : NAN;
+}
+
+//!************************************************************************
+//! Get the share of a group that is online
+//!
+//! @returns: the online ratio, 0..1, NaN for an empty group
+//!************************************************************************
+/* static */ double BeamAggregator::onlineRatio
+    (
+    const BeamSums&                 aSums       //!< sums of a group
+    )
+{
+    return aSums.TerminalCount > 0 ? static_cast<double>( aSums.OnlineCount ) / aSums.TerminalCount : NAN;
+}
+
+//!************************************************************************
+//! Compare the Rx SNR of a terminal with the other terminals of its beam
+//!
+//! @returns: the SNR of the terminal minus the mean of the others [dB],
+//!           NaN if either is unknown
+//!************************************************************************
+double BeamAggregator::snrOffset
+    (
+    const size_t                    aTerminal   //!< terminal index
+    ) const
+{
+    const Contribution& contribution = mTerminals[aTerminal];
+    const BeamSums& beam = mBeams[contribution.BeamColor];
+
+    if( !contribution.HasSnr || beam.SnrCount < 2 )
+    {
+        return NAN;
+    }
+
+    const double othersMean = ( beam.SnrSum - contribution.Snr ) / SCALE / ( beam.SnrCount - 1 );
+    return contribution.Snr / SCALE - othersMean;
+}
+
+//!************************************************************************
+//! Replace the contribution of a terminal with its latest state
+//!
+//! @returns: nothing
+//!************************************************************************
+void BeamAggregator::update
+    (
+    const size_t                    aTerminal,  //!< terminal index
+    const SatelliteStatusBeamColor  aBeamColor, //!< beam color
+    const StringInterner::Id        aBdt,       //!< interned BDT version, NO_BDT if none
+    const ModemState                aState,     //!< modem state
+    const double                    aRxSnrDb,   //!< Rx SNR [dB], NaN if unknown
+    const double                    aRxPwrDbm   //!< Rx power [dBm], NaN if unknown
+    )
+{
+    Contribution& contribution = mTerminals[aTerminal];
+
+    apply( contribution, -1 );
+
+    contribution.BeamColor = aBeamColor;
+    contribution.Bdt = aBdt;
+    contribution.Online = MODEM_STATE_ONLINE == aState;
+    contribution.HasSnr = !isnan( aRxSnrDb );
+    contribution.Snr = contribution.HasSnr ? llround( aRxSnrDb * SCALE ) : 0;
+    contribution.HasRxPwr = !isnan( aRxPwrDbm );
+    contribution.RxPwr = contribution.HasRxPwr ? llround( aRxPwrDbm * SCALE ) : 0;
+
+    apply( contribution, 1 );
+}
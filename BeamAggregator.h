@@ -0,0 +1,153 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+BeamAggregator.h
+
+This file contains the definitions for the live aggregates of the
+terminals sharing a satellite beam.
+*/
+
+#ifndef BeamAggregator_h
+#define BeamAggregator_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "StringInterner.h"
+#include "SurfBeam2Types.h"
+
+
+//************************************************************************
+// Running sums of a group of terminals. The levels are summed in
+// hundredths of a dB, so that terminals can be added and removed any
+// number of times without the sums drifting.
+//************************************************************************
+typedef struct
+{
+    uint32_t                    TerminalCount;  //!< terminals in the group
+    uint32_t                    OnlineCount;    //!< terminals online
+    uint32_t                    SnrCount;       //!< terminals with an Rx SNR
+    int64_t                     SnrSum;         //!< sum of the Rx SNRs [0.01 dB]
+    uint32_t                    RxPwrCount;     //!< terminals with an Rx power
+    int64_t                     RxPwrSum;       //!< sum of the Rx powers [0.01 dBm]
+}BeamSums;
+
+//************************************************************************
+// Class for aggregating the Rx SNR, the Rx power and the online ratio of
+// the fleet per beam color and per beam data table (BDT) version. Each
+// terminal's last contribution is kept, so that an update takes it out
+// of its groups and adds the new one in constant time. A drop of one
+// terminal against the rest of its beam points at the site; a drop of
+// the beam mean points at the beam. The BDT sums are indexed by ID, so
+// the IDs must come from an interner holding the BDT versions only.
+//************************************************************************
+class BeamAggregator
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        static const StringInterner::Id NO_BDT = UINT32_MAX;   //!< BDT version of a terminal not reporting one
+
+    private:
+        static constexpr double SCALE = 100.0;      //!< sum units per dB
+
+        typedef struct
+        {
+            SatelliteStatusBeamColor    BeamColor;  //!< beam color
+            StringInterner::Id          Bdt;        //!< interned BDT version, NO_BDT if none
+            bool                        Online;     //!< true if online
+            bool                        HasSnr;     //!< true if the Rx SNR is known
+            int64_t                     Snr;        //!< Rx SNR [0.01 dB]
+            bool                        HasRxPwr;   //!< true if the Rx power is known
+            int64_t                     RxPwr;      //!< Rx power [0.01 dBm]
+        }Contribution;
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        BeamAggregator();
+
+        size_t addTerminal();
+
+        BeamSums bdtSums
+            (
+            const StringInterner::Id        aBdt        //!< interned BDT version
+            ) const;
+
+        BeamSums beamSums
+            (
+            const SatelliteStatusBeamColor  aBeamColor  //!< beam color
+            ) const;
+
+        static double meanRxPwr
+            (
+            const BeamSums&                 aSums       //!< sums of a group
+            );
+
+        static double meanSnr
+            (
+            const BeamSums&                 aSums       //!< sums of a group
+            );
+
+        static double onlineRatio
+            (
+            const BeamSums&                 aSums       //!< sums of a group
+            );
+
+        double snrOffset
+            (
+            const size_t                    aTerminal   //!< terminal index
+            ) const;
+
+        void update
+            (
+            const size_t                    aTerminal,  //!< terminal index
+            const SatelliteStatusBeamColor  aBeamColor, //!< beam color
+            const StringInterner::Id        aBdt,       //!< interned BDT version, NO_BDT if none
+            const ModemState                aState,     //!< modem state
+            const double                    aRxSnrDb,   //!< Rx SNR [dB], NaN if unknown
+            const double                    aRxPwrDbm   //!< Rx power [dBm], NaN if unknown
+            );
+
+    private:
+        void apply
+            (
+            const Contribution&             aContribution,  //!< contribution of a terminal
+            const int                       aSign           //!< 1 to add it, -1 to take it out
+            );
+
+        static void applyTo
+            (
+            BeamSums&                       aSums,          //!< sums of a group
+            const Contribution&             aContribution,  //!< contribution of a terminal
+            const int                       aSign           //!< 1 to add it, -1 to take it out
+            );
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        BeamSums                    mBeams[SATELLITE_STATUS_BEAM_COLOR_COUNT];  //!< sums per beam color
+        std::vector<BeamSums>       mBdts;                                      //!< sums per interned BDT version, sized by the largest ID
+        std::vector<Contribution>   mTerminals;                                 //!< last contribution of each terminal
+};
+
+#endif // BeamAggregator_h
@@ -0,0 +1,194 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+CalibrationProfiles.cpp
+
+This file contains the sources for the calibration profiles of the
+percent mappings.
+*/
+
+#include "CalibrationProfiles.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QSettings>
+
+
+//************************************************************************
+// INI key of each mapping
+//************************************************************************
+static const char* const MAPPING_KEYS[PercentCalibration::MAPPING_COUNT] =
+{
+    "RxSnr",                // MAPPING_RX_SNR
+    "RxPwr",                // MAPPING_RX_PWR
+    "TxIfPwr",              // MAPPING_TX_IF_PWR
+    "TxRfPwr",              // MAPPING_TX_RF_PWR
+    "CableAttenuation"      // MAPPING_CABLE_ATTENUATION
+};
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+CalibrationProfiles::CalibrationProfiles()
+    : mSelectedFits( nullptr )
+    , mSelectionValid( false )
+{
+}
+
+//!************************************************************************
+//! Load the profiles of an INI file, replacing the profiles loaded before.
+//! Malformed fits are reported and replaced by the stock fit.
+//!
+//! @returns: true if the file exists
+//!************************************************************************
+bool CalibrationProfiles::load
+    (
+    const QString&  aPath       //!< INI file
+    )
+{
+    mProfiles.clear();
+    mSelectionValid = false;
+
+    if( !QFile::exists( aPath ) )
+    {
+        return false;
+    }
+
+    QSettings settings( aPath, QSettings::IniFormat );
+    const QStringList groups = settings.childGroups();
+
+    for( int i = 0; i < groups.size(); i++ )
+    {
+        CalibrationProfile profile;
+        profile.Name = groups[i];
+
+        settings.beginGroup( profile.Name );
+        profile.IflTypes = settings.value( "IflTypes" ).toStringList();
+        profile.PartNumbers = settings.value( "PartNumbers" ).toStringList();
+
+        for( int mapping = 0; mapping < PercentCalibration::MAPPING_COUNT; mapping++ )
+        {
+            profile.Fits[mapping] = PercentCalibration::defaultFit( static_cast<PercentCalibration::Mapping>( mapping ) );
+            const QVariant value = settings.value( MAPPING_KEYS[mapping] );
+
+            if( value.isValid() && !parseFit( value.toStringList(), profile.Fits[mapping] ) )
+            {
+                qWarning() << "Calibration profile" << profile.Name << "has a malformed" << MAPPING_KEYS[mapping] << "fit";
+            }
+        }
+
+        settings.endGroup();
+        mProfiles.push_back( profile );
+    }
+
+    return true;
+}
+
+//!************************************************************************
+//! Parse a fit given as threshold, offset and slope
+//!
+//! @returns: true if the fit is well formed, else the fit is left unchanged
+//!************************************************************************
+bool CalibrationProfiles::parseFit
+    (
+    const QStringList&  aValues,    //!< threshold, offset and slope
+    LinearFit&          aFit        //!< parsed fit
+    )
+{
+    const int VALUE_COUNT = 3;
+
+    if( VALUE_COUNT != aValues.size() )
+    {
+        return false;
+    }
+
+    bool thresholdOk = false;
+    bool offsetOk = false;
+    bool slopeOk = false;
+
+    LinearFit fit;
+    fit.Threshold = aValues[0].trimmed().toDouble( &thresholdOk );
+    fit.Offset = aValues[1].trimmed().toDouble( &offsetOk );
+    fit.Slope = aValues[2].trimmed().toDouble( &slopeOk );
+
+    if( !thresholdOk || !offsetOk || !slopeOk )
+    {
+        return false;
+    }
+
+    aFit = fit;
+    return true;
+}
+
+//!************************************************************************
+//! Select the profile of a terminal. A part number match takes precedence
+//! over an IFL type match; among equal matches the first profile wins.
+//!
+//! @returns: the fits of the matching profile, indexed by mapping, or
+//!           nullptr if no profile matches
+//!************************************************************************
+const LinearFit* CalibrationProfiles::select
+    (
+    const QString&  aIflType,   //!< IFL type of the terminal
+    const QString&  aPartNr     //!< modem part number of the terminal
+    )
+{
+    if( mSelectionValid
+     && aIflType == mSelectedIflType
+     && aPartNr == mSelectedPartNr )
+    {
+        return mSelectedFits;
+    }
+
+    const CalibrationProfile* partNrMatch = nullptr;
+    const CalibrationProfile* iflTypeMatch = nullptr;
+
+    for( size_t i = 0; i < mProfiles.size() && !partNrMatch; i++ )
+    {
+        const CalibrationProfile& profile = mProfiles[i];
+
+        if( !aPartNr.isEmpty() && profile.PartNumbers.contains( aPartNr ) )
+        {
+            partNrMatch = &profile;
+        }
+        else if( !iflTypeMatch && !aIflType.isEmpty() && profile.IflTypes.contains( aIflType ) )
+        {
+            iflTypeMatch = &profile;
+        }
+    }
+
+    const CalibrationProfile* match = partNrMatch ? partNrMatch : iflTypeMatch;
+
+    mSelectedIflType = aIflType;
+    mSelectedPartNr = aPartNr;
+    mSelectedFits = match ? match->Fits : nullptr;
+    mSelectionValid = true;
+
+    return mSelectedFits;
+}
+
+//!************************************************************************
+//! Get the number of loaded profiles
+//!
+//! @returns: the number of profiles
+//!************************************************************************
+size_t CalibrationProfiles::size() const
+{
+    return mProfiles.size();
+}
@@ -0,0 +1,103 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+CalibrationProfiles.h
+
+This file contains the definitions for the calibration profiles of the
+percent mappings.
+
+The profiles are read from an INI file, one group per profile:
+
+    [LongCable]
+    IflTypes=RG6 150ft
+    PartNumbers=1234567-001, 1234567-002
+    RxPwr=-75.0, 121.0, 1.6
+    CableAttenuation=0.0, 0.0, 5.0
+
+Each mapping is given as threshold, offset, slope; the mappings left out
+keep the stock fit.
+*/
+
+#ifndef CalibrationProfiles_h
+#define CalibrationProfiles_h
+
+#include <vector>
+
+#include <QString>
+#include <QStringList>
+
+#include "PercentCalibration.h"
+
+
+//************************************************************************
+// Named set of fits, with the terminals it applies to
+//************************************************************************
+typedef struct
+{
+    QString                     Name;                                           //!< INI group of the profile
+    QStringList                 IflTypes;                                       //!< IFL types the profile applies to
+    QStringList                 PartNumbers;                                    //!< modem part numbers the profile applies to
+    LinearFit                   Fits[PercentCalibration::MAPPING_COUNT];        //!< fit of each mapping
+}CalibrationProfile;
+
+//************************************************************************
+// Class for selecting the calibration of a terminal. The profiles are
+// loaded once, and the selection is only repeated when the IFL type or
+// the part number of the terminal changes.
+//************************************************************************
+class CalibrationProfiles
+{
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        CalibrationProfiles();
+
+        bool load
+            (
+            const QString&  aPath       //!< INI file
+            );
+
+        const LinearFit* select
+            (
+            const QString&  aIflType,   //!< IFL type of the terminal
+            const QString&  aPartNr     //!< modem part number of the terminal
+            );
+
+        size_t size() const;
+
+    private:
+        static bool parseFit
+            (
+            const QStringList&  aValues,    //!< threshold, offset and slope
+            LinearFit&          aFit        //!< parsed fit
+            );
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        std::vector<CalibrationProfile>     mProfiles;          //!< loaded profiles
+
+        QString                             mSelectedIflType;   //!< IFL type of the last selection
+        QString                             mSelectedPartNr;    //!< part number of the last selection
+        const LinearFit*                    mSelectedFits;      //!< fits of the last selection, nullptr if none matched
+        bool                                mSelectionValid;    //!< true if the last selection can be reused
+};
+
+#endif // CalibrationProfiles_h
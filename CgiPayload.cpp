@@ -0,0 +1,429 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+CgiPayload.cpp
+
+This file contains the sources for the CGI payload field splitter.
+*/
+
+#include "CgiPayload.h"
+#include "FieldScanner.h"
+
+
+const char CgiPayload::FIELD_DELIMITER[] = "##";
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+CgiPayload::CgiPayload()
+{
+    clear();
+}
+
+//!************************************************************************
+//! Remove all fields
+//!
+//! @returns: nothing
+//!************************************************************************
+void CgiPayload::clear()
+{
+    mBytes.clear();
+    mFieldStart.clear();
+}
+
+//!************************************************************************
+//! Get the first byte of a field
+//!
+//! @returns: pointer to the field data (not null terminated)
+//!************************************************************************
+const char* CgiPayload::fieldData
+    (
+    const int aIndex    //!< field index
+    ) const
+{
+    return mBytes.constData() + mFieldStart.at( aIndex );
+}
+
+//!************************************************************************
+//! Get the length of a field
+//!
+//! @returns: the number of bytes in the field
+//!************************************************************************
+int CgiPayload::fieldLength
+    (
+    const int aIndex    //!< field index
+    ) const
+{
+    return mFieldStart.at( aIndex + 1 ) - mFieldStart.at( aIndex ) - 2;
+}
+
+//!************************************************************************
+//! Parse a decimal number, with optional sign, fraction and exponent.
+//! Unlike strtod() this does not depend on the C locale, which
+//! QApplication sets from the environment.
+//!
+//! @returns: the parsed value, or 0 if the field is not a number
+//!************************************************************************
+double CgiPayload::parseDouble
+    (
+    const char* aData,      //!< field data
+    const int   aLength     //!< field length
+    )
+{
+    static const double POWERS_OF_TEN[] =
+    {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+        1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+        1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const int MAX_POWER = sizeof( POWERS_OF_TEN ) / sizeof( POWERS_OF_TEN[0] ) - 1;
+    const uint64_t MAX_MANTISSA = 1000000000000000000ULL;
+
+    int begin = 0;
+    int end = aLength;
+
+    while( begin < end && ' ' == aData[begin] )
+    {
+        begin++;
+    }
+
+    while( end > begin && ' ' == aData[end - 1] )
+    {
+        end--;
+    }
+
+    bool negative = false;
+
+    if( begin < end && ( '-' == aData[begin] || '+' == aData[begin] ) )
+    {
+        negative = ( '-' == aData[begin] );
+        begin++;
+    }
+
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    int digits = 0;
+    bool fraction = false;
+
+    for( ; begin < end; begin++ )
+    {
+        const char c = aData[begin];
+
+        if( c >= '0' && c <= '9' )
+        {
+            digits++;
+
+            if( mantissa < MAX_MANTISSA )
+            {
+                mantissa = 10 * mantissa + static_cast<uint64_t>( c - '0' );
+                exponent -= fraction ? 1 : 0;
+            }
+            else
+            {
+                exponent += fraction ? 0 : 1;
+            }
+        }
+        else if( '.' == c && !fraction )
+        {
+            fraction = true;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if( 0 == digits )
+    {
+        return 0.0;
+    }
+
+    if( begin < end && ( 'e' == aData[begin] || 'E' == aData[begin] ) )
+    {
+        begin++;
+        bool negativeExponent = false;
+
+        if( begin < end && ( '-' == aData[begin] || '+' == aData[begin] ) )
+        {
+            negativeExponent = ( '-' == aData[begin] );
+            begin++;
+        }
+
+        int value = 0;
+        int exponentDigits = 0;
+
+        for( ; begin < end && aData[begin] >= '0' && aData[begin] <= '9'; begin++ )
+        {
+            if( value < 10000 )
+            {
+                value = 10 * value + ( aData[begin] - '0' );
+            }
+
+            exponentDigits++;
+        }
+
+        if( 0 == exponentDigits )
+        {
+            return 0.0;
+        }
+
+        exponent += negativeExponent ? -value : value;
+    }
+
+    if( begin != end )
+    {
+        return 0.0;
+    }
+
+    double result = static_cast<double>( mantissa );
+
+    while( exponent > 0 )
+    {
+        const int step = exponent > MAX_POWER ? MAX_POWER : exponent;
+        result *= POWERS_OF_TEN[step];
+        exponent -= step;
+    }
+
+    while( exponent < 0 )
+    {
+        const int step = -exponent > MAX_POWER ? MAX_POWER : -exponent;
+        result /= POWERS_OF_TEN[step];
+        exponent += step;
+    }
+
+    return negative ? -result : result;
+}
+
+//!************************************************************************
+//! Parse a duration, e.g. the online time. The numbers are read from the
+//! right: a number followed by a unit letter (d, h, m, s) is taken in
+//! that unit, and a bare number in the unit after the one to its right,
+//! so "12.03:04:05", "3:04:05", "1 day 02:03:04" and "2h 5m" all parse.
+//!
+//! @returns: the duration in seconds, or -1 if the field is not a duration
+//!           or does not fit in 64 bits
+//!************************************************************************
+int64_t CgiPayload::parseDuration
+    (
+    const char* aData,      //!< field data
+    const int   aLength     //!< field length
+    )
+{
+    const int MAX_GROUPS = 4;
+    const int64_t UNIT_SECONDS[MAX_GROUPS] = { 1, 60, 3600, 86400 };    // s, m, h, d
+
+    int64_t values[MAX_GROUPS];
+    int units[MAX_GROUPS];
+    int count = 0;
+    int i = 0;
+
+    while( i < aLength )
+    {
+        if( aData[i] < '0' || aData[i] > '9' )
+        {
+            i++;
+            continue;
+        }
+
+        if( MAX_GROUPS == count )
+        {
+            return -1;
+        }
+
+        int64_t value = 0;
+
+        while( i < aLength && aData[i] >= '0' && aData[i] <= '9' )
+        {
+            const int digit = aData[i] - '0';
+
+            if( value > ( INT64_MAX - digit ) / 10 )
+            {
+                return -1;
+            }
+
+            value = 10 * value + digit;
+            i++;
+        }
+
+        while( i < aLength && ' ' == aData[i] )
+        {
+            i++;
+        }
+
+        int unit = -1;
+
+        if( i < aLength )
+        {
+            switch( aData[i] | 0x20 )
+            {
+                case 's': unit = 0; break;
+                case 'm': unit = 1; break;
+                case 'h': unit = 2; break;
+                case 'd': unit = 3; break;
+                default: break;
+            }
+        }
+
+        values[count] = value;
+        units[count] = unit;
+        count++;
+    }
+
+    if( 0 == count )
+    {
+        return -1;
+    }
+
+    int64_t seconds = 0;
+    int nextUnit = 0;
+
+    for( int group = count - 1; group >= 0; group-- )
+    {
+        const int unit = units[group] >= 0 ? units[group] : nextUnit;
+
+        if( unit >= MAX_GROUPS || values[group] > ( INT64_MAX - seconds ) / UNIT_SECONDS[unit] )
+        {
+            return -1;
+        }
+
+        seconds += values[group] * UNIT_SECONDS[unit];
+        nextUnit = unit + 1;
+    }
+
+    return seconds;
+}
+
+//!************************************************************************
+//! Parse an unsigned decimal number. Thousands separators (',') and
+//! percent signs are skipped, as the modem reports counters like
+//! "1,234,567" and ratios like "87%".
+//!
+//! @returns: the parsed value, or 0 if the field is not a number
+//!************************************************************************
+uint64_t CgiPayload::parseUnsigned
+    (
+    const char* aData,      //!< field data
+    const int   aLength     //!< field length
+    )
+{
+    uint64_t value = 0;
+    int digits = 0;
+
+    for( int i = 0; i < aLength; i++ )
+    {
+        const char c = aData[i];
+
+        if( c >= '0' && c <= '9' )
+        {
+            value = 10 * value + static_cast<uint64_t>( c - '0' );
+            digits++;
+        }
+        else if( ',' != c && '%' != c && ' ' != c )
+        {
+            return 0;
+        }
+    }
+
+    return digits ? value : 0;
+}
+
+//!************************************************************************
+//! Get the number of fields
+//!
+//! @returns: the field count of the last split reply
+//!************************************************************************
+int CgiPayload::size() const
+{
+    return mFieldStart.empty() ? 0 : static_cast<int>( mFieldStart.size() ) - 1;
+}
+
+//!************************************************************************
+//! Split a raw reply into fields. Delimiters are matched from left to
+//! right without overlap, so a run of filling characters leaves its odd
+//! '#' at the start of the following field, exactly as QString::split().
+//! The field offsets are kept between replies, so splitting does not
+//! allocate once the first reply has been seen.
+//!
+//! @returns: nothing
+//!************************************************************************
+void CgiPayload::split
+    (
+    const QByteArray& aBytes    //!< raw reply
+    )
+{
+    mBytes = aBytes;
+    mFieldStart.clear();
+    mFieldStart.push_back( 0 );
+
+    FieldScanner::scan( mBytes.constData(), mBytes.size(), mFieldStart );
+    mFieldStart.push_back( mBytes.size() + 2 );
+}
+
+//!************************************************************************
+//! Convert a field to a floating point number
+//!
+//! @returns: the field value, or 0 if the field is not a number
+//!************************************************************************
+double CgiPayload::toDouble
+    (
+    const int aIndex    //!< field index
+    ) const
+{
+    return parseDouble( fieldData( aIndex ), fieldLength( aIndex ) );
+}
+
+//!************************************************************************
+//! Convert a field to a duration
+//!
+//! @returns: the field value in seconds, or -1 if the field is not a duration
+//!************************************************************************
+int64_t CgiPayload::toDuration
+    (
+    const int aIndex    //!< field index
+    ) const
+{
+    return parseDuration( fieldData( aIndex ), fieldLength( aIndex ) );
+}
+
+//!************************************************************************
+//! Convert a field to a string
+//!
+//! @returns: a new string with the field content
+//!************************************************************************
+QString CgiPayload::toString
+    (
+    const int aIndex    //!< field index
+    ) const
+{
+    return QString::fromUtf8( fieldData( aIndex ), fieldLength( aIndex ) );
+}
+
+//!************************************************************************
+//! Convert a field to an unsigned integer
+//!
+//! @returns: the field value, or 0 if the field is not a number
+//!************************************************************************
+uint64_t CgiPayload::toUnsigned
+    (
+    const int aIndex    //!< field index
+    ) const
+{
+    return parseUnsigned( fieldData( aIndex ), fieldLength( aIndex ) );
+}
@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+CgiPayload.h
+
+This file contains the definitions for the CGI payload field splitter.
+*/
+
+#ifndef CgiPayload_h
+#define CgiPayload_h
+
+#include <cstdint>
+#include <vector>
+
+#include <QByteArray>
+#include <QString>
+
+
+//************************************************************************
+// Class for splitting a raw CGI reply into its delimited fields. The
+// fields are kept as views into the reply bytes, so no copy is made
+// unless a field is explicitly converted to a string.
+//************************************************************************
+class CgiPayload
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        static const char FIELD_DELIMITER[];    //!< field delimiter
+        static const char FIELD_FILL = '#';     //!< filling character
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        CgiPayload();
+
+        void clear();
+
+        const char* fieldData
+            (
+            const int aIndex            //!< field index
+            ) const;
+
+        int fieldLength
+            (
+            const int aIndex            //!< field index
+            ) const;
+
+        int size() const;
+
+        void split
+            (
+            const QByteArray& aBytes    //!< raw reply
+            );
+
+        double toDouble
+            (
+            const int aIndex            //!< field index
+            ) const;
+
+        int64_t toDuration
+            (
+            const int aIndex            //!< field index
+            ) const;
+
+        QString toString
+            (
+            const int aIndex            //!< field index
+            ) const;
+
+        uint64_t toUnsigned
+            (
+            const int aIndex            //!< field index
+            ) const;
+
+        static double parseDouble
+            (
+            const char* aData,          //!< field data
+            const int   aLength         //!< field length
+            );
+
+        static int64_t parseDuration
+            (
+            const char* aData,          //!< field data
+            const int   aLength         //!< field length
+            );
+
+        static uint64_t parseUnsigned
+            (
+            const char* aData,          //!< field data
+            const int   aLength         //!< field length
+            );
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        QByteArray              mBytes;         //!< raw reply, shared with the caller
+        std::vector<int>        mFieldStart;    //!< start offset of each field, plus an end sentinel
+};
+
+#endif // CgiPayload_h
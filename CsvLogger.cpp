@@ -0,0 +1,537 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+CsvLogger.cpp
+
+This file contains the sources for logging the published samples
+to CSV files.
+*/
+
+#include "CsvLogger.h"
+
+#include "DeltaPublisher.h"
+#include "RebootDetector.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QProcess>
+#include <QSettings>
+#include <QStringList>
+
+#include <stdio.h>
+#include <time.h>
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+CsvLogger::CsvLogger()
+    : mConfig( defaultConfig() )
+    , mFileBytes( 0 )
+    , mFileStartMs( -1 )
+    , mLastFlushMs( -1 )
+    , mLastTimeMs( 0 )
+{
+}
+
+//!************************************************************************
+//! Destructor
+//!************************************************************************
+CsvLogger::~CsvLogger()
+{
+    close();
+}
+
+//!************************************************************************
+//! Append a cell, quoted if it holds a separator, a quote or a line break
+//!
+//! @returns: nothing
+//!************************************************************************
+/* static */ void CsvLogger::appendCell
+    (
+    std::string&        aBuffer,    //!< buffer to append to
+    const std::string&  aCell       //!< cell text
+    )
+{
+    if( std::string::npos == aCell.find_first_of( ",\"\r\n" ) )
+    {
+        aBuffer += aCell;
+        return;
+    }
+
+    aBuffer += '"';
+
+    for( size_t i = 0; i < aCell.size(); i++ )
+    {
+        if( '"' == aCell[i] )
+        {
+            aBuffer += '"';
+        }
+
+        aBuffer += aCell[i];
+    }
+
+    aBuffer += '"';
+}
+
+//!************************************************************************
+//! Rename the closed active log file with the time of its first row, and
+//! optionally compress it in the background. Compression is turned off
+//! when gzip cannot be started, e.g. on Windows, with a single warning.
+//!
+//! @returns: nothing
+//!************************************************************************
+void CsvLogger::archive
+    (
+    const int64_t       aStartMs    //!< time of the first row of the file, ms since epoch
+    )
+{
+    const std::string CSV_EXTENSION = ".csv";
+
+    std::string base = mConfig.Path;
+
+    if( base.size() > CSV_EXTENSION.size()
+     && 0 == base.compare( base.size() - CSV_EXTENSION.size(), CSV_EXTENSION.size(), CSV_EXTENSION ) )
+    {
+        base.erase( base.size() - CSV_EXTENSION.size() );
+    }
+
+    // the name has a resolution of one second, so a log rotated again
+    // within the same second gets a counter instead of overwriting it
+    const std::string stamped = base + "-" + formatUtc( aStartMs, true );
+    std::string rotatedPath = stamped + CSV_EXTENSION;
+
+    for( int suffix = 1; QFile::exists( QString::fromStdString( rotatedPath ) )
+                      || QFile::exists( QString::fromStdString( rotatedPath + ".gz" ) ); suffix++ )
+    {
+        rotatedPath = stamped + "-" + std::to_string( suffix ) + CSV_EXTENSION;
+    }
+
+    if( 0 != ::rename( mConfig.Path.c_str(), rotatedPath.c_str() ) )
+    {
+        qWarning() << "CSV log" << mConfig.Path.c_str() << "could not be rotated";
+    }
+    else if( mConfig.Compress
+          && !QProcess::startDetached( "gzip", QStringList() << QString::fromStdString( rotatedPath ) ) )
+    {
+        qWarning() << "CSV log" << rotatedPath.c_str() << "could not be compressed, gzip is not available; compression is turned off";
+        mConfig.Compress = false;
+    }
+}
+
+//!************************************************************************
+//! Write the buffered rows and close the log file
+//!
+//! @returns: nothing
+//!************************************************************************
+void CsvLogger::close()
+{
+    if( mFile.is_open() )
+    {
+        flush( mLastTimeMs );
+        mFile.close();
+    }
+}
+
+//!************************************************************************
+//! Get the default settings: all schema fields, 64 kB writes at least
+//! every 30 s, and a new file every 16 MB or every day
+//!
+//! @returns: the settings, without a path
+//!************************************************************************
+/* static */ CsvLoggerConfig CsvLogger::defaultConfig()
+{
+    CsvLoggerConfig config;
+    config.FlushBytes = 64 * 1024;
+    config.FlushMs = 30 * 1000;
+    config.RotateBytes = 16 * 1024 * 1024;
+    config.RotateMs = 24 * 3600 * 1000;
+    config.Compress = false;
+
+    for( int source = 0; source < ENDPOINT_COUNT; source++ )
+    {
+        const SchemaField* fields = SampleSchema::fields( static_cast<Endpoint>( source ) );
+        const int fieldCount = SampleSchema::fieldCount( static_cast<Endpoint>( source ) );
+
+        for( int i = 0; i < fieldCount; i++ )
+        {
+            config.Columns.push_back( fields[i].Name );
+        }
+    }
+
+    return config;
+}
+
+//!************************************************************************
+//! Write the buffered rows, rotating the file first if it is due
+//!
+//! @returns: nothing
+//!************************************************************************
+void CsvLogger::flush
+    (
+    const int64_t       aTimeMs     //!< current time, ms since epoch
+    )
+{
+    mLastFlushMs = aTimeMs;
+
+    if( mBuffer.empty() )
+    {
+        return;
+    }
+
+    if( mFileStartMs >= 0
+     && ( mFileBytes >= mConfig.RotateBytes || aTimeMs - mFileStartMs >= mConfig.RotateMs ) )
+    {
+        rotate( aTimeMs );
+    }
+
+    mFile.write( mBuffer.data(), static_cast<std::streamsize>( mBuffer.size() ) );
+    mFile.flush();
+
+    mFileBytes += mBuffer.size();
+    mBuffer.clear();
+}
+
+//!************************************************************************
+//! Write the buffered rows if they are older than the flush period, for
+//! when no rows are added for a while
+//!
+//! @returns: nothing
+//!************************************************************************
+void CsvLogger::flushIfDue
+    (
+    const int64_t       aTimeMs     //!< current time, ms since epoch
+    )
+{
+    if( mFile.is_open() && !mBuffer.empty() && aTimeMs - mLastFlushMs >= mConfig.FlushMs )
+    {
+        flush( aTimeMs );
+    }
+}
+
+//!************************************************************************
+//! Format a time in UTC
+//!
+//! @returns: "yyyy-mm-dd hh:mm:ss.zzz", or "yyyymmdd-hhmmss" for a file name
+//!************************************************************************
+/* static */ std::string CsvLogger::formatUtc
+    (
+    const int64_t       aTimeMs,    //!< time, ms since epoch
+    const bool          aFileName   //!< true for a file name suffix, else a cell
+    )
+{
+    const time_t seconds = static_cast<time_t>( aTimeMs / 1000 );
+    const struct tm* utc = gmtime( &seconds );
+    char text[80] = { 0 };
+
+    if( utc )
+    {
+        if( aFileName )
+        {
+            snprintf( text, sizeof( text ), "%04d%02d%02d-%02d%02d%02d",
+                      utc->tm_year + 1900, utc->tm_mon + 1, utc->tm_mday, utc->tm_hour, utc->tm_min, utc->tm_sec );
+        }
+        else
+        {
+            snprintf( text, sizeof( text ), "%04d-%02d-%02d %02d:%02d:%02d.%03d",
+                      utc->tm_year + 1900, utc->tm_mon + 1, utc->tm_mday, utc->tm_hour, utc->tm_min, utc->tm_sec,
+                      static_cast<int>( aTimeMs % 1000 ) );
+        }
+    }
+
+    return text;
+}
+
+//!************************************************************************
+//! Build the header line of the configured columns
+//!
+//! @returns: the header, with its line break
+//!************************************************************************
+std::string CsvLogger::header() const
+{
+    std::string line = "time_utc,terminal,reset";
+
+    for( size_t i = 0; i < mColumns.size(); i++ )
+    {
+        line += ',';
+        line += mColumns[i].Field->Name;
+    }
+
+    line += '\n';
+
+    return line;
+}
+
+//!************************************************************************
+//! Check whether rows are logged
+//!
+//! @returns: true if the log file is open
+//!************************************************************************
+bool CsvLogger::isOpen() const
+{
+    return mFile.is_open();
+}
+
+//!************************************************************************
+//! Read the settings from the [Csv] group of an INI file:
+//!
+//!     [Csv]
+//!     Enabled=true
+//!     Path=C:/logs/surfbeam2.csv
+//!     Columns=rx_snr_db, rx_pwr_dbm, temperature_c
+//!     FlushKiB=64
+//!     FlushSeconds=30
+//!     RotateMiB=16
+//!     RotateHours=24
+//!     Compress=true
+//!
+//! @returns: true if logging is enabled
+//!************************************************************************
+bool CsvLogger::load
+    (
+    const QString&      aPath,      //!< INI file
+    CsvLoggerConfig&    aConfig     //!< settings, defaults for the missing keys
+    ) const
+{
+    if( !QFile::exists( aPath ) )
+    {
+        return false;
+    }
+
+    QSettings settings( aPath, QSettings::IniFormat );
+    settings.beginGroup( "Csv" );
+
+    const bool enabled = settings.value( "Enabled", false ).toBool();
+
+    if( settings.value( "Path" ).isValid() )
+    {
+        aConfig.Path = settings.value( "Path" ).toString().toStdString();
+    }
+
+    if( settings.value( "Columns" ).isValid() )
+    {
+        const QStringList columns = settings.value( "Columns" ).toStringList();
+        aConfig.Columns.clear();
+
+        for( int i = 0; i < columns.size(); i++ )
+        {
+            aConfig.Columns.push_back( columns[i].trimmed().toStdString() );
+        }
+    }
+
+    aConfig.FlushBytes = static_cast<size_t>( settings.value( "FlushKiB", static_cast<int>( aConfig.FlushBytes / 1024 ) ).toInt() ) * 1024;
+    aConfig.FlushMs = static_cast<int64_t>( settings.value( "FlushSeconds", static_cast<int>( aConfig.FlushMs / 1000 ) ).toInt() ) * 1000;
+    aConfig.RotateBytes = static_cast<uint64_t>( settings.value( "RotateMiB", static_cast<int>( aConfig.RotateBytes / ( 1024 * 1024 ) ) ).toInt() ) * 1024 * 1024;
+    aConfig.RotateMs = static_cast<int64_t>( settings.value( "RotateHours", static_cast<int>( aConfig.RotateMs / ( 3600 * 1000 ) ) ).toInt() ) * 3600 * 1000;
+    aConfig.Compress = settings.value( "Compress", aConfig.Compress ).toBool();
+
+    settings.endGroup();
+
+    return enabled;
+}
+
+//!************************************************************************
+//! Start logging. Unknown column names are skipped with a warning.
+//!
+//! @returns: true if the log file could be opened
+//!************************************************************************
+bool CsvLogger::open
+    (
+    const CsvLoggerConfig& aConfig  //!< settings
+    )
+{
+    close();
+
+    mConfig = aConfig;
+    mColumns.clear();
+    mCells.clear();
+
+    for( int source = 0; source < ENDPOINT_COUNT; source++ )
+    {
+        mColumnOf[source].assign( DELTA_MAX_FIELDS, -1 );
+    }
+
+    for( size_t i = 0; i < mConfig.Columns.size(); i++ )
+    {
+        const char* name = mConfig.Columns[i].c_str();
+        Column column = { ENDPOINT_MODEM, SampleSchema::find( ENDPOINT_MODEM, name ) };
+
+        if( !column.Field )
+        {
+            column.Source = ENDPOINT_TRIA;
+            column.Field = SampleSchema::find( ENDPOINT_TRIA, name );
+        }
+
+        if( !column.Field )
+        {
+            qWarning() << "CSV log column" << name << "is not a known field";
+            continue;
+        }
+
+        mColumnOf[column.Source][column.Field->Index] = static_cast<int>( mColumns.size() );
+        mColumns.push_back( column );
+    }
+
+    mBuffer.clear();
+    mBuffer.reserve( 2 * mConfig.FlushBytes );
+    mFileStartMs = -1;
+    mLastFlushMs = -1;
+
+    return openFile();
+}
+
+//!************************************************************************
+//! Open the active log file for appending, writing the header if the
+//! file is new
+//!
+//! @returns: true if the file could be opened
+//!************************************************************************
+bool CsvLogger::openFile()
+{
+    const std::string columns = header();
+
+    std::ifstream existing( mConfig.Path.c_str(), std::ios::in | std::ios::binary );
+    std::string firstLine;
+
+    if( existing.is_open() && std::getline( existing, firstLine ) )
+    {
+        firstLine += '\n';
+
+        if( firstLine != columns )
+        {
+            // the columns were changed in the settings: rows appended to
+            // this file would not match its header, so it is moved aside,
+            // named after the time it is replaced
+            existing.close();
+            archive( static_cast<int64_t>( time( nullptr ) ) * 1000 );
+        }
+    }
+
+    existing.close();
+    existing.open( mConfig.Path.c_str(), std::ios::in | std::ios::binary | std::ios::ate );
+    mFileBytes = existing.is_open() ? static_cast<uint64_t>( existing.tellg() ) : 0;
+    existing.close();
+
+    mFile.open( mConfig.Path.c_str(), std::ios::out | std::ios::app | std::ios::binary );
+
+    if( !mFile.is_open() )
+    {
+        return false;
+    }
+
+    if( 0 == mFileBytes )
+    {
+        mFile.write( columns.data(), static_cast<std::streamsize>( columns.size() ) );
+        mFileBytes = columns.size();
+    }
+
+    return true;
+}
+
+//!************************************************************************
+//! Add a row with the latest value of every column of a terminal
+//!
+//! @returns: nothing
+//!************************************************************************
+void CsvLogger::publish
+    (
+    const SampleDelta&  aDelta      //!< changed fields of a reply
+    )
+{
+    if( !mFile.is_open() )
+    {
+        return;
+    }
+
+    while( mCells.size() <= aDelta.Terminal )
+    {
+        mCells.push_back( std::vector<std::string>( mColumns.size() ) );
+    }
+
+    std::vector<std::string>& cells = mCells[aDelta.Terminal];
+    const std::vector<int>& columnOf = mColumnOf[aDelta.Source];
+    const CgiPayload& payload = *aDelta.Payload;
+
+    for( int i = 0; i < aDelta.FieldCount; i++ )
+    {
+        const int column = columnOf[i];
+
+        if( column < 0 || !DeltaPublisher::isChanged( aDelta, i ) )
+        {
+            continue;
+        }
+
+        if( FIELD_TYPE_DURATION == mColumns[column].Field->Type )
+        {
+            const int64_t seconds = CgiPayload::parseDuration( payload.fieldData( i ), payload.fieldLength( i ) );
+            cells[column] = ( seconds >= 0 ) ? std::to_string( seconds ) : std::string();
+        }
+        else
+        {
+            cells[column].assign( payload.fieldData( i ), payload.fieldLength( i ) );
+        }
+    }
+
+    mBuffer += formatUtc( aDelta.TimeMs, false );
+    mBuffer += ',';
+    mBuffer += std::to_string( aDelta.Terminal );
+    mBuffer += ',';
+    mBuffer += RebootDetector::causeName( aDelta.Resets );
+
+    for( size_t i = 0; i < cells.size(); i++ )
+    {
+        mBuffer += ',';
+        appendCell( mBuffer, cells[i] );
+    }
+
+    mBuffer += '\n';
+
+    mLastTimeMs = aDelta.TimeMs;
+
+    if( mFileStartMs < 0 )
+    {
+        mFileStartMs = aDelta.TimeMs;
+    }
+
+    if( mLastFlushMs < 0 )
+    {
+        mLastFlushMs = aDelta.TimeMs;
+    }
+
+    if( mBuffer.size() >= mConfig.FlushBytes || aDelta.TimeMs - mLastFlushMs >= mConfig.FlushMs )
+    {
+        flush( aDelta.TimeMs );
+    }
+}
+
+//!************************************************************************
+//! Rename the active log file and start a new one
+//!
+//! @returns: nothing
+//!************************************************************************
+void CsvLogger::rotate
+    (
+    const int64_t       aTimeMs     //!< current time, ms since epoch
+    )
+{
+    mFile.close();
+    archive( mFileStartMs );
+
+    mFileStartMs = aTimeMs;
+    openFile();
+}
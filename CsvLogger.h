@@ -0,0 +1,160 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+CsvLogger.h
+
+This file contains the definitions for logging the published samples
+to CSV files.
+*/
+
+#ifndef CsvLogger_h
+#define CsvLogger_h
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <QString>
+
+#include "SampleSchema.h"
+#include "SampleSink.h"
+
+
+//************************************************************************
+// CSV logging settings
+//************************************************************************
+typedef struct
+{
+    std::string                 Path;           //!< active log file; rotated files get a time suffix
+    std::vector<std::string>    Columns;        //!< schema field names, in column order
+    size_t                      FlushBytes;     //!< buffered bytes triggering a write
+    int64_t                     FlushMs;        //!< maximum time rows stay buffered
+    uint64_t                    RotateBytes;    //!< file size triggering a rotation
+    int64_t                     RotateMs;       //!< file age triggering a rotation
+    bool                        Compress;       //!< true to gzip the rotated files
+}CsvLoggerConfig;
+
+//************************************************************************
+// Class for logging the published samples as spreadsheet friendly CSV,
+// one row per delta with the latest value of every configured column,
+// after the time, the terminal and the reset detected with the reply.
+// Rows are collected in a large buffer which is written when it fills up
+// or gets old, so that the storage, often an SD card, sees few large
+// writes. The file is rotated by size or age, and the rotated files can
+// be compressed in the background.
+//************************************************************************
+class CsvLogger : public SampleSink
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    private:
+        typedef struct
+        {
+            Endpoint                    Source;         //!< endpoint reporting the column
+            const SchemaField*          Field;          //!< decoded field
+        }Column;
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        CsvLogger();
+
+        ~CsvLogger();
+
+        void close();
+
+        static CsvLoggerConfig defaultConfig();
+
+        void flushIfDue
+            (
+            const int64_t       aTimeMs     //!< current time, ms since epoch
+            );
+
+        bool isOpen() const;
+
+        bool load
+            (
+            const QString&      aPath,      //!< INI file
+            CsvLoggerConfig&    aConfig     //!< settings, defaults for the missing keys
+            ) const;
+
+        bool open
+            (
+            const CsvLoggerConfig& aConfig  //!< settings
+            );
+
+        void publish
+            (
+            const SampleDelta&  aDelta      //!< changed fields of a reply
+            ) override;
+
+    private:
+        static void appendCell
+            (
+            std::string&        aBuffer,    //!< buffer to append to
+            const std::string&  aCell       //!< cell text
+            );
+
+        void archive
+            (
+            const int64_t       aStartMs    //!< time of the first row of the file, ms since epoch
+            );
+
+        static std::string formatUtc
+            (
+            const int64_t       aTimeMs,    //!< time, ms since epoch
+            const bool          aFileName   //!< true for a file name suffix, else a cell
+            );
+
+        void flush
+            (
+            const int64_t       aTimeMs     //!< current time, ms since epoch
+            );
+
+        std::string header() const;
+
+        bool openFile();
+
+        void rotate
+            (
+            const int64_t       aTimeMs     //!< current time, ms since epoch
+            );
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        CsvLoggerConfig                         mConfig;            //!< settings
+        std::vector<Column>                     mColumns;           //!< resolved columns
+        std::vector<int>                        mColumnOf[ENDPOINT_COUNT];  //!< column of each field index, -1 if not logged
+
+        std::vector<std::vector<std::string>>   mCells;             //!< latest cell texts of each terminal
+
+        std::ofstream                           mFile;              //!< active log file
+        uint64_t                                mFileBytes;         //!< size of the active log file
+        int64_t                                 mFileStartMs;       //!< time of the first row in the active file, -1 if none
+
+        std::string                             mBuffer;            //!< rows not yet written
+        int64_t                                 mLastFlushMs;       //!< time of the last write, -1 if none
+        int64_t                                 mLastTimeMs;        //!< time of the last row
+};
+
+#endif // CsvLogger_h
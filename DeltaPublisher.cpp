@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+DeltaPublisher.cpp
+
+This file contains the sources for publishing the changed fields of
+the replies.
+*/
+
+#include "DeltaPublisher.h"
+
+#include <algorithm>
+
+#include <string.h>
+
+
+const int64_t DeltaPublisher::KEYFRAME_MS;
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+DeltaPublisher::DeltaPublisher()
+{
+}
+
+//!************************************************************************
+//! Add a sink. Every terminal starts over with a keyframe, so that the
+//! new sink gets complete replies first.
+//!
+//! @returns: nothing
+//!************************************************************************
+void DeltaPublisher::addSink
+    (
+    SampleSink*         aSink       //!< sink, not owned
+    )
+{
+    mSinks.push_back( aSink );
+    requestKeyframes();
+}
+
+//!************************************************************************
+//! Add a terminal
+//!
+//! @returns: the index of the terminal
+//!************************************************************************
+size_t DeltaPublisher::addTerminal()
+{
+    EndpointState state;
+    state.KeyframeMs = -1;
+
+    mStates.insert( mStates.end(), ENDPOINT_COUNT, state );
+
+    return mStates.size() / ENDPOINT_COUNT - 1;
+}
+
+//!************************************************************************
+//! Check whether a field is flagged in a delta
+//!
+//! @returns: true if the field changed, or the delta is a keyframe
+//!************************************************************************
+/* static */ bool DeltaPublisher::isChanged
+    (
+    const SampleDelta&  aDelta,     //!< published delta
+    const int           aIndex      //!< field index
+    )
+{
+    return 0 != ( aDelta.Changed[aIndex / 64] & ( 1ull << ( aIndex % 64 ) ) );
+}
+
+//!************************************************************************
+//! Compare a reply with the previous one of the same terminal endpoint
+//! and publish the changed fields to the sinks. A reply without changes
+//! is not published. Fields beyond DELTA_MAX_FIELDS are not tracked.
+//!
+//! @returns: true if a delta was published
+//!************************************************************************
+bool DeltaPublisher::publish
+    (
+    const size_t        aTerminal,  //!< terminal index
+    const Endpoint      aSource,    //!< endpoint of the reply
+    const int64_t       aTimeMs,    //!< time of the reply, ms since epoch
+    const CgiPayload&   aPayload,   //!< split reply
+    const uint8_t       aResets     //!< ResetCause bits detected with the reply
+    )
+{
+    EndpointState& state = mStates.at( aTerminal * ENDPOINT_COUNT + aSource );
+
+    SampleDelta delta;
+    delta.Terminal = aTerminal;
+    delta.Source = aSource;
+    delta.TimeMs = aTimeMs;
+    delta.Resets = aResets;
+    delta.FieldCount = std::min( aPayload.size(), DELTA_MAX_FIELDS );
+    delta.Payload = &aPayload;
+    delta.Keyframe = state.KeyframeMs < 0
+                  || aTimeMs - state.KeyframeMs >= KEYFRAME_MS
+                  || state.Previous.size() != aPayload.size();
+
+    memset( delta.Changed, 0, sizeof( delta.Changed ) );
+
+    bool changed = false;
+
+    for( int i = 0; i < delta.FieldCount; i++ )
+    {
+        const int length = aPayload.fieldLength( i );
+
+        if( delta.Keyframe
+         || length != state.Previous.fieldLength( i )
+         || 0 != memcmp( aPayload.fieldData( i ), state.Previous.fieldData( i ), length ) )
+        {
+            delta.Changed[i / 64] |= 1ull << ( i % 64 );
+            changed = true;
+        }
+    }
+
+    state.Previous = aPayload;
+
+    if( delta.Keyframe )
+    {
+        state.KeyframeMs = aTimeMs;
+    }
+
+    if( !changed && !delta.Keyframe && !aResets )
+    {
+        return false;
+    }
+
+    for( size_t i = 0; i < mSinks.size(); i++ )
+    {
+        mSinks[i]->publish( delta );
+    }
+
+    return true;
+}
+
+//!************************************************************************
+//! Remove a sink
+//!
+//! @returns: nothing
+//!************************************************************************
+void DeltaPublisher::removeSink
+    (
+    SampleSink*         aSink       //!< sink to remove
+    )
+{
+    mSinks.erase( std::remove( mSinks.begin(), mSinks.end(), aSink ), mSinks.end() );
+}
+
+//!************************************************************************
+//! Make the next reply of every terminal endpoint a keyframe
+//!
+//! @returns: nothing
+//!************************************************************************
+void DeltaPublisher::requestKeyframes()
+{
+    for( size_t i = 0; i < mStates.size(); i++ )
+    {
+        mStates[i].KeyframeMs = -1;
+    }
+}
@@ -0,0 +1,101 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+DeltaPublisher.h
+
+This file contains the definitions for publishing the changed fields of
+the replies.
+*/
+
+#ifndef DeltaPublisher_h
+#define DeltaPublisher_h
+
+#include <cstdint>
+#include <vector>
+
+#include "CgiPayload.h"
+#include "SampleSink.h"
+#include "SurfBeam2Types.h"
+
+
+//************************************************************************
+// Class for publishing the replies of many terminals to the sinks as
+// field level deltas. Each reply is compared field by field with the
+// previous reply of the same terminal endpoint; the sinks receive the
+// bitmap of the changed fields, and periodically a keyframe flagging all
+// fields so that a reader can start anywhere in a stream.
+//************************************************************************
+class DeltaPublisher
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        static const int64_t KEYFRAME_MS = 60000;   //!< maximum time between keyframes
+
+    private:
+        typedef struct
+        {
+            CgiPayload                  Previous;       //!< previous reply
+            int64_t                     KeyframeMs;     //!< time of the last keyframe, -1 for none
+        }EndpointState;
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        DeltaPublisher();
+
+        void addSink
+            (
+            SampleSink*         aSink       //!< sink, not owned
+            );
+
+        size_t addTerminal();
+
+        static bool isChanged
+            (
+            const SampleDelta&  aDelta,     //!< published delta
+            const int           aIndex      //!< field index
+            );
+
+        bool publish
+            (
+            const size_t        aTerminal,  //!< terminal index
+            const Endpoint      aSource,    //!< endpoint of the reply
+            const int64_t       aTimeMs,    //!< time of the reply, ms since epoch
+            const CgiPayload&   aPayload,   //!< split reply
+            const uint8_t       aResets = 0 //!< ResetCause bits detected with the reply
+            );
+
+        void removeSink
+            (
+            SampleSink*         aSink       //!< sink to remove
+            );
+
+        void requestKeyframes();
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        std::vector<SampleSink*>        mSinks;         //!< receivers of the deltas
+        std::vector<EndpointState>      mStates;        //!< ENDPOINT_COUNT states per terminal
+};
+
+#endif // DeltaPublisher_h
@@ -0,0 +1,250 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+FadeDetector.cpp
+
+This file contains the sources for the detection of Rx fades.
+*/
+
+#include "FadeDetector.h"
+
+#include <math.h>
+
+
+constexpr double FadeDetector::FADE_START_DB;
+constexpr double FadeDetector::FADE_END_DB;
+constexpr double FadeDetector::RX_PWR_FOLLOWS_DB;
+
+const int64_t FadeDetector::SHORT_WINDOW_MS;
+const int64_t FadeDetector::MEDIUM_WINDOW_MS;
+const int64_t FadeDetector::BASELINE_WINDOW_MS;
+const int64_t FadeDetector::MAX_RAIN_MS;
+const uint32_t FadeDetector::MIN_BASELINE_SAMPLES;
+
+static const int SHORT_BUCKETS = 12;        //!< 5 s buckets
+static const int MEDIUM_BUCKETS = 30;       //!< 30 s buckets
+static const int BASELINE_BUCKETS = 96;     //!< 15 min buckets
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+FadeDetector::FadeDetector()
+    : mSnrShort( SHORT_WINDOW_MS, SHORT_BUCKETS )
+    , mSnrMedium( MEDIUM_WINDOW_MS, MEDIUM_BUCKETS )
+    , mSnrBaseline( BASELINE_WINDOW_MS, BASELINE_BUCKETS )
+    , mRxPwrShort( SHORT_WINDOW_MS, SHORT_BUCKETS )
+    , mRxPwrBaseline( BASELINE_WINDOW_MS, BASELINE_BUCKETS )
+    , mInFade( false )
+    , mPending()
+    , mCurrentDepth( 0.0 )
+{
+}
+
+//!************************************************************************
+//! Get the SNR drop of the last sample
+//!
+//! @returns: the short mean below the baseline mean [dB], 0 until the
+//!           baseline is established
+//!************************************************************************
+double FadeDetector::currentDepth() const
+{
+    return mCurrentDepth;
+}
+
+//!************************************************************************
+//! Get the completed fades
+//!
+//! @returns: the fades, in time order
+//!************************************************************************
+const std::vector<FadeEvent>& FadeDetector::events() const
+{
+    return mEvents;
+}
+
+//!************************************************************************
+//! Classify and store the fade in progress
+//!
+//! @returns: nothing
+//!************************************************************************
+void FadeDetector::finishFade
+    (
+    const int64_t   aTimeMs,        //!< time of the recovery or of the baseline loss
+    const bool      aBaselineLost   //!< true if the baseline drained during the fade
+    )
+{
+    mPending.EndMs = aTimeMs;
+
+    const double depth = mPending.PeakSnrDepthDb;
+    const int64_t durationMs = mPending.EndMs - mPending.StartMs;
+
+    if( depth > 10.0 )
+    {
+        mPending.Depth = FADE_DEPTH_SEVERE;
+    }
+    else if( depth > 6.0 )
+    {
+        mPending.Depth = FADE_DEPTH_MODERATE;
+    }
+    else
+    {
+        mPending.Depth = FADE_DEPTH_LIGHT;
+    }
+
+    if( aBaselineLost )
+    {
+        mPending.Kind = FADE_KIND_PERSISTENT;
+    }
+    else if( durationMs < SHORT_WINDOW_MS )
+    {
+        mPending.Kind = FADE_KIND_BLOCKAGE;
+    }
+    else if( durationMs > MAX_RAIN_MS )
+    {
+        mPending.Kind = FADE_KIND_PERSISTENT;
+    }
+    else if( mPending.PeakRxPwrDepthDb >= RX_PWR_FOLLOWS_DB )
+    {
+        mPending.Kind = FADE_KIND_RAIN;
+    }
+    else
+    {
+        mPending.Kind = FADE_KIND_INTERFERENCE;
+    }
+
+    mEvents.push_back( mPending );
+    mInFade = false;
+}
+
+//!************************************************************************
+//! Check whether a fade is in progress
+//!
+//! @returns: true during a fade
+//!************************************************************************
+bool FadeDetector::inFade() const
+{
+    return mInFade;
+}
+
+//!************************************************************************
+//! Account a sample. Samples without an SNR are ignored. A fade lasting
+//! until its frozen baseline drains is ended as persistent.
+//!
+//! @returns: true if a fade was completed
+//!************************************************************************
+bool FadeDetector::update
+    (
+    const MetricSample& aSample     //!< new sample
+    )
+{
+    const double snr = aSample.Values[METRIC_RX_SNR_DB];
+    const double rxPwr = aSample.Values[METRIC_RX_PWR_DBM];
+    const int64_t timeMs = aSample.TimeMs;
+
+    if( isnan( snr ) )
+    {
+        return false;
+    }
+
+    mSnrShort.add( timeMs, snr );
+    mSnrMedium.add( timeMs, snr );
+
+    if( !isnan( rxPwr ) )
+    {
+        mRxPwrShort.add( timeMs, rxPwr );
+    }
+
+    if( !mInFade )
+    {
+        mSnrBaseline.add( timeMs, snr );
+
+        if( !isnan( rxPwr ) )
+        {
+            mRxPwrBaseline.add( timeMs, rxPwr );
+        }
+    }
+    else
+    {
+        mSnrBaseline.advance( timeMs );
+        mRxPwrBaseline.advance( timeMs );
+    }
+
+    if( mSnrBaseline.count() < MIN_BASELINE_SAMPLES )
+    {
+        mCurrentDepth = 0.0;
+
+        if( mInFade )
+        {
+            // the fade outlasted its frozen baseline, so the degraded
+            // level is the new normal and the baseline is built again
+            // from it alone
+            mSnrBaseline.clear();
+            mRxPwrBaseline.clear();
+            finishFade( timeMs, true );
+            return true;
+        }
+
+        return false;
+    }
+
+    mCurrentDepth = mSnrBaseline.mean() - mSnrShort.mean();
+
+    const double rxPwrDepth = ( mRxPwrBaseline.count() > 0 && mRxPwrShort.count() > 0 )
+                            ? mRxPwrBaseline.mean() - mRxPwrShort.mean()
+                            : 0.0;
+
+    if( !mInFade )
+    {
+        if( mCurrentDepth >= FADE_START_DB )
+        {
+            mInFade = true;
+            mPending = FadeEvent();
+            mPending.StartMs = timeMs;
+            mPending.PeakSnrDepthDb = static_cast<float>( mCurrentDepth );
+            mPending.PeakRxPwrDepthDb = static_cast<float>( rxPwrDepth );
+            mPending.PeakSnrSpreadDb = static_cast<float>( mSnrMedium.standardDeviation() );
+        }
+
+        return false;
+    }
+
+    if( mCurrentDepth > mPending.PeakSnrDepthDb )
+    {
+        mPending.PeakSnrDepthDb = static_cast<float>( mCurrentDepth );
+    }
+
+    if( rxPwrDepth > mPending.PeakRxPwrDepthDb )
+    {
+        mPending.PeakRxPwrDepthDb = static_cast<float>( rxPwrDepth );
+    }
+
+    const double spread = mSnrMedium.standardDeviation();
+
+    if( spread > mPending.PeakSnrSpreadDb )
+    {
+        mPending.PeakSnrSpreadDb = static_cast<float>( spread );
+    }
+
+    if( mCurrentDepth < FADE_END_DB )
+    {
+        finishFade( timeMs, false );
+        return true;
+    }
+
+    return false;
+}
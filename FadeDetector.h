@@ -0,0 +1,132 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+FadeDetector.h
+
+This file contains the definitions for the detection of Rx fades.
+*/
+
+#ifndef FadeDetector_h
+#define FadeDetector_h
+
+#include <cstdint>
+#include <vector>
+
+#include "RollingWindow.h"
+#include "SurfBeam2Types.h"
+
+
+enum FadeDepth
+{
+    FADE_DEPTH_LIGHT,           //!< SNR up to 6 dB below the baseline
+    FADE_DEPTH_MODERATE,        //!< SNR 6 to 10 dB below the baseline
+    FADE_DEPTH_SEVERE,          //!< SNR more than 10 dB below the baseline
+
+    FADE_DEPTH_COUNT            //!< number of defined depths
+};
+
+enum FadeKind
+{
+    FADE_KIND_BLOCKAGE,         //!< shorter than a minute, e.g. an obstacle
+    FADE_KIND_RAIN,             //!< Rx power drops with the SNR, minutes to hours
+    FADE_KIND_INTERFERENCE,     //!< SNR drops while the Rx power holds
+    FADE_KIND_PERSISTENT,       //!< longer than the rain limit, e.g. a misaligned dish
+
+    FADE_KIND_COUNT             //!< number of defined kinds
+};
+
+//************************************************************************
+// Completed fade
+//************************************************************************
+typedef struct
+{
+    int64_t                     StartMs;            //!< time the SNR fell below the start level
+    int64_t                     EndMs;              //!< time the SNR recovered above the end level
+    float                       PeakSnrDepthDb;     //!< largest SNR drop below the baseline [dB]
+    float                       PeakRxPwrDepthDb;   //!< largest Rx power drop below the baseline [dB]
+    float                       PeakSnrSpreadDb;    //!< largest SNR standard deviation of the medium window [dB]
+    uint8_t                     Depth;              //!< FadeDepth
+    uint8_t                     Kind;               //!< FadeKind
+}FadeEvent;
+
+//************************************************************************
+// Class for detecting fades of the Rx SNR of a terminal. The SNR and the
+// Rx power are tracked over a short window (1 min), a medium window
+// (15 min) and a baseline window (24 h). A fade starts when the short
+// mean of the SNR falls well below the baseline mean, and ends when it
+// recovers; the baseline is frozen meanwhile, so that a long fade does
+// not become its own reference. A fade outlasting the baseline window
+// is ended as persistent.
+//************************************************************************
+class FadeDetector
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        static constexpr double FADE_START_DB = 3.0;                        //!< SNR drop starting a fade
+        static constexpr double FADE_END_DB = 1.5;                          //!< SNR drop ending a fade
+        static constexpr double RX_PWR_FOLLOWS_DB = 1.0;                    //!< Rx power drop telling rain from interference
+
+        static const int64_t SHORT_WINDOW_MS = 60 * 1000;                   //!< short window
+        static const int64_t MEDIUM_WINDOW_MS = 15 * 60 * 1000;             //!< medium window
+        static const int64_t BASELINE_WINDOW_MS = 24 * 60 * 60 * 1000LL;    //!< baseline window
+        static const int64_t MAX_RAIN_MS = 2 * 60 * 60 * 1000LL;            //!< longest fade counted as rain
+        static const uint32_t MIN_BASELINE_SAMPLES = 120;                   //!< samples needed before fades are detected
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        FadeDetector();
+
+        double currentDepth() const;
+
+        const std::vector<FadeEvent>& events() const;
+
+        bool inFade() const;
+
+        bool update
+            (
+            const MetricSample& aSample     //!< new sample
+            );
+
+    private:
+        void finishFade
+            (
+            const int64_t       aTimeMs,        //!< time of the recovery or of the baseline loss
+            const bool          aBaselineLost   //!< true if the baseline drained during the fade
+            );
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        RollingWindow               mSnrShort;          //!< SNR, short window
+        RollingWindow               mSnrMedium;         //!< SNR, medium window
+        RollingWindow               mSnrBaseline;       //!< SNR, baseline window
+        RollingWindow               mRxPwrShort;        //!< Rx power, short window
+        RollingWindow               mRxPwrBaseline;     //!< Rx power, baseline window
+
+        bool                        mInFade;            //!< true during a fade
+        FadeEvent                   mPending;           //!< fade in progress
+        double                      mCurrentDepth;      //!< SNR drop of the last sample [dB]
+        std::vector<FadeEvent>      mEvents;            //!< completed fades, in time order
+};
+
+#endif // FadeDetector_h
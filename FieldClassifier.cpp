@@ -0,0 +1,231 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+FieldClassifier.cpp
+
+This file contains the sources for the keyword based field classifier.
+*/
+
+#include "FieldClassifier.h"
+#include "SurfBeam2Types.h"
+
+#include <QDebug>
+
+#include <string.h>
+
+
+static constexpr FieldClassifier::Keyword BEAM_COLOR_KEYWORDS[] =
+{
+    { "blue",       4,  SATELLITE_STATUS_BEAM_COLOR_BLUE },
+    { "orange",     6,  SATELLITE_STATUS_BEAM_COLOR_ORANGE },
+    { "purple",     6,  SATELLITE_STATUS_BEAM_COLOR_PURPLE },
+    { "green",      5,  SATELLITE_STATUS_BEAM_COLOR_GREEN }
+};
+
+static constexpr FieldClassifier::Keyword MODEM_STATE_KEYWORDS[] =
+{
+    { "scanning",   8,  MODEM_STATE_SCANNING },
+    { "ranging",    7,  MODEM_STATE_RANGING },
+    { "network",    7,  MODEM_STATE_NETWORK_ENTRY },
+    { "dhcp",       4,  MODEM_STATE_DHCP },
+    { "online",     6,  MODEM_STATE_ONLINE }
+};
+
+static constexpr FieldClassifier::Keyword POLARIZATION_KEYWORDS[] =
+{
+    { "left",       4,  POLARIZATION_CIRCULAR_LEFT },
+    { "right",      5,  POLARIZATION_CIRCULAR_RIGHT },
+    { "horiz",      5,  POLARIZATION_HORIZONTAL },
+    { "vert",       4,  POLARIZATION_VERTICAL }
+};
+
+static const int BEAM_COLOR_KEYWORD_COUNT = sizeof( BEAM_COLOR_KEYWORDS ) / sizeof( BEAM_COLOR_KEYWORDS[0] );
+static const int MODEM_STATE_KEYWORD_COUNT = sizeof( MODEM_STATE_KEYWORDS ) / sizeof( MODEM_STATE_KEYWORDS[0] );
+static const int POLARIZATION_KEYWORD_COUNT = sizeof( POLARIZATION_KEYWORDS ) / sizeof( POLARIZATION_KEYWORDS[0] );
+
+static_assert( FieldClassifier::isPerfect( BEAM_COLOR_KEYWORDS, BEAM_COLOR_KEYWORD_COUNT ), "beam color keywords collide, change HASH_MULTIPLIER" );
+static_assert( FieldClassifier::isPerfect( MODEM_STATE_KEYWORDS, MODEM_STATE_KEYWORD_COUNT ), "modem state keywords collide, change HASH_MULTIPLIER" );
+static_assert( FieldClassifier::isPerfect( POLARIZATION_KEYWORDS, POLARIZATION_KEYWORD_COUNT ), "polarization keywords collide, change HASH_MULTIPLIER" );
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+FieldClassifier::FieldClassifier
+    (
+    const Keyword*  aKeywords,      //!< keywords, by decreasing priority
+    const int       aCount,         //!< number of keywords
+    const int       aUnknownValue,  //!< enum value of unrecognised fields
+    const char*     aName           //!< field name, for diagnostics
+    )
+    : mKeywords( aKeywords )
+    , mCount( aCount < MAX_KEYWORDS ? aCount : MAX_KEYWORDS )
+    , mUnknownValue( aUnknownValue )
+    , mName( aName )
+{
+    memset( mSlots, -1, sizeof( mSlots ) );
+
+    for( int i = 0; i < mCount; i++ )
+    {
+        mSlots[keywordHash( mKeywords[i] )] = static_cast<int8_t>( i );
+    }
+}
+
+//!************************************************************************
+//! Create the classifier of the satellite status beam color
+//!
+//! @returns: a classifier returning SatelliteStatusBeamColor values
+//!************************************************************************
+FieldClassifier FieldClassifier::beamColor()
+{
+    return FieldClassifier( BEAM_COLOR_KEYWORDS, BEAM_COLOR_KEYWORD_COUNT, SATELLITE_STATUS_BEAM_COLOR_UNKNOWN, "beam color" );
+}
+
+//!************************************************************************
+//! Classify a field
+//!
+//! @returns: the enum value of the first listed keyword found in the
+//!           field, or the unknown value if there is none
+//!************************************************************************
+int FieldClassifier::classify
+    (
+    const char* aData,      //!< field data
+    const int   aLength     //!< field length
+    )
+{
+    int best = mCount;
+
+    for( int i = 0; i + 2 < aLength && best > 0; i++ )
+    {
+        const int candidate = mSlots[hash( aData[i], aData[i + 1], aData[i + 2] )];
+
+        if( candidate >= 0
+         && candidate < best
+         && matches( mKeywords[candidate], aData + i, aLength - i ) )
+        {
+            best = candidate;
+        }
+    }
+
+    if( best < mCount )
+    {
+        return mKeywords[best].Value;
+    }
+
+    recordUnrecognised( aData, aLength );
+    return mUnknownValue;
+}
+
+//!************************************************************************
+//! Check whether a keyword starts at a position, ignoring the ASCII
+//! letter case
+//!
+//! @returns: true if the keyword is present
+//!************************************************************************
+bool FieldClassifier::matches
+    (
+    const Keyword&  aKeyword,   //!< keyword
+    const char*     aData,      //!< candidate position in the field
+    const int       aLength     //!< bytes left in the field
+    )
+{
+    if( aLength < aKeyword.Length )
+    {
+        return false;
+    }
+
+    for( int i = 0; i < aKeyword.Length; i++ )
+    {
+        const char c = aData[i];
+
+        if( ( c >= 'A' && c <= 'Z' ? c + ( 'a' - 'A' ) : c ) != aKeyword.Text[i] )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//!************************************************************************
+//! Create the classifier of the modem state
+//!
+//! @returns: a classifier returning ModemState values
+//!************************************************************************
+FieldClassifier FieldClassifier::modemState()
+{
+    return FieldClassifier( MODEM_STATE_KEYWORDS, MODEM_STATE_KEYWORD_COUNT, MODEM_STATE_UNKNOWN, "modem state" );
+}
+
+//!************************************************************************
+//! Create the classifier of the antenna polarization
+//!
+//! @returns: a classifier returning AntennaPolarization values
+//!************************************************************************
+FieldClassifier FieldClassifier::polarization()
+{
+    return FieldClassifier( POLARIZATION_KEYWORDS, POLARIZATION_KEYWORD_COUNT, POLARIZATION_UNKNOWN, "polarization" );
+}
+
+//!************************************************************************
+//! Keep a field value none of the keywords matched, so that it can be
+//! added to the schema later. Each distinct value is reported once.
+//!
+//! @returns: nothing
+//!************************************************************************
+void FieldClassifier::recordUnrecognised
+    (
+    const char* aData,      //!< field data
+    const int   aLength     //!< field length
+    )
+{
+    if( 0 == aLength || mUnrecognised.size() >= MAX_UNRECOGNISED )
+    {
+        return;
+    }
+
+    for( int i = 0; i < mUnrecognised.size(); i++ )
+    {
+        const QByteArray& known = mUnrecognised.at( i );
+
+        if( known.size() == aLength && 0 == memcmp( known.constData(), aData, aLength ) )
+        {
+            return;
+        }
+    }
+
+    mUnrecognised.append( QByteArray( aData, aLength ) );
+    qWarning() << "Unrecognised" << mName << "value:" << QString::fromUtf8( aData, aLength );
+}
+
+//!************************************************************************
+//! Get the distinct field values that no keyword matched
+//!
+//! @returns: the unrecognised values, in order of appearance
+//!************************************************************************
+QStringList FieldClassifier::unrecognised() const
+{
+    QStringList values;
+
+    for( int i = 0; i < mUnrecognised.size(); i++ )
+    {
+        values.append( QString::fromUtf8( mUnrecognised.at( i ) ) );
+    }
+
+    return values;
+}
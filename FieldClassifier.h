@@ -0,0 +1,164 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+FieldClassifier.h
+
+This file contains the definitions for the keyword based field classifier.
+*/
+
+#ifndef FieldClassifier_h
+#define FieldClassifier_h
+
+#include <cstdint>
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+
+//************************************************************************
+// Class for mapping a raw text field to an enum value, by looking up a
+// small set of keywords anywhere in the field. Every 3-character window
+// of the field is hashed into a perfect hash table of the keyword
+// prefixes, so the field is classified in one pass whatever the number
+// of keywords. When several keywords are present, the one listed first
+// wins, as with a chain of case-insensitive QString::contains() tests.
+//************************************************************************
+class FieldClassifier
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        typedef struct
+        {
+            const char*                 Text;       //!< lower case keyword, at least 3 characters
+            int                         Length;     //!< keyword length
+            int                         Value;      //!< enum value of the keyword
+        }Keyword;
+
+        static const int SLOT_BITS = 4;                     //!< hash table size as a power of 2
+        static const int SLOT_COUNT = 1 << SLOT_BITS;       //!< number of hash table slots
+        static const int MAX_KEYWORDS = SLOT_COUNT;         //!< maximum number of keywords
+
+        // chosen so that each keyword table below hashes without collisions
+        static const uint32_t HASH_MULTIPLIER = 0x9E377DEB;
+
+    private:
+        static const int MAX_UNRECOGNISED = 16;             //!< maximum number of recorded unknown values
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        FieldClassifier
+            (
+            const Keyword*  aKeywords,      //!< keywords, by decreasing priority
+            const int       aCount,         //!< number of keywords
+            const int       aUnknownValue,  //!< enum value of unrecognised fields
+            const char*     aName           //!< field name, for diagnostics
+            );
+
+        static FieldClassifier beamColor();
+
+        static FieldClassifier modemState();
+
+        static FieldClassifier polarization();
+
+        int classify
+            (
+            const char* aData,              //!< field data
+            const int   aLength             //!< field length
+            );
+
+        QStringList unrecognised() const;
+
+        //!************************************************************************
+        //! Hash a 3-character window, ignoring the ASCII letter case
+        //!
+        //! @returns: the hash table slot of the window
+        //!************************************************************************
+        static constexpr uint32_t hash
+            (
+            const char aFirst,              //!< first character
+            const char aSecond,             //!< second character
+            const char aThird               //!< third character
+            )
+        {
+            return ( ( ( static_cast<uint32_t>( aFirst | 0x20 ) * 31
+                       + static_cast<uint32_t>( aSecond | 0x20 ) ) * 31
+                       + static_cast<uint32_t>( aThird | 0x20 ) ) * HASH_MULTIPLIER ) >> ( 32 - SLOT_BITS );
+        }
+
+        //!************************************************************************
+        //! Check at compile time that no two keywords of a table share a slot
+        //!
+        //! @returns: true if the keyword prefixes hash without collisions
+        //!************************************************************************
+        static constexpr bool isPerfect
+            (
+            const Keyword*  aKeywords,      //!< keywords
+            const int       aCount,         //!< number of keywords
+            const int       aFirst = 0,     //!< index of the first keyword to compare
+            const int       aSecond = 1     //!< index of the second keyword to compare
+            )
+        {
+            return aFirst >= aCount ? true
+                 : aSecond >= aCount ? isPerfect( aKeywords, aCount, aFirst + 1, aFirst + 2 )
+                 : keywordHash( aKeywords[aFirst] ) == keywordHash( aKeywords[aSecond] ) ? false
+                 : isPerfect( aKeywords, aCount, aFirst, aSecond + 1 );
+        }
+
+    private:
+        static constexpr uint32_t keywordHash
+            (
+            const Keyword& aKeyword         //!< keyword
+            )
+        {
+            return hash( aKeyword.Text[0], aKeyword.Text[1], aKeyword.Text[2] );
+        }
+
+        static bool matches
+            (
+            const Keyword&  aKeyword,       //!< keyword
+            const char*     aData,          //!< candidate position in the field
+            const int       aLength         //!< bytes left in the field
+            );
+
+        void recordUnrecognised
+            (
+            const char* aData,              //!< field data
+            const int   aLength             //!< field length
+            );
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        const Keyword*          mKeywords;              //!< keywords, by decreasing priority
+        int                     mCount;                 //!< number of keywords
+        int                     mUnknownValue;          //!< enum value of unrecognised fields
+        const char*             mName;                  //!< field name
+
+        int8_t                  mSlots[SLOT_COUNT];     //!< keyword index of each slot, -1 if unused
+
+        QList<QByteArray>       mUnrecognised;          //!< distinct unrecognised values seen so far
+};
+
+#endif // FieldClassifier_h
@@ -0,0 +1,355 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+FieldScanner.cpp
+
+This file contains the sources for the "##" delimiter scanner.
+*/
+
+#include "CgiPayload.h"
+#include "FieldScanner.h"
+
+#include <cstdint>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+    #define FIELD_SCANNER_SSE2
+    #include <emmintrin.h>
+#endif
+
+#if ( defined( __GNUC__ ) || defined( __clang__ ) ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+    #define FIELD_SCANNER_AVX2
+    #include <immintrin.h>
+#endif
+
+#if defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+    #define FIELD_SCANNER_NEON
+    #include <arm_neon.h>
+#endif
+
+#if defined( _MSC_VER )
+    #include <intrin.h>
+#endif
+
+
+//!************************************************************************
+//! Get the index of the lowest set bit
+//!
+//! @returns: the number of trailing zero bits of a non-zero mask
+//!************************************************************************
+static inline int countTrailingZeros
+    (
+    const uint64_t aMask    //!< non-zero mask
+    )
+{
+#if defined( _MSC_VER ) && defined( _M_X64 )
+    unsigned long index;
+    _BitScanForward64( &index, aMask );
+    return static_cast<int>( index );
+#elif defined( _MSC_VER )
+    unsigned long index;
+
+    if( _BitScanForward( &index, static_cast<unsigned long>( aMask ) ) )
+    {
+        return static_cast<int>( index );
+    }
+
+    _BitScanForward( &index, static_cast<unsigned long>( aMask >> 32 ) );
+    return static_cast<int>( index ) + 32;
+#else
+    return __builtin_ctzll( aMask );
+#endif
+}
+
+//!************************************************************************
+//! Turn the candidate delimiter positions of one block into delimiters.
+//! A candidate is a '#' followed by another '#'; it is a delimiter unless
+//! its first '#' already closed the previous delimiter.
+//!
+//! @returns: the first position allowed to start the next delimiter
+//!************************************************************************
+static inline int resolvePairs
+    (
+    uint64_t            aPairMask,      //!< one bit per candidate position
+    const int           aBitsPerByte,   //!< number of mask bits per byte, power of 2
+    const int           aBase,          //!< reply offset of bit 0
+    int                 aNext,          //!< first position allowed to start a delimiter
+    std::vector<int>&   aFieldStart     //!< appended start offsets
+    )
+{
+    const int shift = ( 4 == aBitsPerByte ) ? 2 : 0;
+
+    while( aPairMask )
+    {
+        const int position = aBase + ( countTrailingZeros( aPairMask ) >> shift );
+        aPairMask &= aPairMask - 1;
+
+        if( position >= aNext )
+        {
+            aFieldStart.push_back( position + 2 );
+            aNext = position + 2;
+        }
+    }
+
+    return aNext;
+}
+
+//!************************************************************************
+//! Get the fastest implementation supported by this CPU
+//!
+//! @returns: the implementation used by scan()
+//!************************************************************************
+FieldScanner::Implementation FieldScanner::bestImplementation()
+{
+    static const Implementation BEST = isSupported( IMPLEMENTATION_AVX2 ) ? IMPLEMENTATION_AVX2
+                                     : isSupported( IMPLEMENTATION_SSE2 ) ? IMPLEMENTATION_SSE2
+                                     : isSupported( IMPLEMENTATION_NEON ) ? IMPLEMENTATION_NEON
+                                     : IMPLEMENTATION_SCALAR;
+    return BEST;
+}
+
+//!************************************************************************
+//! Check whether an implementation was built in and runs on this CPU
+//!
+//! @returns: true if the implementation can be used
+//!************************************************************************
+bool FieldScanner::isSupported
+    (
+    const Implementation aImplementation    //!< implementation
+    )
+{
+    bool supported = false;
+
+    switch( aImplementation )
+    {
+        case IMPLEMENTATION_SCALAR:
+            supported = true;
+            break;
+
+        case IMPLEMENTATION_SSE2:
+#if defined( FIELD_SCANNER_SSE2 )
+            supported = true;
+#endif
+            break;
+
+        case IMPLEMENTATION_AVX2:
+#if defined( FIELD_SCANNER_AVX2 )
+            __builtin_cpu_init();
+            supported = __builtin_cpu_supports( "avx2" );
+#endif
+            break;
+
+        case IMPLEMENTATION_NEON:
+#if defined( FIELD_SCANNER_NEON )
+            supported = true;
+#endif
+            break;
+
+        default:
+            break;
+    }
+
+    return supported;
+}
+
+//!************************************************************************
+//! Find the delimiters of a reply with the fastest implementation
+//!
+//! @returns: nothing
+//!************************************************************************
+void FieldScanner::scan
+    (
+    const char*         aData,          //!< reply bytes
+    const int           aLength,        //!< reply length
+    std::vector<int>&   aFieldStart     //!< appended start offsets of the fields after the first
+    )
+{
+    scan( bestImplementation(), aData, aLength, aFieldStart );
+}
+
+//!************************************************************************
+//! Find the delimiters of a reply with a given implementation. Each
+//! delimiter appends the offset of the field following it.
+//!
+//! @returns: nothing
+//!************************************************************************
+void FieldScanner::scan
+    (
+    const Implementation    aImplementation,    //!< implementation to use, must be supported
+    const char*             aData,              //!< reply bytes
+    const int               aLength,            //!< reply length
+    std::vector<int>&       aFieldStart         //!< appended start offsets of the fields after the first
+    )
+{
+    switch( aImplementation )
+    {
+        case IMPLEMENTATION_SSE2:
+            scanSse2( aData, aLength, aFieldStart );
+            break;
+
+        case IMPLEMENTATION_AVX2:
+            scanAvx2( aData, aLength, aFieldStart );
+            break;
+
+        case IMPLEMENTATION_NEON:
+            scanNeon( aData, aLength, aFieldStart );
+            break;
+
+        default:
+            scanScalar( aData, 0, 0, aLength, aFieldStart );
+            break;
+    }
+}
+
+//!************************************************************************
+//! Find the delimiters byte by byte. Also used for the tail of the reply
+//! which is too short for a vector.
+//!
+//! @returns: nothing
+//!************************************************************************
+void FieldScanner::scanScalar
+    (
+    const char*         aData,          //!< reply bytes
+    const int           aBegin,         //!< first position to check
+    const int           aNext,          //!< first position allowed to start a delimiter
+    const int           aLength,        //!< reply length
+    std::vector<int>&   aFieldStart     //!< appended start offsets
+    )
+{
+    for( int i = ( aBegin > aNext ? aBegin : aNext ); i + 1 < aLength; i++ )
+    {
+        if( CgiPayload::FIELD_FILL == aData[i] && CgiPayload::FIELD_FILL == aData[i + 1] )
+        {
+            aFieldStart.push_back( i + 2 );
+            i++;
+        }
+    }
+}
+
+//!************************************************************************
+//! Find the delimiters 16 bytes at a time with SSE2
+//!
+//! @returns: nothing
+//!************************************************************************
+void FieldScanner::scanSse2
+    (
+    const char*         aData,          //!< reply bytes
+    const int           aLength,        //!< reply length
+    std::vector<int>&   aFieldStart     //!< appended start offsets
+    )
+{
+    int i = 0;
+    int next = 0;
+
+#if defined( FIELD_SCANNER_SSE2 )
+    const __m128i fill = _mm_set1_epi8( CgiPayload::FIELD_FILL );
+
+    // the block at i + 1 is loaded too, so that a '#' at the end of the
+    // block is paired with the first byte of the following one
+    for( ; i + 16 < aLength; i += 16 )
+    {
+        const __m128i current = _mm_loadu_si128( reinterpret_cast<const __m128i*>( aData + i ) );
+        const __m128i following = _mm_loadu_si128( reinterpret_cast<const __m128i*>( aData + i + 1 ) );
+        const __m128i pairs = _mm_and_si128( _mm_cmpeq_epi8( current, fill ), _mm_cmpeq_epi8( following, fill ) );
+        const uint64_t mask = static_cast<uint32_t>( _mm_movemask_epi8( pairs ) );
+
+        if( mask )
+        {
+            next = resolvePairs( mask, 1, i, next, aFieldStart );
+        }
+    }
+#endif
+
+    scanScalar( aData, i, next, aLength, aFieldStart );
+}
+
+//!************************************************************************
+//! Find the delimiters 32 bytes at a time with AVX2
+//!
+//! @returns: nothing
+//!************************************************************************
+#if defined( FIELD_SCANNER_AVX2 )
+__attribute__(( target( "avx2" ) ))
+#endif
+void FieldScanner::scanAvx2
+    (
+    const char*         aData,          //!< reply bytes
+    const int           aLength,        //!< reply length
+    std::vector<int>&   aFieldStart     //!< appended start offsets
+    )
+{
+    int i = 0;
+    int next = 0;
+
+#if defined( FIELD_SCANNER_AVX2 )
+    const __m256i fill = _mm256_set1_epi8( CgiPayload::FIELD_FILL );
+
+    for( ; i + 32 < aLength; i += 32 )
+    {
+        const __m256i current = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( aData + i ) );
+        const __m256i following = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( aData + i + 1 ) );
+        const __m256i pairs = _mm256_and_si256( _mm256_cmpeq_epi8( current, fill ), _mm256_cmpeq_epi8( following, fill ) );
+        const uint64_t mask = static_cast<uint32_t>( _mm256_movemask_epi8( pairs ) );
+
+        if( mask )
+        {
+            next = resolvePairs( mask, 1, i, next, aFieldStart );
+        }
+    }
+#endif
+
+    scanScalar( aData, i, next, aLength, aFieldStart );
+}
+
+//!************************************************************************
+//! Find the delimiters 16 bytes at a time with NEON
+//!
+//! @returns: nothing
+//!************************************************************************
+void FieldScanner::scanNeon
+    (
+    const char*         aData,          //!< reply bytes
+    const int           aLength,        //!< reply length
+    std::vector<int>&   aFieldStart     //!< appended start offsets
+    )
+{
+    int i = 0;
+    int next = 0;
+
+#if defined( FIELD_SCANNER_NEON )
+    const uint8x16_t fill = vdupq_n_u8( CgiPayload::FIELD_FILL );
+
+    for( ; i + 16 < aLength; i += 16 )
+    {
+        const uint8x16_t current = vld1q_u8( reinterpret_cast<const uint8_t*>( aData + i ) );
+        const uint8x16_t following = vld1q_u8( reinterpret_cast<const uint8_t*>( aData + i + 1 ) );
+        const uint8x16_t pairs = vandq_u8( vceqq_u8( current, fill ), vceqq_u8( following, fill ) );
+
+        // NEON has no movemask: narrowing each 16-bit lane by 4 bits packs
+        // the 16 byte results into 4 bits each of a 64-bit mask
+        const uint8x8_t narrowed = vshrn_n_u16( vreinterpretq_u16_u8( pairs ), 4 );
+        const uint64_t mask = vget_lane_u64( vreinterpret_u64_u8( narrowed ), 0 ) & 0x8888888888888888ULL;
+
+        if( mask )
+        {
+            next = resolvePairs( mask, 4, i, next, aFieldStart );
+        }
+    }
+#endif
+
+    scanScalar( aData, i, next, aLength, aFieldStart );
+}
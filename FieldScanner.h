@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+FieldScanner.h
+
+This file contains the definitions for the "##" delimiter scanner.
+*/
+
+#ifndef FieldScanner_h
+#define FieldScanner_h
+
+#include <vector>
+
+
+//************************************************************************
+// Class for finding the field delimiters of a CGI reply. Delimiters are
+// matched from left to right without overlap, so in a run of filling '#'
+// characters every second pair is a delimiter and an odd '#' is left at
+// the start of the next field.
+//
+// The reply is compared against '#' a whole vector at a time (AVX2 or
+// SSE2 on x86, NEON on ARM), and only the positions where two '#' follow
+// each other are then resolved one by one. The implementation is picked
+// once at run time from the CPU features.
+//************************************************************************
+class FieldScanner
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        enum Implementation
+        {
+            IMPLEMENTATION_SCALAR,      //!< portable byte by byte scan
+            IMPLEMENTATION_SSE2,        //!< 16 bytes per step, x86
+            IMPLEMENTATION_AVX2,        //!< 32 bytes per step, x86 with AVX2
+            IMPLEMENTATION_NEON,        //!< 16 bytes per step, ARM
+
+            IMPLEMENTATION_COUNT        //!< number of implementations
+        };
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        static Implementation bestImplementation();
+
+        static bool isSupported
+            (
+            const Implementation aImplementation    //!< implementation
+            );
+
+        static void scan
+            (
+            const char*         aData,          //!< reply bytes
+            const int           aLength,        //!< reply length
+            std::vector<int>&   aFieldStart     //!< appended start offsets of the fields after the first
+            );
+
+        static void scan
+            (
+            const Implementation    aImplementation,    //!< implementation to use, must be supported
+            const char*             aData,              //!< reply bytes
+            const int               aLength,            //!< reply length
+            std::vector<int>&       aFieldStart         //!< appended start offsets of the fields after the first
+            );
+
+    private:
+        static void scanScalar
+            (
+            const char*         aData,          //!< reply bytes
+            const int           aBegin,         //!< first position to check
+            const int           aNext,          //!< first position allowed to start a delimiter
+            const int           aLength,        //!< reply length
+            std::vector<int>&   aFieldStart     //!< appended start offsets
+            );
+
+        static void scanSse2
+            (
+            const char*         aData,          //!< reply bytes
+            const int           aLength,        //!< reply length
+            std::vector<int>&   aFieldStart     //!< appended start offsets
+            );
+
+        static void scanAvx2
+            (
+            const char*         aData,          //!< reply bytes
+            const int           aLength,        //!< reply length
+            std::vector<int>&   aFieldStart     //!< appended start offsets
+            );
+
+        static void scanNeon
+            (
+            const char*         aData,          //!< reply bytes
+            const int           aLength,        //!< reply length
+            std::vector<int>&   aFieldStart     //!< appended start offsets
+            );
+};
+
+#endif // FieldScanner_h
@@ -0,0 +1,109 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+FleetDialog.cpp
+
+This file contains the sources for the fleet overview window.
+*/
+
+#include "FleetDialog.h"
+
+#include <QComboBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QTableView>
+#include <QVBoxLayout>
+
+#include "FleetModel.h"
+
+
+const int FleetDialog::ROW_HEIGHT;
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+FleetDialog::FleetDialog
+    (
+    FleetModel* aModel,         //!< terminals shown
+    QWidget*    aParent         //!< a parent widget
+    )
+    : QDialog( aParent )
+    , mModel( aModel )
+    , mStateComboBox( new QComboBox( this ) )
+    , mBeamColorComboBox( new QComboBox( this ) )
+    , mTableView( new QTableView( this ) )
+{
+    setWindowTitle( "Fleet Overview" );
+
+    mStateComboBox->addItem( "All" );
+
+    for( int i = 0; i < MODEM_STATE_COUNT; i++ )
+    {
+        mStateComboBox->addItem( FleetModel::STATE_NAMES[i], i );
+    }
+
+    mBeamColorComboBox->addItem( "All" );
+
+    for( int i = 0; i < SATELLITE_STATUS_BEAM_COLOR_COUNT; i++ )
+    {
+        mBeamColorComboBox->addItem( FleetModel::BEAM_COLOR_NAMES[i], i );
+    }
+
+    connect( mStateComboBox, SIGNAL( currentIndexChanged( int ) ), this, SLOT( applyFilters() ) );
+    connect( mBeamColorComboBox, SIGNAL( currentIndexChanged( int ) ), this, SLOT( applyFilters() ) );
+
+    // the terminal order until a column is clicked
+    mTableView->setModel( aModel );
+    mTableView->horizontalHeader()->setSortIndicator( -1, Qt::AscendingOrder );
+    mTableView->setSortingEnabled( true );
+    mTableView->setWordWrap( false );
+    mTableView->setAlternatingRowColors( true );
+    mTableView->setSelectionBehavior( QTableView::SelectRows );
+    mTableView->verticalHeader()->setSectionResizeMode( QHeaderView::Fixed );
+    mTableView->verticalHeader()->setDefaultSectionSize( ROW_HEIGHT );
+    mTableView->horizontalHeader()->setStretchLastSection( true );
+
+    QHBoxLayout* filterLayout = new QHBoxLayout();
+    filterLayout->addWidget( new QLabel( "State:", this ) );
+    filterLayout->addWidget( mStateComboBox );
+    filterLayout->addWidget( new QLabel( "Beam color:", this ) );
+    filterLayout->addWidget( mBeamColorComboBox );
+    filterLayout->addStretch();
+
+    QVBoxLayout* layout = new QVBoxLayout( this );
+    layout->addLayout( filterLayout );
+    layout->addWidget( mTableView );
+
+    resize( 900, 500 );
+}
+
+//!************************************************************************
+//! Show only the terminals in the selected state and beam color
+//!
+//! @returns: nothing
+//!************************************************************************
+/* slot */ void FleetDialog::applyFilters()
+{
+    std::vector<QVariant> values( FLEET_COLUMN_COUNT );
+    values[FLEET_COLUMN_STATE] = mStateComboBox->currentData();
+    values[FLEET_COLUMN_BEAM_COLOR] = mBeamColorComboBox->currentData();
+
+    mModel->setFilters( values );
+}
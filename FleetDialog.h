@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+FleetDialog.h
+
+This file contains the definitions for the fleet overview window.
+*/
+
+#ifndef FleetDialog_h
+#define FleetDialog_h
+
+#include <QDialog>
+
+
+class FleetModel;
+class QComboBox;
+class QTableView;
+
+//************************************************************************
+// Class for the window listing the terminals of the fleet, sorted by a
+// click on a column and filtered by modem state and beam color. The rows
+// have a fixed height, so that the view lays out only the visible rows
+// however many terminals the model holds.
+//************************************************************************
+class FleetDialog : public QDialog
+{
+    Q_OBJECT
+
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    private:
+        static const int ROW_HEIGHT = 22;   //!< height of every row [px]
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        explicit FleetDialog
+            (
+            FleetModel* aModel,             //!< terminals shown
+            QWidget*    aParent = nullptr   //!< a parent widget
+            );
+
+    private slots:
+        void applyFilters();
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        FleetModel*             mModel;             //!< terminals shown
+
+        QComboBox*              mStateComboBox;     //!< modem state filter
+        QComboBox*              mBeamColorComboBox; //!< beam color filter
+        QTableView*             mTableView;         //!< table of the terminals
+};
+
+#endif // FleetDialog_h
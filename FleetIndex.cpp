@@ -0,0 +1,155 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+FleetIndex.cpp
+
+This file contains the sources for the ordered index of one column
+of the fleet overview.
+*/
+
+#include "FleetIndex.h"
+
+#include <math.h>
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+FleetIndex::FleetIndex()
+{
+}
+
+//!************************************************************************
+//! Add a terminal, with an unknown value
+//!
+//! @returns: the terminal index
+//!************************************************************************
+size_t FleetIndex::addTerminal()
+{
+    const size_t terminal = mValues.size();
+
+    mValues.push_back( NAN );
+    mUnknown.insert( terminal );
+
+    return terminal;
+}
+
+//!************************************************************************
+//! Get the terminals with a value, e.g. a modem state
+//!
+//! @returns: nothing
+//!************************************************************************
+void FleetIndex::equal
+    (
+    const double            aValue,         //!< value looked up
+    std::vector<size_t>&    aTerminals      //!< appended terminals with the value
+    ) const
+{
+    for( std::set<Entry>::const_iterator it = mKnown.lower_bound( Entry( aValue, 0 ) ); it != mKnown.end() && it->first == aValue; ++it )
+    {
+        aTerminals.push_back( it->second );
+    }
+}
+
+//!************************************************************************
+//! Get the terminals in the order of their values, the unknown ones last
+//!
+//! @returns: nothing
+//!************************************************************************
+void FleetIndex::ordered
+    (
+    const bool              aDescending,    //!< true for the highest values first
+    const size_t            aLimit,         //!< most terminals appended
+    std::vector<size_t>&    aTerminals      //!< appended terminals, in order
+    ) const
+{
+    size_t count = 0;
+
+    if( aDescending )
+    {
+        for( std::set<Entry>::const_reverse_iterator it = mKnown.rbegin(); it != mKnown.rend() && count < aLimit; ++it, count++ )
+        {
+            aTerminals.push_back( it->second );
+        }
+    }
+    else
+    {
+        for( std::set<Entry>::const_iterator it = mKnown.begin(); it != mKnown.end() && count < aLimit; ++it, count++ )
+        {
+            aTerminals.push_back( it->second );
+        }
+    }
+
+    for( std::set<size_t>::const_iterator it = mUnknown.begin(); it != mUnknown.end() && count < aLimit; ++it, count++ )
+    {
+        aTerminals.push_back( *it );
+    }
+}
+
+//!************************************************************************
+//! Move a terminal to its latest value
+//!
+//! @returns: true if the value changed
+//!************************************************************************
+bool FleetIndex::update
+    (
+    const size_t            aTerminal,      //!< terminal index
+    const double            aValue          //!< latest value, NaN if unknown
+    )
+{
+    const double previous = mValues[aTerminal];
+
+    if( previous == aValue || ( isnan( previous ) && isnan( aValue ) ) )
+    {
+        return false;
+    }
+
+    if( isnan( previous ) )
+    {
+        mUnknown.erase( aTerminal );
+    }
+    else
+    {
+        mKnown.erase( Entry( previous, aTerminal ) );
+    }
+
+    if( isnan( aValue ) )
+    {
+        mUnknown.insert( aTerminal );
+    }
+    else
+    {
+        mKnown.insert( Entry( aValue, aTerminal ) );
+    }
+
+    mValues[aTerminal] = aValue;
+    return true;
+}
+
+//!************************************************************************
+//! Get the value of a terminal
+//!
+//! @returns: the value, NaN if unknown
+//!************************************************************************
+double FleetIndex::value
+    (
+    const size_t            aTerminal       //!< terminal index
+    ) const
+{
+    return mValues[aTerminal];
+}
@@ -0,0 +1,91 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+FleetIndex.h
+
+This file contains the definitions for the ordered index of one column
+of the fleet overview.
+*/
+
+#ifndef FleetIndex_h
+#define FleetIndex_h
+
+#include <cstddef>
+#include <set>
+#include <utility>
+#include <vector>
+
+
+//************************************************************************
+// Class for keeping the terminals ordered by the value of one column as
+// the values change. An update moves one terminal in a balanced tree, in
+// O(log n), so the order is always ready: the first k terminals are read
+// in O(log n + k) and the terminals with a given value in O(log n + k),
+// in terminal order. Terminals whose value is unknown (NaN) are kept
+// apart and come last in both directions.
+//************************************************************************
+class FleetIndex
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    private:
+        typedef std::pair<double, size_t> Entry;    //!< value, terminal index
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        FleetIndex();
+
+        size_t addTerminal();
+
+        void equal
+            (
+            const double            aValue,         //!< value looked up
+            std::vector<size_t>&    aTerminals      //!< appended terminals with the value
+            ) const;
+
+        void ordered
+            (
+            const bool              aDescending,    //!< true for the highest values first
+            const size_t            aLimit,         //!< most terminals appended
+            std::vector<size_t>&    aTerminals      //!< appended terminals, in order
+            ) const;
+
+        bool update
+            (
+            const size_t            aTerminal,      //!< terminal index
+            const double            aValue          //!< latest value, NaN if unknown
+            );
+
+        double value
+            (
+            const size_t            aTerminal       //!< terminal index
+            ) const;
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        std::set<Entry>             mKnown;         //!< terminals with a value, by value
+        std::set<size_t>            mUnknown;       //!< terminals without a value
+        std::vector<double>         mValues;        //!< value of each terminal, NaN if unknown
+};
+
+#endif // FleetIndex_h
@@ -0,0 +1,668 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+FleetModel.cpp
+
+This file contains the sources for the table model of the fleet
+overview.
+*/
+
+#include "FleetModel.h"
+
+#include <algorithm>
+
+#include <QTimer>
+
+#include <math.h>
+
+
+const int FleetModel::FLUSH_MS;
+
+const char* const FleetModel::STATE_NAMES[MODEM_STATE_COUNT] =
+{
+    "unknown",                      // MODEM_STATE_UNKNOWN
+    "Scanning",                     // MODEM_STATE_SCANNING
+    "Ranging",                      // MODEM_STATE_RANGING
+    "Network entry",                // MODEM_STATE_NETWORK_ENTRY
+    "DHCP",                         // MODEM_STATE_DHCP
+    "Online"                        // MODEM_STATE_ONLINE
+};
+
+const char* const FleetModel::BEAM_COLOR_NAMES[SATELLITE_STATUS_BEAM_COLOR_COUNT] =
+{
+    "unknown",                      // SATELLITE_STATUS_BEAM_COLOR_UNKNOWN
+    "Blue",                         // SATELLITE_STATUS_BEAM_COLOR_BLUE
+    "Orange",                       // SATELLITE_STATUS_BEAM_COLOR_ORANGE
+    "Purple",                       // SATELLITE_STATUS_BEAM_COLOR_PURPLE
+    "Green"                         // SATELLITE_STATUS_BEAM_COLOR_GREEN
+};
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+FleetModel::FleetModel
+    (
+    QObject* aParent        //!< a parent object
+    )
+    : QAbstractTableModel( aParent )
+    , mSortColumn( -1 )
+    , mSortOrder( Qt::AscendingOrder )
+    , mOrdered( false )
+    , mOrderDirty( false )
+    , mDirtyFirst( 1 )
+    , mDirtyLast( 0 )
+    , mFlushTimer( new QTimer( this ) )
+{
+    for( int i = 0; i < FLEET_COLUMN_COUNT; i++ )
+    {
+        mFilters[i] = NAN;
+    }
+
+    mFlushTimer->setSingleShot( true );
+    mFlushTimer->setInterval( FLUSH_MS );
+    connect( mFlushTimer, SIGNAL( timeout() ), this, SLOT( flush() ) );
+}
+
+//!************************************************************************
+//! Add a terminal, with an empty snapshot
+//!
+//! @returns: the terminal index
+//!************************************************************************
+size_t FleetModel::addTerminal
+    (
+    const QString&          aName           //!< terminal name
+    )
+{
+    Row row;
+    row.Snapshot.Name = aName;
+    row.Snapshot.TimeMs = -1;
+    row.Snapshot.State = MODEM_STATE_UNKNOWN;
+    row.Snapshot.BeamColor = SATELLITE_STATUS_BEAM_COLOR_UNKNOWN;
+    row.Snapshot.RxSnrDb = NAN;
+    row.Snapshot.RxPwrDbm = NAN;
+    row.Snapshot.TemperatureC = NAN;
+    row.Snapshot.RxRateBps = NAN;
+    row.Snapshot.TxRateBps = NAN;
+    row.Snapshot.AlertCount = 0;
+
+    const size_t terminal = mRows.size();
+
+    // a sorted or filtered view cannot tell where the row goes before it is indexed
+    if( mOrdered )
+    {
+        beginResetModel();
+    }
+    else
+    {
+        beginInsertRows( QModelIndex(), static_cast<int>( terminal ), static_cast<int>( terminal ) );
+    }
+
+    mRows.push_back( row );
+
+    for( int i = FLEET_COLUMN_TERMINAL + 1; i < FLEET_COLUMN_COUNT; i++ )
+    {
+        mIndexes[i].addTerminal();
+        mIndexes[i].update( terminal, key( row, i ) );
+    }
+
+    if( mOrdered )
+    {
+        rebuildOrder( mOrder );
+        endResetModel();
+    }
+    else
+    {
+        endInsertRows();
+    }
+
+    return terminal;
+}
+
+//!************************************************************************
+//! Show the rows in a new order. The persistent indexes of the views,
+//! i.e. their selection and current cell, are moved along with their
+//! terminals; those of the terminals filtered out become invalid. A
+//! change of the row count resets the model instead.
+//!
+//! @returns: nothing
+//!************************************************************************
+void FleetModel::applyOrder
+    (
+    std::vector<size_t>&    aOrder,         //!< terminals of the rows, in view order, swapped in
+    const bool              aOrdered        //!< true if the rows are sorted or filtered
+    )
+{
+    const int rows = static_cast<int>( aOrdered ? aOrder.size() : mRows.size() );
+
+    if( rows != rowCount() )
+    {
+        beginResetModel();
+        mOrdered = aOrdered;
+        mOrder.swap( aOrder );
+        endResetModel();
+        return;
+    }
+
+    emit layoutAboutToBeChanged();
+
+    std::vector<int> newRow( mRows.size(), -1 );
+
+    for( int row = 0; row < rows; row++ )
+    {
+        newRow[aOrdered ? aOrder[row] : static_cast<size_t>( row )] = row;
+    }
+
+    const QModelIndexList from = persistentIndexList();
+    QModelIndexList to;
+
+    for( int i = 0; i < from.size(); i++ )
+    {
+        const int row = newRow[terminalAt( from.at( i ).row() )];
+        to.append( row >= 0 ? index( row, from.at( i ).column() ) : QModelIndex() );
+    }
+
+    changePersistentIndexList( from, to );
+
+    mOrdered = aOrdered;
+    mOrder.swap( aOrder );
+
+    emit layoutChanged();
+}
+
+//!************************************************************************
+//! Get the number of columns
+//!
+//! @returns: the number of columns
+//!************************************************************************
+int FleetModel::columnCount
+    (
+    const QModelIndex&      aParent         //!< parent index
+    ) const
+{
+    return aParent.isValid() ? 0 : FLEET_COLUMN_COUNT;
+}
+
+//!************************************************************************
+//! Get the data of a cell, formatted on request
+//!
+//! @returns: the data of the role, invalid if there is none
+//!************************************************************************
+QVariant FleetModel::data
+    (
+    const QModelIndex&      aIndex,         //!< cell
+    int                     aRole           //!< data role
+    ) const
+{
+    if( !aIndex.isValid() || aIndex.row() >= rowCount() )
+    {
+        return QVariant();
+    }
+
+    const Row& row = mRows[terminalAt( aIndex.row() )];
+    const FleetSnapshot& snapshot = row.Snapshot;
+
+    if( Qt::TextAlignmentRole == aRole )
+    {
+        return ( aIndex.column() >= FLEET_COLUMN_RX_SNR )
+               ? static_cast<int>( Qt::AlignRight | Qt::AlignVCenter )
+               : static_cast<int>( Qt::AlignLeft | Qt::AlignVCenter );
+    }
+
+    if( Qt::ForegroundRole == aRole )
+    {
+        return ( FLEET_COLUMN_ALERTS == aIndex.column() && snapshot.AlertCount > 0 ) ? QVariant( Qt::red ) : QVariant();
+    }
+
+    if( Qt::DisplayRole != aRole )
+    {
+        return QVariant();
+    }
+
+    switch( aIndex.column() )
+    {
+        case FLEET_COLUMN_TERMINAL:
+            return snapshot.Name;
+
+        case FLEET_COLUMN_STATE:
+            return QString( STATE_NAMES[snapshot.State] );
+
+        case FLEET_COLUMN_BEAM_COLOR:
+            return QString( BEAM_COLOR_NAMES[snapshot.BeamColor] );
+
+        case FLEET_COLUMN_RX_SNR:
+            return isnan( snapshot.RxSnrDb ) ? QString() : QString::number( snapshot.RxSnrDb, 'f', 1 ) + " dB";
+
+        case FLEET_COLUMN_RX_PWR:
+            return isnan( snapshot.RxPwrDbm ) ? QString() : QString::number( snapshot.RxPwrDbm, 'f', 1 ) + " dBm";
+
+        case FLEET_COLUMN_TEMPERATURE:
+            return isnan( snapshot.TemperatureC ) ? QString() : QString::number( snapshot.TemperatureC, 'f', 1 ) + " °C";
+
+        case FLEET_COLUMN_RX_RATE:
+            return formatRate( snapshot.RxRateBps );
+
+        case FLEET_COLUMN_TX_RATE:
+            return formatRate( snapshot.TxRateBps );
+
+        case FLEET_COLUMN_ALERTS:
+            return snapshot.AlertCount;
+
+        default:
+            return QVariant();
+    }
+}
+
+//!************************************************************************
+//! Get the filter of a column
+//!
+//! @returns: the value of the shown rows, invalid if not filtered
+//!************************************************************************
+QVariant FleetModel::filter
+    (
+    const FleetColumn       aColumn         //!< filtered column
+    ) const
+{
+    return isnan( mFilters[aColumn] ) ? QVariant() : QVariant( mFilters[aColumn] );
+}
+
+//!************************************************************************
+//! Announce the rows changed since the last flush. A change of a sort or
+//! filter value first moves the rows; the changed rows are then announced
+//! as one range, all rows when ordered. The view repaints only what is
+//! visible of it.
+//!
+//! @returns: nothing
+//!************************************************************************
+/* slot */ void FleetModel::flush()
+{
+    if( mDirtyFirst > mDirtyLast )
+    {
+        return;
+    }
+
+    if( mOrderDirty )
+    {
+        std::vector<size_t> order;
+        rebuildOrder( order );
+
+        if( order != mOrder )
+        {
+            applyOrder( order, mOrdered );
+        }
+
+        mOrderDirty = false;
+    }
+
+    const int first = mOrdered ? 0 : static_cast<int>( mDirtyFirst );
+    const int last = mOrdered ? rowCount() - 1 : static_cast<int>( mDirtyLast );
+
+    mDirtyFirst = 1;
+    mDirtyLast = 0;
+
+    if( first <= last )
+    {
+        emit dataChanged( index( first, 0 ), index( last, FLEET_COLUMN_COUNT - 1 ) );
+    }
+}
+
+//!************************************************************************
+//! Format a throughput
+//!
+//! @returns: the throughput with its unit, empty if unknown
+//!************************************************************************
+/* static */ QString FleetModel::formatRate
+    (
+    const double            aBitsPerSecond  //!< throughput [bit/s]
+    )
+{
+    if( isnan( aBitsPerSecond ) )
+    {
+        return QString();
+    }
+
+    if( aBitsPerSecond >= 1.e6 )
+    {
+        return QString::number( aBitsPerSecond / 1.e6, 'f', 2 ) + " Mbit/s";
+    }
+
+    if( aBitsPerSecond >= 1.e3 )
+    {
+        return QString::number( aBitsPerSecond / 1.e3, 'f', 1 ) + " kbit/s";
+    }
+
+    return QString::number( aBitsPerSecond, 'f', 0 ) + " bit/s";
+}
+
+//!************************************************************************
+//! Get the title of a column
+//!
+//! @returns: the title, or the row number for the vertical header
+//!************************************************************************
+QVariant FleetModel::headerData
+    (
+    int                     aSection,       //!< column or row
+    Qt::Orientation         aOrientation,   //!< header orientation
+    int                     aRole           //!< data role
+    ) const
+{
+    if( Qt::DisplayRole != aRole )
+    {
+        return QVariant();
+    }
+
+    if( Qt::Vertical == aOrientation )
+    {
+        return aSection + 1;
+    }
+
+    const char* const COLUMN_NAMES[FLEET_COLUMN_COUNT] = { "Terminal", "State", "Beam color", "Rx SNR", "Rx power", "Temperature", "Rx rate", "Tx rate", "Alerts" };
+
+    return ( aSection >= 0 && aSection < FLEET_COLUMN_COUNT ) ? QVariant( QString( COLUMN_NAMES[aSection] ) ) : QVariant();
+}
+
+//!************************************************************************
+//! Get the indexed value of a column
+//!
+//! @returns: the value, NaN if unknown
+//!************************************************************************
+/* static */ double FleetModel::key
+    (
+    const Row&              aRow,           //!< row
+    const int               aColumn         //!< indexed column
+    )
+{
+    const FleetSnapshot& snapshot = aRow.Snapshot;
+
+    switch( aColumn )
+    {
+        case FLEET_COLUMN_STATE:        return snapshot.State;
+        case FLEET_COLUMN_BEAM_COLOR:   return snapshot.BeamColor;
+        case FLEET_COLUMN_RX_SNR:       return snapshot.RxSnrDb;
+        case FLEET_COLUMN_RX_PWR:       return snapshot.RxPwrDbm;
+        case FLEET_COLUMN_TEMPERATURE:  return snapshot.TemperatureC;
+        case FLEET_COLUMN_RX_RATE:      return snapshot.RxRateBps;
+        case FLEET_COLUMN_TX_RATE:      return snapshot.TxRateBps;
+        case FLEET_COLUMN_ALERTS:       return snapshot.AlertCount;
+        default:                        return NAN;
+    }
+}
+
+//!************************************************************************
+//! Read the order of the rows off the indexes: the index of the sort
+//! column, else the terminals with the value of a filtered column, else
+//! the terminal order. The terminals failing another filter are dropped.
+//!
+//! @returns: nothing
+//!************************************************************************
+void FleetModel::rebuildOrder
+    (
+    std::vector<size_t>&    aOrder          //!< terminals of the rows, in view order
+    ) const
+{
+    aOrder.clear();
+
+    int filtered = -1;
+
+    for( int i = FLEET_COLUMN_TERMINAL + 1; i < FLEET_COLUMN_COUNT && filtered < 0; i++ )
+    {
+        if( !isnan( mFilters[i] ) )
+        {
+            filtered = i;
+        }
+    }
+
+    if( mSortColumn > FLEET_COLUMN_TERMINAL )
+    {
+        mIndexes[mSortColumn].ordered( Qt::DescendingOrder == mSortOrder, mRows.size(), aOrder );
+    }
+    else
+    {
+        if( filtered >= 0 )
+        {
+            mIndexes[filtered].equal( mFilters[filtered], aOrder );
+        }
+        else
+        {
+            for( size_t i = 0; i < mRows.size(); i++ )
+            {
+                aOrder.push_back( i );
+            }
+        }
+
+        if( FLEET_COLUMN_TERMINAL == mSortColumn && Qt::DescendingOrder == mSortOrder )
+        {
+            std::reverse( aOrder.begin(), aOrder.end() );
+        }
+    }
+
+    if( filtered < 0 )
+    {
+        return;
+    }
+
+    size_t kept = 0;
+
+    for( size_t i = 0; i < aOrder.size(); i++ )
+    {
+        bool shown = true;
+
+        for( int column = filtered; column < FLEET_COLUMN_COUNT && shown; column++ )
+        {
+            shown = isnan( mFilters[column] ) || mIndexes[column].value( aOrder[i] ) == mFilters[column];
+        }
+
+        if( shown )
+        {
+            aOrder[kept++] = aOrder[i];
+        }
+    }
+
+    aOrder.resize( kept );
+}
+
+//!************************************************************************
+//! Get the number of rows
+//!
+//! @returns: the number of terminals shown
+//!************************************************************************
+int FleetModel::rowCount
+    (
+    const QModelIndex&      aParent         //!< parent index
+    ) const
+{
+    if( aParent.isValid() )
+    {
+        return 0;
+    }
+
+    return static_cast<int>( mOrdered ? mOrder.size() : mRows.size() );
+}
+
+//!************************************************************************
+//! Show only the rows with a value in a column, e.g. a modem state or a
+//! beam color. The terminal name cannot be filtered.
+//!
+//! @returns: nothing
+//!************************************************************************
+void FleetModel::setFilter
+    (
+    const FleetColumn       aColumn,        //!< filtered column, e.g. the modem state
+    const QVariant&         aValue          //!< value of the shown rows, invalid to show all
+    )
+{
+    std::vector<QVariant> values;
+
+    for( int i = 0; i < FLEET_COLUMN_COUNT; i++ )
+    {
+        values.push_back( ( i == aColumn ) ? aValue : filter( static_cast<FleetColumn>( i ) ) );
+    }
+
+    setFilters( values );
+}
+
+//!************************************************************************
+//! Set the filters of all columns at once, so that the view is updated
+//! only once and keeps its selection on the rows still shown. The
+//! terminal name cannot be filtered.
+//!
+//! @returns: nothing
+//!************************************************************************
+void FleetModel::setFilters
+    (
+    const std::vector<QVariant>& aValues    //!< value of the shown rows per column, invalid to show all
+    )
+{
+    bool ordered = mSortColumn >= 0;
+
+    for( int i = FLEET_COLUMN_TERMINAL + 1; i < FLEET_COLUMN_COUNT; i++ )
+    {
+        mFilters[i] = ( static_cast<size_t>( i ) < aValues.size() && aValues[i].isValid() ) ? aValues[i].toDouble() : NAN;
+        ordered = ordered || !isnan( mFilters[i] );
+    }
+
+    std::vector<size_t> order;
+    rebuildOrder( order );
+    applyOrder( order, ordered );
+    mOrderDirty = false;
+}
+
+//!************************************************************************
+//! Get the latest snapshot of a terminal
+//!
+//! @returns: the snapshot
+//!************************************************************************
+const FleetSnapshot& FleetModel::snapshot
+    (
+    const size_t            aTerminal       //!< terminal index
+    ) const
+{
+    return mRows[aTerminal].Snapshot;
+}
+
+//!************************************************************************
+//! Sort the rows by a column. The order is read off the index of the
+//! column and follows its values from then on; the terminal name column
+//! sorts by terminal index.
+//!
+//! @returns: nothing
+//!************************************************************************
+void FleetModel::sort
+    (
+    int                     aColumn,        //!< sort column, -1 for the terminal order
+    Qt::SortOrder           aOrder          //!< sort order
+    )
+{
+    mSortColumn = ( aColumn >= 0 && aColumn < FLEET_COLUMN_COUNT ) ? aColumn : -1;
+    mSortOrder = aOrder;
+
+    bool ordered = mSortColumn >= 0;
+
+    for( int i = FLEET_COLUMN_TERMINAL + 1; i < FLEET_COLUMN_COUNT; i++ )
+    {
+        ordered = ordered || !isnan( mFilters[i] );
+    }
+
+    std::vector<size_t> order;
+    rebuildOrder( order );
+    applyOrder( order, ordered );
+    mOrderDirty = false;
+}
+
+//!************************************************************************
+//! Get the terminal shown in a row
+//!
+//! @returns: the terminal index
+//!************************************************************************
+size_t FleetModel::terminalAt
+    (
+    const int               aRow            //!< row of the view
+    ) const
+{
+    return mOrdered ? mOrder[aRow] : static_cast<size_t>( aRow );
+}
+
+//!************************************************************************
+//! Get the first terminals by the value of a column, e.g. the 50 worst
+//! SNRs, whatever the order of the view. Terminals with an unknown value
+//! come last.
+//!
+//! @returns: nothing
+//!************************************************************************
+void FleetModel::top
+    (
+    const FleetColumn       aColumn,        //!< ranked column
+    const Qt::SortOrder     aOrder,         //!< ascending for the lowest values first
+    const size_t            aCount,         //!< most terminals returned
+    std::vector<size_t>&    aTerminals      //!< terminals, in order
+    ) const
+{
+    aTerminals.clear();
+
+    if( FLEET_COLUMN_TERMINAL == aColumn )
+    {
+        for( size_t i = 0; i < mRows.size() && i < aCount; i++ )
+        {
+            aTerminals.push_back( Qt::DescendingOrder == aOrder ? mRows.size() - 1 - i : i );
+        }
+
+        return;
+    }
+
+    mIndexes[aColumn].ordered( Qt::DescendingOrder == aOrder, aCount, aTerminals );
+}
+
+//!************************************************************************
+//! Replace the snapshot of a terminal. The indexes follow the new values
+//! at once; the row is announced to the view at the next flush.
+//!
+//! @returns: nothing
+//!************************************************************************
+void FleetModel::update
+    (
+    const size_t            aTerminal,      //!< terminal index
+    const FleetSnapshot&    aSnapshot       //!< latest state
+    )
+{
+    Row& row = mRows[aTerminal];
+    row.Snapshot = aSnapshot;
+
+    for( int i = FLEET_COLUMN_TERMINAL + 1; i < FLEET_COLUMN_COUNT; i++ )
+    {
+        if( mIndexes[i].update( aTerminal, key( row, i ) ) && ( i == mSortColumn || !isnan( mFilters[i] ) ) )
+        {
+            mOrderDirty = true;
+        }
+    }
+
+    if( mDirtyFirst > mDirtyLast )
+    {
+        mDirtyFirst = aTerminal;
+        mDirtyLast = aTerminal;
+    }
+    else
+    {
+        mDirtyFirst = aTerminal < mDirtyFirst ? aTerminal : mDirtyFirst;
+        mDirtyLast = aTerminal > mDirtyLast ? aTerminal : mDirtyLast;
+    }
+
+    if( !mFlushTimer->isActive() )
+    {
+        mFlushTimer->start();
+    }
+}
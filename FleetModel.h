@@ -0,0 +1,233 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+FleetModel.h
+
+This file contains the definitions for the table model of the fleet
+overview.
+*/
+
+#ifndef FleetModel_h
+#define FleetModel_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <QAbstractTableModel>
+#include <QString>
+#include <QVariant>
+
+#include "FleetIndex.h"
+#include "SurfBeam2Types.h"
+
+
+class QTimer;
+
+enum FleetColumn
+{
+    FLEET_COLUMN_TERMINAL,          //!< terminal name
+    FLEET_COLUMN_STATE,             //!< modem state
+    FLEET_COLUMN_BEAM_COLOR,        //!< satellite beam color
+    FLEET_COLUMN_RX_SNR,            //!< Rx SNR [dB]
+    FLEET_COLUMN_RX_PWR,            //!< Rx power [dBm]
+    FLEET_COLUMN_TEMPERATURE,       //!< TRIA temperature [C]
+    FLEET_COLUMN_RX_RATE,           //!< Rx throughput [bit/s]
+    FLEET_COLUMN_TX_RATE,           //!< Tx throughput [bit/s]
+    FLEET_COLUMN_ALERTS,            //!< number of raised alerts
+
+    FLEET_COLUMN_COUNT              //!< number of defined columns
+};
+
+//************************************************************************
+// Latest state of one terminal
+//************************************************************************
+typedef struct
+{
+    QString                     Name;           //!< terminal name, e.g. its serial number
+    int64_t                     TimeMs;         //!< time of the reply, ms since epoch
+    ModemState                  State;          //!< modem state
+    SatelliteStatusBeamColor    BeamColor;      //!< satellite beam color
+    double                      RxSnrDb;        //!< Rx SNR [dB], NaN if unknown
+    double                      RxPwrDbm;       //!< Rx power [dBm], NaN if unknown
+    double                      TemperatureC;   //!< TRIA temperature [C], NaN if unknown
+    double                      RxRateBps;      //!< Rx throughput [bit/s], NaN if unknown
+    double                      TxRateBps;      //!< Tx throughput [bit/s], NaN if unknown
+    uint32_t                    AlertCount;     //!< number of raised alerts
+}FleetSnapshot;
+
+//************************************************************************
+// Class for showing the latest state of many terminals in a table view.
+// The rows are the snapshot array itself, indexed like the terminals of
+// the engines, and the cells are only formatted when the view asks for
+// them, i.e. for the visible rows. Updates only mark the rows changed;
+// the changed rows are announced together as one dataChanged range a
+// few times per second, however many terminals report in between.
+//
+// Every column but the terminal name has an ordered index, updated in
+// O(log n) with each snapshot, so sorting and filtering never sort the
+// rows: the visible order is read off the index of the sort column, or
+// of a filtered column, and only when one of their values has changed.
+//************************************************************************
+class FleetModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        static const int FLUSH_MS = 250;    //!< longest delay of an update on the view
+
+        static const char* const STATE_NAMES[MODEM_STATE_COUNT];                    //!< shown modem states
+        static const char* const BEAM_COLOR_NAMES[SATELLITE_STATUS_BEAM_COLOR_COUNT];   //!< shown beam colors
+
+    private:
+        typedef struct
+        {
+            FleetSnapshot           Snapshot;       //!< latest snapshot
+        }Row;
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        explicit FleetModel
+            (
+            QObject* aParent = nullptr      //!< a parent object
+            );
+
+        size_t addTerminal
+            (
+            const QString&          aName           //!< terminal name
+            );
+
+        int columnCount
+            (
+            const QModelIndex&      aParent = QModelIndex() //!< parent index
+            ) const override;
+
+        QVariant data
+            (
+            const QModelIndex&      aIndex,         //!< cell
+            int                     aRole = Qt::DisplayRole //!< data role
+            ) const override;
+
+        QVariant filter
+            (
+            const FleetColumn       aColumn         //!< filtered column
+            ) const;
+
+        static QString formatRate
+            (
+            const double            aBitsPerSecond  //!< throughput [bit/s]
+            );
+
+        QVariant headerData
+            (
+            int                     aSection,       //!< column or row
+            Qt::Orientation         aOrientation,   //!< header orientation
+            int                     aRole = Qt::DisplayRole //!< data role
+            ) const override;
+
+        int rowCount
+            (
+            const QModelIndex&      aParent = QModelIndex() //!< parent index
+            ) const override;
+
+        void setFilter
+            (
+            const FleetColumn       aColumn,        //!< filtered column, e.g. the modem state
+            const QVariant&         aValue          //!< value of the shown rows, invalid to show all
+            );
+
+        void setFilters
+            (
+            const std::vector<QVariant>& aValues    //!< value of the shown rows per column, invalid to show all
+            );
+
+        const FleetSnapshot& snapshot
+            (
+            const size_t            aTerminal       //!< terminal index
+            ) const;
+
+        void sort
+            (
+            int                     aColumn,        //!< sort column, -1 for the terminal order
+            Qt::SortOrder           aOrder = Qt::AscendingOrder //!< sort order
+            ) override;
+
+        size_t terminalAt
+            (
+            const int               aRow            //!< row of the view
+            ) const;
+
+        void top
+            (
+            const FleetColumn       aColumn,        //!< ranked column
+            const Qt::SortOrder     aOrder,         //!< ascending for the lowest values first
+            const size_t            aCount,         //!< most terminals returned
+            std::vector<size_t>&    aTerminals      //!< terminals, in order
+            ) const;
+
+        void update
+            (
+            const size_t            aTerminal,      //!< terminal index
+            const FleetSnapshot&    aSnapshot       //!< latest state
+            );
+
+    private:
+        void applyOrder
+            (
+            std::vector<size_t>&    aOrder,         //!< terminals of the rows, in view order, swapped in
+            const bool              aOrdered        //!< true if the rows are sorted or filtered
+            );
+
+        static double key
+            (
+            const Row&              aRow,           //!< row
+            const int               aColumn         //!< indexed column
+            );
+
+        void rebuildOrder
+            (
+            std::vector<size_t>&    aOrder          //!< terminals of the rows, in view order
+            ) const;
+
+    private slots:
+        void flush();
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        std::vector<Row>            mRows;          //!< one row per terminal
+        FleetIndex                  mIndexes[FLEET_COLUMN_COUNT];   //!< ordered index of each column, none for the terminal name
+
+        int                         mSortColumn;    //!< sort column, -1 for the terminal order
+        Qt::SortOrder               mSortOrder;     //!< sort order
+        double                      mFilters[FLEET_COLUMN_COUNT];   //!< value of the shown rows per column, NaN if not filtered
+        bool                        mOrdered;       //!< true if the rows are sorted or filtered
+        bool                        mOrderDirty;    //!< true if a sort or filter value changed since the last flush
+        std::vector<size_t>         mOrder;         //!< terminal of each row when ordered
+        size_t                      mDirtyFirst;    //!< first changed terminal, above the last one if none
+        size_t                      mDirtyLast;     //!< last changed terminal
+        QTimer*                     mFlushTimer;    //!< announces the changed rows
+};
+
+#endif // FleetModel_h
@@ -0,0 +1,190 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+HistoryQuery.cpp
+
+This file contains the sources for reading a metric of the rollup
+archive over a time range.
+*/
+
+#include "HistoryQuery.h"
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+HistoryQuery::HistoryQuery
+    (
+    const RollupArchive&    aArchive        //!< archive to read
+    )
+    : mArchive( aArchive )
+    , mTerminal( 0 )
+    , mMetric( METRIC_RX_SNR_DB )
+    , mLevel( ROLLUP_LEVEL_MINUTE )
+    , mStepMs( RollupEngine::LEVEL_MS[ROLLUP_LEVEL_MINUTE] )
+    , mIndex( 0 )
+    , mEnd( 0 )
+    , mPointMs( 0 )
+{
+    RollupEngine::clear( mAggregate );
+}
+
+//!************************************************************************
+//! Get the level read by the query
+//!
+//! @returns: the rollup level
+//!************************************************************************
+RollupLevel HistoryQuery::level() const
+{
+    return mLevel;
+}
+
+//!************************************************************************
+//! Get the coarsest level whose buckets are not longer than a resolution
+//!
+//! @returns: the level, minutes for resolutions finer than a minute
+//!************************************************************************
+/* static */ RollupLevel HistoryQuery::levelFor
+    (
+    const int64_t           aResolutionMs   //!< requested resolution
+    )
+{
+    RollupLevel level = ROLLUP_LEVEL_MINUTE;
+
+    for( int i = ROLLUP_LEVEL_MINUTE + 1; i < ROLLUP_LEVEL_COUNT; i++ )
+    {
+        if( RollupEngine::LEVEL_MS[i] <= aResolutionMs )
+        {
+            level = static_cast<RollupLevel>( i );
+        }
+    }
+
+    return level;
+}
+
+//!************************************************************************
+//! Find the first bucket starting at or after a time, by binary search
+//!
+//! @returns: the bucket index, the bucket count if there is none
+//!************************************************************************
+size_t HistoryQuery::lowerBound
+    (
+    const int64_t           aTimeMs         //!< time to seek
+    ) const
+{
+    size_t low = 0;
+    size_t high = mArchive.size( mTerminal, mLevel );
+
+    while( low < high )
+    {
+        const size_t middle = low + ( high - low ) / 2;
+
+        if( mArchive.at( mTerminal, mLevel, middle ).StartMs < aTimeMs )
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+//!************************************************************************
+//! Get the next point of the range. Buckets in which the metric was not
+//! reported are skipped, so points are missing rather than empty.
+//!
+//! @returns: true if a point was read, false at the end of the range
+//!************************************************************************
+bool HistoryQuery::next
+    (
+    HistoryPoint&           aPoint          //!< next point
+    )
+{
+    bool ready = false;
+
+    while( !ready && mIndex < mEnd )
+    {
+        const RollupBucket& bucket = mArchive.at( mTerminal, mLevel, mIndex );
+        const RollupAggregate& value = bucket.Values[mMetric];
+        const int64_t pointMs = bucket.StartMs - bucket.StartMs % mStepMs;
+
+        if( 0 == value.Count )
+        {
+            mIndex++;
+        }
+        else if( mAggregate.Count > 0 && pointMs != mPointMs )
+        {
+            // the bucket starts the next point, read it on the next call
+            ready = true;
+        }
+        else
+        {
+            mPointMs = pointMs;
+            RollupEngine::merge( mAggregate, value );
+            mIndex++;
+        }
+    }
+
+    if( 0 == mAggregate.Count )
+    {
+        return false;
+    }
+
+    aPoint.StartMs = mPointMs;
+    aPoint.DurationMs = mStepMs;
+    aPoint.Min = mAggregate.Min;
+    aPoint.Max = mAggregate.Max;
+    aPoint.Mean = RollupEngine::mean( mAggregate );
+    aPoint.Last = mAggregate.Last;
+    aPoint.Count = mAggregate.Count;
+
+    RollupEngine::clear( mAggregate );
+    return true;
+}
+
+//!************************************************************************
+//! Start a query. The range is widened to whole points of the
+//! resolution, which is rounded down to whole buckets of the level read.
+//!
+//! @returns: nothing
+//!************************************************************************
+void HistoryQuery::start
+    (
+    const size_t            aTerminal,      //!< terminal index
+    const Metric            aMetric,        //!< metric to read
+    const int64_t           aFromMs,        //!< start of the range, ms since epoch
+    const int64_t           aToMs,          //!< end of the range, excluded
+    const int64_t           aResolutionMs   //!< requested resolution
+    )
+{
+    mTerminal = aTerminal;
+    mMetric = aMetric;
+    mLevel = levelFor( aResolutionMs );
+
+    const int64_t levelMs = RollupEngine::LEVEL_MS[mLevel];
+    mStepMs = aResolutionMs > levelMs ? aResolutionMs - aResolutionMs % levelMs : levelMs;
+
+    mIndex = lowerBound( aFromMs - aFromMs % mStepMs );
+    mEnd = aToMs > aFromMs ? lowerBound( aToMs ) : mIndex;
+
+    mPointMs = 0;
+    RollupEngine::clear( mAggregate );
+}
@@ -0,0 +1,121 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+HistoryQuery.h
+
+This file contains the definitions for reading a metric of the rollup
+archive over a time range.
+*/
+
+#ifndef HistoryQuery_h
+#define HistoryQuery_h
+
+#include <cstddef>
+#include <cstdint>
+
+#include "RollupArchive.h"
+#include "RollupEngine.h"
+#include "SurfBeam2Types.h"
+
+
+//************************************************************************
+// Point of a history query
+//************************************************************************
+typedef struct
+{
+    int64_t                     StartMs;        //!< start of the point, ms since epoch
+    int64_t                     DurationMs;     //!< length of the point
+    double                      Min;            //!< lowest value
+    double                      Max;            //!< highest value
+    double                      Mean;           //!< mean value
+    double                      Last;           //!< latest value
+    uint32_t                    Count;          //!< number of samples
+}HistoryPoint;
+
+//************************************************************************
+// Class for reading one metric of one terminal between two times at a
+// requested resolution. The coarsest rollup level not coarser than the
+// resolution is read; its buckets are in time order, so the first one
+// of the range is found by a binary search, and the buckets are merged
+// into points of the resolution one at a time as the caller asks for
+// them, so the range is never copied.
+//
+//    HistoryQuery query( archive );
+//    query.start( terminal, METRIC_RX_SNR_DB, fromMs, toMs, 60000 );
+//
+//    HistoryPoint point;
+//
+//    while( query.next( point ) ) { ... }
+//************************************************************************
+class HistoryQuery
+{
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        explicit HistoryQuery
+            (
+            const RollupArchive&    aArchive        //!< archive to read
+            );
+
+        RollupLevel level() const;
+
+        static RollupLevel levelFor
+            (
+            const int64_t           aResolutionMs   //!< requested resolution
+            );
+
+        bool next
+            (
+            HistoryPoint&           aPoint          //!< next point
+            );
+
+        void start
+            (
+            const size_t            aTerminal,      //!< terminal index
+            const Metric            aMetric,        //!< metric to read
+            const int64_t           aFromMs,        //!< start of the range, ms since epoch
+            const int64_t           aToMs,          //!< end of the range, excluded
+            const int64_t           aResolutionMs   //!< requested resolution
+            );
+
+    private:
+        size_t lowerBound
+            (
+            const int64_t           aTimeMs         //!< time to seek
+            ) const;
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        const RollupArchive&        mArchive;       //!< archive read
+
+        size_t                      mTerminal;      //!< terminal index
+        Metric                      mMetric;        //!< metric read
+        RollupLevel                 mLevel;         //!< level read
+        int64_t                     mStepMs;        //!< length of the points
+
+        size_t                      mIndex;         //!< next bucket to read
+        size_t                      mEnd;           //!< first bucket past the range
+
+        int64_t                     mPointMs;       //!< start of the point being merged
+        RollupAggregate             mAggregate;     //!< point being merged, count 0 if none
+};
+
+#endif // HistoryQuery_h
@@ -0,0 +1,397 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+IngestEngine.cpp
+
+This file contains the sources for the parallel replay of archived payload
+captures.
+*/
+
+#include "IngestEngine.h"
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include <stdlib.h>
+
+
+const int64_t IngestEngine::CHUNK_SIZE;
+
+
+//************************************************************************
+// Replies of one terminal read from a chunk, before decoding
+//************************************************************************
+typedef struct
+{
+    std::vector<int64_t>        ModemTimeMs;
+    std::vector<QByteArray>     ModemReplies;
+    std::vector<int64_t>        TriaTimeMs;
+    std::vector<QByteArray>     TriaReplies;
+}ReplyGroup;
+
+//************************************************************************
+// Column operation appending the source column to the destination
+//************************************************************************
+struct AppendColumn
+{
+    template<typename T>
+    void operator()( std::vector<T>& aDst, const std::vector<T>& aSrc ) const
+    {
+        aDst.insert( aDst.end(), aSrc.begin(), aSrc.end() );
+    }
+};
+
+//************************************************************************
+// Column operation reordering the destination column
+//************************************************************************
+struct PermuteColumn
+{
+    const std::vector<size_t>& Order;   //!< source index of each element
+
+    template<typename T>
+    void operator()( std::vector<T>& aDst, const std::vector<T>& ) const
+    {
+        std::vector<T> permuted( Order.size() );
+
+        for( size_t i = 0; i < Order.size(); i++ )
+        {
+            permuted[i] = aDst[Order[i]];
+        }
+
+        aDst.swap( permuted );
+    }
+};
+
+//!************************************************************************
+//! Apply an operation to each modem column
+//!
+//! @returns: nothing
+//!************************************************************************
+template<typename Op>
+static void forEachColumn
+    (
+    ModemColumns&       aDst,   //!< destination columns
+    const ModemColumns& aSrc,   //!< source columns
+    const Op&           aOp     //!< column operation
+    )
+{
+    aOp( aDst.Valid, aSrc.Valid );
+    aOp( aDst.TxPackets, aSrc.TxPackets );
+    aOp( aDst.TxBytes, aSrc.TxBytes );
+    aOp( aDst.RxPackets, aSrc.RxPackets );
+    aOp( aDst.RxBytes, aSrc.RxBytes );
+    aOp( aDst.OnlineTimeSeconds, aSrc.OnlineTimeSeconds );
+    aOp( aDst.LossOfSyncCount, aSrc.LossOfSyncCount );
+    aOp( aDst.RxSnrDb, aSrc.RxSnrDb );
+    aOp( aDst.RxSnrPercent, aSrc.RxSnrPercent );
+    aOp( aDst.RxPwrDbm, aSrc.RxPwrDbm );
+    aOp( aDst.RxPwrPercent, aSrc.RxPwrPercent );
+    aOp( aDst.CableResistanceOhm, aSrc.CableResistanceOhm );
+    aOp( aDst.CableResistancePercent, aSrc.CableResistancePercent );
+    aOp( aDst.CableAttenuationDb, aSrc.CableAttenuationDb );
+    aOp( aDst.CableAttenuationPercent, aSrc.CableAttenuationPercent );
+    aOp( aDst.ModemStatus, aSrc.ModemStatus );
+    aOp( aDst.SatStatusBeamColor, aSrc.SatStatusBeamColor );
+    aOp( aDst.UplinkSymbolRate, aSrc.UplinkSymbolRate );
+    aOp( aDst.DownlinkSymbolRate, aSrc.DownlinkSymbolRate );
+}
+
+//!************************************************************************
+//! Apply an operation to each TRIA column
+//!
+//! @returns: nothing
+//!************************************************************************
+template<typename Op>
+static void forEachColumn
+    (
+    TriaColumns&        aDst,   //!< destination columns
+    const TriaColumns&  aSrc,   //!< source columns
+    const Op&           aOp     //!< column operation
+    )
+{
+    aOp( aDst.Valid, aSrc.Valid );
+    aOp( aDst.TxIfPwrDbm, aSrc.TxIfPwrDbm );
+    aOp( aDst.TemperatureCelsius, aSrc.TemperatureCelsius );
+    aOp( aDst.TxRfPwrDbm, aSrc.TxRfPwrDbm );
+    aOp( aDst.TxIfPwrPercent, aSrc.TxIfPwrPercent );
+    aOp( aDst.TxRfPwrPercent, aSrc.TxRfPwrPercent );
+    aOp( aDst.SatStatusBeamColor, aSrc.SatStatusBeamColor );
+    aOp( aDst.Polarization, aSrc.Polarization );
+}
+
+//!************************************************************************
+//! Put columns in time order, if the chunks were not already in order
+//!
+//! @returns: nothing
+//!************************************************************************
+template<typename Columns>
+static void sortByTime
+    (
+    std::vector<int64_t>&   aTimeMs,    //!< time of each element
+    Columns&                aColumns    //!< columns to reorder alongside
+    )
+{
+    if( std::is_sorted( aTimeMs.begin(), aTimeMs.end() ) )
+    {
+        return;
+    }
+
+    std::vector<size_t> order( aTimeMs.size() );
+
+    for( size_t i = 0; i < order.size(); i++ )
+    {
+        order[i] = i;
+    }
+
+    std::stable_sort( order.begin(), order.end(), [&aTimeMs]( size_t a, size_t b ){ return aTimeMs[a] < aTimeMs[b]; } );
+
+    const PermuteColumn permute = { order };
+    permute( aTimeMs, aTimeMs );
+    forEachColumn( aColumns, aColumns, permute );
+}
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+IngestEngine::IngestEngine
+    (
+    const unsigned aThreadCount     //!< number of threads, 0 for one per core
+    )
+    : mThreadCount( aThreadCount )
+{
+}
+
+//!************************************************************************
+//! Add a capture file. Files holding the same terminals should be added
+//! in time order, which saves the final sort.
+//!
+//! @returns: nothing
+//!************************************************************************
+void IngestEngine::addFile
+    (
+    const std::string& aPath    //!< capture file
+    )
+{
+    mFiles.push_back( aPath );
+}
+
+//!************************************************************************
+//! Read and decode the lines starting in one chunk of a capture file
+//!
+//! @returns: nothing
+//!************************************************************************
+void IngestEngine::decodeChunk
+    (
+    const size_t aChunk     //!< chunk index
+    )
+{
+    const Chunk& chunk = mChunks[aChunk];
+    std::ifstream file( mFiles[chunk.File].c_str(), std::ios::binary );
+    std::string line;
+    int64_t position = chunk.Begin;
+
+    // the line running into the chunk belongs to the previous chunk
+    if( chunk.Begin > 0 )
+    {
+        file.seekg( chunk.Begin - 1 );
+        std::getline( file, line );
+        position = chunk.Begin + static_cast<int64_t>( line.size() );
+    }
+
+    std::map<std::string, ReplyGroup> groups;
+    size_t malformed = 0;
+
+    while( position < chunk.End && std::getline( file, line ) )
+    {
+        position += static_cast<int64_t>( line.size() ) + 1;
+
+        if( !line.empty() && '\r' == line[line.size() - 1] )
+        {
+            line.resize( line.size() - 1 );
+        }
+
+        const size_t timeEnd = line.find( '\t' );
+        const size_t terminalEnd = ( std::string::npos == timeEnd ) ? std::string::npos : line.find( '\t', timeEnd + 1 );
+        const size_t kindEnd = ( std::string::npos == terminalEnd ) ? std::string::npos : line.find( '\t', terminalEnd + 1 );
+
+        if( std::string::npos == kindEnd || kindEnd != terminalEnd + 2 )
+        {
+            malformed += line.empty() ? 0 : 1;
+            continue;
+        }
+
+        char* parsedEnd = nullptr;
+        const int64_t timeMs = strtoll( line.c_str(), &parsedEnd, 10 );
+
+        if( parsedEnd != line.c_str() + timeEnd )
+        {
+            malformed++;
+            continue;
+        }
+
+        ReplyGroup& group = groups[line.substr( timeEnd + 1, terminalEnd - timeEnd - 1 )];
+        const QByteArray reply( line.data() + kindEnd + 1, static_cast<int>( line.size() - kindEnd - 1 ) );
+
+        switch( line[terminalEnd + 1] )
+        {
+            case 'M':
+                group.ModemTimeMs.push_back( timeMs );
+                group.ModemReplies.push_back( reply );
+                break;
+
+            case 'T':
+                group.TriaTimeMs.push_back( timeMs );
+                group.TriaReplies.push_back( reply );
+                break;
+
+            default:
+                malformed++;
+                break;
+        }
+    }
+
+    BatchDecoder decoder;
+    SeriesMap& series = mChunkSeries[aChunk];
+
+    for( std::map<std::string, ReplyGroup>::const_iterator it = groups.begin(); it != groups.end(); ++it )
+    {
+        const ReplyGroup& group = it->second;
+        TerminalSeries& terminal = series[it->first];
+
+        terminal.ModemTimeMs = group.ModemTimeMs;
+        terminal.TriaTimeMs = group.TriaTimeMs;
+        decoder.decodeModem( group.ModemReplies.data(), group.ModemReplies.size(), terminal.Modem );
+        decoder.decodeTria( group.TriaReplies.data(), group.TriaReplies.size(), terminal.Tria );
+    }
+
+    mChunkMalformed[aChunk] = malformed;
+}
+
+//!************************************************************************
+//! Get the number of lines that could not be read in the last run
+//!
+//! @returns: the number of malformed lines
+//!************************************************************************
+size_t IngestEngine::malformedLineCount() const
+{
+    size_t count = 0;
+
+    for( size_t i = 0; i < mChunkMalformed.size(); i++ )
+    {
+        count += mChunkMalformed[i];
+    }
+
+    return count;
+}
+
+//!************************************************************************
+//! Concatenate the chunk results of one terminal, in chunk order, and
+//! sort them by time if needed
+//!
+//! @returns: nothing
+//!************************************************************************
+void IngestEngine::mergeTerminal
+    (
+    const std::string& aTerminal    //!< terminal ID
+    )
+{
+    TerminalSeries& merged = mSeries.find( aTerminal )->second;
+    const AppendColumn append = AppendColumn();
+
+    for( size_t i = 0; i < mChunkSeries.size(); i++ )
+    {
+        const SeriesMap::const_iterator it = mChunkSeries[i].find( aTerminal );
+
+        if( mChunkSeries[i].end() != it )
+        {
+            append( merged.ModemTimeMs, it->second.ModemTimeMs );
+            forEachColumn( merged.Modem, it->second.Modem, append );
+            append( merged.TriaTimeMs, it->second.TriaTimeMs );
+            forEachColumn( merged.Tria, it->second.Tria, append );
+        }
+    }
+
+    sortByTime( merged.ModemTimeMs, merged.Modem );
+    sortByTime( merged.TriaTimeMs, merged.Tria );
+}
+
+//!************************************************************************
+//! Decode all added capture files. Blocks until the series are complete.
+//!
+//! @returns: nothing
+//!************************************************************************
+void IngestEngine::run()
+{
+    mChunks.clear();
+    mSeries.clear();
+
+    for( size_t i = 0; i < mFiles.size(); i++ )
+    {
+        std::ifstream file( mFiles[i].c_str(), std::ios::binary | std::ios::ate );
+        const int64_t size = file ? static_cast<int64_t>( file.tellg() ) : 0;
+
+        for( int64_t begin = 0; begin < size; begin += CHUNK_SIZE )
+        {
+            const Chunk chunk = { i, begin, ( size - begin > CHUNK_SIZE ) ? begin + CHUNK_SIZE : size };
+            mChunks.push_back( chunk );
+        }
+    }
+
+    mChunkSeries.assign( mChunks.size(), SeriesMap() );
+    mChunkMalformed.assign( mChunks.size(), 0 );
+
+    WorkStealingPool pool( mThreadCount );
+
+    for( size_t i = 0; i < mChunks.size(); i++ )
+    {
+        pool.submit( std::bind( &IngestEngine::decodeChunk, this, i ) );
+    }
+
+    pool.wait();
+
+    // the terminals are created up front, so that the merge tasks only
+    // ever look up the map
+    for( size_t i = 0; i < mChunkSeries.size(); i++ )
+    {
+        for( SeriesMap::const_iterator it = mChunkSeries[i].begin(); it != mChunkSeries[i].end(); ++it )
+        {
+            mSeries[it->first];
+        }
+    }
+
+    for( SeriesMap::const_iterator it = mSeries.begin(); it != mSeries.end(); ++it )
+    {
+        pool.submit( std::bind( &IngestEngine::mergeTerminal, this, it->first ) );
+    }
+
+    pool.wait();
+
+    mChunkSeries.clear();
+}
+
+//!************************************************************************
+//! Get the decoded series of the last run
+//!
+//! @returns: the series of each terminal, by terminal ID
+//!************************************************************************
+const IngestEngine::SeriesMap& IngestEngine::series() const
+{
+    return mSeries;
+}
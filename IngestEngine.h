@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+IngestEngine.h
+
+This file contains the definitions for the parallel replay of archived
+payload captures.
+
+A capture file holds one reply per line, with tab separated columns:
+
+    <time in ms since epoch> <terminal ID> <M for modem, T for TRIA> <raw reply>
+*/
+
+#ifndef IngestEngine_h
+#define IngestEngine_h
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "BatchDecoder.h"
+
+
+//************************************************************************
+// Decoded history of one terminal, in time order
+//************************************************************************
+typedef struct
+{
+    std::vector<int64_t>        ModemTimeMs;    //!< time of each modem reply
+    ModemColumns                Modem;          //!< decoded modem replies
+    std::vector<int64_t>        TriaTimeMs;     //!< time of each TRIA reply
+    TriaColumns                 Tria;           //!< decoded TRIA replies
+}TerminalSeries;
+
+//************************************************************************
+// Class for decoding many capture files in parallel. The files are cut
+// into chunks of whole lines, i.e. time ranges of the terminals they
+// hold, and each chunk is decoded on a work-stealing thread pool. The
+// chunk results are then merged per terminal, again in parallel, into
+// time-ordered series.
+//************************************************************************
+class IngestEngine
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        typedef std::map<std::string, TerminalSeries> SeriesMap;
+
+    private:
+        static const int64_t CHUNK_SIZE = 4 * 1024 * 1024;     //!< bytes per decoding task
+
+        typedef struct
+        {
+            size_t                      File;       //!< index of the capture file
+            int64_t                     Begin;      //!< offset of the first line starting in the chunk
+            int64_t                     End;        //!< offset after the last line starting in the chunk
+        }Chunk;
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        explicit IngestEngine
+            (
+            const unsigned aThreadCount = 0     //!< number of threads, 0 for one per core
+            );
+
+        void addFile
+            (
+            const std::string& aPath            //!< capture file
+            );
+
+        size_t malformedLineCount() const;
+
+        void run();
+
+        const SeriesMap& series() const;
+
+    private:
+        void decodeChunk
+            (
+            const size_t aChunk                 //!< chunk index
+            );
+
+        void mergeTerminal
+            (
+            const std::string& aTerminal        //!< terminal ID
+            );
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        unsigned                    mThreadCount;       //!< number of threads
+        std::vector<std::string>    mFiles;             //!< capture files, in time order
+        std::vector<Chunk>          mChunks;            //!< decoding tasks
+        std::vector<SeriesMap>      mChunkSeries;       //!< per chunk results
+        std::vector<size_t>         mChunkMalformed;    //!< per chunk number of unreadable lines
+        SeriesMap                   mSeries;            //!< merged results
+};
+
+#endif // IngestEngine_h
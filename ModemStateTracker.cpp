@@ -0,0 +1,249 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+ModemStateTracker.cpp
+
+This file contains the sources for the tracking of the modem state
+transitions.
+*/
+
+#include "ModemStateTracker.h"
+
+#include <algorithm>
+
+
+const int64_t ModemStateTracker::MAX_SAMPLE_GAP_MS;
+const int64_t ModemStateTracker::ONE_DAY_MS;
+
+
+//!************************************************************************
+//! Add the time since the last sample to the totals of the current state,
+//! split at the day boundaries
+//!
+//! @returns: nothing
+//!************************************************************************
+void ModemStateTracker::accumulate
+    (
+    Terminal&       aTerminal,  //!< terminal
+    const int64_t   aTimeMs     //!< time of the new sample
+    )
+{
+    if( aTerminal.LastSampleMs < 0 )
+    {
+        return;
+    }
+
+    const int64_t elapsedMs = aTimeMs - aTerminal.LastSampleMs;
+
+    // a gap, e.g. the monitor was not running, or the clock stepped back
+    if( elapsedMs <= 0 || elapsedMs > MAX_SAMPLE_GAP_MS )
+    {
+        return;
+    }
+
+    aTerminal.TimeInStateMs[aTerminal.State] += elapsedMs;
+
+    const bool online = MODEM_STATE_ONLINE == aTerminal.State;
+    int64_t beginMs = aTerminal.LastSampleMs;
+
+    while( beginMs < aTimeMs )
+    {
+        const int64_t day = beginMs / ONE_DAY_MS;
+        const int64_t endMs = std::min( aTimeMs, ( day + 1 ) * ONE_DAY_MS );
+
+        if( aTerminal.Days.empty() || aTerminal.Days.back().Day != day )
+        {
+            DailyAvailability entry;
+            entry.Day = day;
+            entry.OnlineMs = 0;
+            entry.ObservedMs = 0;
+            aTerminal.Days.push_back( entry );
+        }
+
+        DailyAvailability& entry = aTerminal.Days.back();
+        entry.ObservedMs += endMs - beginMs;
+
+        if( online )
+        {
+            entry.OnlineMs += endMs - beginMs;
+        }
+
+        beginMs = endMs;
+    }
+}
+
+//!************************************************************************
+//! Add a terminal, with no samples yet
+//!
+//! @returns: the terminal index
+//!************************************************************************
+size_t ModemStateTracker::addTerminal()
+{
+    Terminal terminal;
+    terminal.State = MODEM_STATE_UNKNOWN;
+    terminal.LastSampleMs = -1;
+    terminal.OutageSinceMs = -1;
+
+    for( int i = 0; i < MODEM_STATE_COUNT; i++ )
+    {
+        terminal.TimeInStateMs[i] = 0;
+    }
+
+    mTerminals.push_back( terminal );
+    return mTerminals.size() - 1;
+}
+
+//!************************************************************************
+//! Get the online share of the observed time of a day
+//!
+//! @returns: the availability in 0..1, or 0 if the day was not observed
+//!************************************************************************
+double ModemStateTracker::availability
+    (
+    const size_t    aTerminal,  //!< terminal index
+    const int64_t   aDay        //!< days since epoch
+    ) const
+{
+    const std::vector<DailyAvailability>& terminalDays = mTerminals[aTerminal].Days;
+
+    for( size_t i = terminalDays.size(); i > 0; i-- )
+    {
+        const DailyAvailability& entry = terminalDays[i - 1];
+
+        if( entry.Day == aDay )
+        {
+            return entry.ObservedMs > 0 ? static_cast<double>( entry.OnlineMs ) / entry.ObservedMs : 0.0;
+        }
+
+        if( entry.Day < aDay )
+        {
+            break;
+        }
+    }
+
+    return 0.0;
+}
+
+//!************************************************************************
+//! Get the daily availability of a terminal
+//!
+//! @returns: the online and observed time of each day with samples
+//!************************************************************************
+const std::vector<DailyAvailability>& ModemStateTracker::days
+    (
+    const size_t    aTerminal   //!< terminal index
+    ) const
+{
+    return mTerminals[aTerminal].Days;
+}
+
+//!************************************************************************
+//! Get the re-acquisition times of a terminal, i.e. the time from leaving
+//! the online state to entering it again
+//!
+//! @returns: the duration of each outage, in ms
+//!************************************************************************
+const std::vector<int64_t>& ModemStateTracker::reacquisitionTimes
+    (
+    const size_t    aTerminal   //!< terminal index
+    ) const
+{
+    return mTerminals[aTerminal].ReacquisitionMs;
+}
+
+//!************************************************************************
+//! Get the state of the last sample of a terminal
+//!
+//! @returns: the modem state
+//!************************************************************************
+ModemState ModemStateTracker::state
+    (
+    const size_t    aTerminal   //!< terminal index
+    ) const
+{
+    return mTerminals[aTerminal].State;
+}
+
+//!************************************************************************
+//! Get the total time a terminal spent in a state
+//!
+//! @returns: the time in ms
+//!************************************************************************
+int64_t ModemStateTracker::timeInState
+    (
+    const size_t        aTerminal,  //!< terminal index
+    const ModemState    aState      //!< modem state
+    ) const
+{
+    return mTerminals[aTerminal].TimeInStateMs[aState];
+}
+
+//!************************************************************************
+//! Get the state transitions of a terminal
+//!
+//! @returns: the transitions, in time order
+//!************************************************************************
+const std::vector<StateTransition>& ModemStateTracker::transitions
+    (
+    const size_t    aTerminal   //!< terminal index
+    ) const
+{
+    return mTerminals[aTerminal].Transitions;
+}
+
+//!************************************************************************
+//! Account a sample of a terminal
+//!
+//! @returns: true if the modem state changed
+//!************************************************************************
+bool ModemStateTracker::update
+    (
+    const size_t        aTerminal,  //!< terminal index
+    const int64_t       aTimeMs,    //!< time of the sample, ms since epoch
+    const ModemState    aState      //!< decoded modem state
+    )
+{
+    Terminal& terminal = mTerminals[aTerminal];
+
+    accumulate( terminal, aTimeMs );
+    terminal.LastSampleMs = aTimeMs;
+
+    if( aState == terminal.State )
+    {
+        return false;
+    }
+
+    StateTransition transition;
+    transition.TimeMs = aTimeMs;
+    transition.From = static_cast<uint8_t>( terminal.State );
+    transition.To = static_cast<uint8_t>( aState );
+    terminal.Transitions.push_back( transition );
+
+    if( MODEM_STATE_ONLINE == terminal.State )
+    {
+        terminal.OutageSinceMs = aTimeMs;
+    }
+    else if( MODEM_STATE_ONLINE == aState && terminal.OutageSinceMs >= 0 )
+    {
+        terminal.ReacquisitionMs.push_back( aTimeMs - terminal.OutageSinceMs );
+        terminal.OutageSinceMs = -1;
+    }
+
+    terminal.State = aState;
+    return true;
+}
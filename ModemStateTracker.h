@@ -0,0 +1,140 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+ModemStateTracker.h
+
+This file contains the definitions for the tracking of the modem state
+transitions.
+*/
+
+#ifndef ModemStateTracker_h
+#define ModemStateTracker_h
+
+#include <cstdint>
+#include <vector>
+
+#include "SurfBeam2Types.h"
+
+
+//************************************************************************
+// Change of the modem state
+//************************************************************************
+typedef struct
+{
+    int64_t                     TimeMs;         //!< time of the first sample in the new state
+    uint8_t                     From;           //!< ModemState before
+    uint8_t                     To;             //!< ModemState after
+}StateTransition;
+
+//************************************************************************
+// Online time of one UTC day
+//************************************************************************
+typedef struct
+{
+    int64_t                     Day;            //!< days since epoch
+    int64_t                     OnlineMs;       //!< time online
+    int64_t                     ObservedMs;     //!< time covered by samples
+}DailyAvailability;
+
+//************************************************************************
+// Class for tracking the modem state of many terminals. A sample in the
+// same state only adds the elapsed time to the running totals; the
+// transitions, the re-acquisition times after outages and the daily
+// availability are stored per terminal as they happen.
+//************************************************************************
+class ModemStateTracker
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        static const int64_t MAX_SAMPLE_GAP_MS = 60000;     //!< longer gaps between samples are not counted
+        static const int64_t ONE_DAY_MS = 86400000;         //!< ms in one day
+
+    private:
+        typedef struct
+        {
+            ModemState                      State;                              //!< state of the last sample
+            int64_t                         LastSampleMs;                       //!< time of the last sample, -1 if none
+            int64_t                         OutageSinceMs;                      //!< time the modem left the online state, -1 if online or never online
+            int64_t                         TimeInStateMs[MODEM_STATE_COUNT];   //!< total time spent in each state
+            std::vector<StateTransition>    Transitions;                        //!< state changes, in time order
+            std::vector<int64_t>            ReacquisitionMs;                    //!< duration of each outage, in time order
+            std::vector<DailyAvailability>  Days;                               //!< availability, in day order
+        }Terminal;
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        size_t addTerminal();
+
+        double availability
+            (
+            const size_t    aTerminal,  //!< terminal index
+            const int64_t   aDay        //!< days since epoch
+            ) const;
+
+        const std::vector<DailyAvailability>& days
+            (
+            const size_t    aTerminal   //!< terminal index
+            ) const;
+
+        const std::vector<int64_t>& reacquisitionTimes
+            (
+            const size_t    aTerminal   //!< terminal index
+            ) const;
+
+        ModemState state
+            (
+            const size_t    aTerminal   //!< terminal index
+            ) const;
+
+        int64_t timeInState
+            (
+            const size_t    aTerminal,  //!< terminal index
+            const ModemState aState     //!< modem state
+            ) const;
+
+        const std::vector<StateTransition>& transitions
+            (
+            const size_t    aTerminal   //!< terminal index
+            ) const;
+
+        bool update
+            (
+            const size_t    aTerminal,  //!< terminal index
+            const int64_t   aTimeMs,    //!< time of the sample, ms since epoch
+            const ModemState aState     //!< decoded modem state
+            );
+
+    private:
+        static void accumulate
+            (
+            Terminal&       aTerminal,  //!< terminal
+            const int64_t   aTimeMs     //!< time of the new sample
+            );
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        std::vector<Terminal>           mTerminals;     //!< per terminal state
+};
+
+#endif // ModemStateTracker_h
@@ -0,0 +1,339 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+NdjsonWriter.cpp
+
+This file contains the sources for exporting the published samples
+as newline delimited JSON.
+*/
+
+#include "NdjsonWriter.h"
+
+#include "DeltaPublisher.h"
+#include "RebootDetector.h"
+#include "SampleSchema.h"
+
+#include <math.h>
+#include <string.h>
+
+
+const size_t NdjsonWriter::LINE_CAPACITY;
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+NdjsonWriter::NdjsonWriter()
+{
+}
+
+//!************************************************************************
+//! Append a number, with up to 6 decimals and no exponent. Values which
+//! are not finite are written as null.
+//!
+//! @returns: nothing
+//!************************************************************************
+/* static */ void NdjsonWriter::appendDouble
+    (
+    std::vector<char>&  aLine,      //!< line to append to
+    const double        aValue      //!< value
+    )
+{
+    const double MAX_FIXED = 1.0e12;        // above this the decimals are dropped
+    const uint64_t MICRO = 1000000;
+
+    if( !isfinite( aValue ) || fabs( aValue ) >= 1.0e19 )
+    {
+        appendLiteral( aLine, "null" );
+        return;
+    }
+
+    double magnitude = aValue;
+
+    if( magnitude < 0.0 )
+    {
+        aLine.push_back( '-' );
+        magnitude = -magnitude;
+    }
+
+    if( magnitude >= MAX_FIXED )
+    {
+        appendUnsigned( aLine, static_cast<uint64_t>( magnitude ) );
+        return;
+    }
+
+    const uint64_t scaled = static_cast<uint64_t>( magnitude * MICRO + 0.5 );
+    appendUnsigned( aLine, scaled / MICRO );
+
+    uint64_t fraction = scaled % MICRO;
+
+    if( 0 == fraction )
+    {
+        return;
+    }
+
+    char digits[6];
+    int count = 6;
+
+    while( 0 == fraction % 10 )
+    {
+        fraction /= 10;
+        count--;
+    }
+
+    for( int i = count - 1; i >= 0; i-- )
+    {
+        digits[i] = static_cast<char>( '0' + fraction % 10 );
+        fraction /= 10;
+    }
+
+    aLine.push_back( '.' );
+    aLine.insert( aLine.end(), digits, digits + count );
+}
+
+//!************************************************************************
+//! Append text copied as is
+//!
+//! @returns: nothing
+//!************************************************************************
+/* static */ void NdjsonWriter::appendLiteral
+    (
+    std::vector<char>&  aLine,      //!< line to append to
+    const char*         aLiteral    //!< null terminated text, copied as is
+    )
+{
+    aLine.insert( aLine.end(), aLiteral, aLiteral + strlen( aLiteral ) );
+}
+
+//!************************************************************************
+//! Append a quoted JSON string, escaping quotes, backslashes and control
+//! characters
+//!
+//! @returns: nothing
+//!************************************************************************
+/* static */ void NdjsonWriter::appendText
+    (
+    std::vector<char>&  aLine,      //!< line to append to
+    const char*         aData,      //!< text, not null terminated
+    const int           aLength     //!< number of bytes
+    )
+{
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    aLine.push_back( '"' );
+
+    for( int i = 0; i < aLength; i++ )
+    {
+        const unsigned char c = static_cast<unsigned char>( aData[i] );
+
+        if( '"' == c || '\\' == c )
+        {
+            aLine.push_back( '\\' );
+            aLine.push_back( static_cast<char>( c ) );
+        }
+        else if( c < 0x20 )
+        {
+            const char escape[] = { '\\', 'u', '0', '0', HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0x0F] };
+            aLine.insert( aLine.end(), escape, escape + sizeof( escape ) );
+        }
+        else
+        {
+            aLine.push_back( static_cast<char>( c ) );
+        }
+    }
+
+    aLine.push_back( '"' );
+}
+
+//!************************************************************************
+//! Append an unsigned integer
+//!
+//! @returns: nothing
+//!************************************************************************
+/* static */ void NdjsonWriter::appendUnsigned
+    (
+    std::vector<char>&  aLine,      //!< line to append to
+    uint64_t            aValue      //!< value
+    )
+{
+    char digits[20];
+    int count = 0;
+
+    do
+    {
+        digits[count++] = static_cast<char>( '0' + aValue % 10 );
+        aValue /= 10;
+    }
+    while( aValue > 0 );
+
+    while( count > 0 )
+    {
+        aLine.push_back( digits[--count] );
+    }
+}
+
+//!************************************************************************
+//! Close the output file
+//!
+//! @returns: nothing
+//!************************************************************************
+void NdjsonWriter::close()
+{
+    if( mFile.is_open() )
+    {
+        mFile.close();
+    }
+}
+
+//!************************************************************************
+//! Check whether the output file is open
+//!
+//! @returns: true if samples are written
+//!************************************************************************
+bool NdjsonWriter::isOpen() const
+{
+    return mFile.is_open();
+}
+
+//!************************************************************************
+//! Open the output file, closing the previous one
+//!
+//! @returns: true if the file could be opened
+//!************************************************************************
+bool NdjsonWriter::open
+    (
+    const std::string&  aPath       //!< output file, appended to
+    )
+{
+    close();
+    mFile.open( aPath.c_str(), std::ios::out | std::ios::app | std::ios::binary );
+
+    return mFile.is_open();
+}
+
+//!************************************************************************
+//! Write the changed fields of a reply as one line
+//!
+//! @returns: nothing
+//!************************************************************************
+void NdjsonWriter::publish
+    (
+    const SampleDelta&  aDelta      //!< changed fields of a reply
+    )
+{
+    if( !mFile.is_open() )
+    {
+        return;
+    }
+
+    while( mLines.size() <= aDelta.Terminal )
+    {
+        mLines.push_back( std::vector<char>() );
+        mLines.back().reserve( LINE_CAPACITY );
+    }
+
+    std::vector<char>& line = mLines[aDelta.Terminal];
+    line.clear();
+
+    appendLiteral( line, "{\"time_ms\":" );
+    appendUnsigned( line, static_cast<uint64_t>( aDelta.TimeMs ) );
+    appendLiteral( line, ",\"terminal\":" );
+    appendUnsigned( line, aDelta.Terminal );
+    appendLiteral( line, ",\"source\":\"" );
+    appendLiteral( line, SampleSchema::sourceName( aDelta.Source ) );
+    appendLiteral( line, aDelta.Keyframe ? "\",\"keyframe\":true" : "\",\"keyframe\":false" );
+
+    if( RESET_CAUSE_NONE != aDelta.Resets )
+    {
+        appendLiteral( line, ",\"reset\":\"" );
+        appendLiteral( line, RebootDetector::causeName( aDelta.Resets ) );
+        line.push_back( '"' );
+    }
+
+    const SchemaField* fields = SampleSchema::fields( aDelta.Source );
+    const int fieldCount = SampleSchema::fieldCount( aDelta.Source );
+    const CgiPayload& payload = *aDelta.Payload;
+
+    for( int i = 0; i < fieldCount; i++ )
+    {
+        const int index = fields[i].Index;
+
+        if( index >= aDelta.FieldCount || !DeltaPublisher::isChanged( aDelta, index ) )
+        {
+            continue;
+        }
+
+        const char* data = payload.fieldData( index );
+        const int length = payload.fieldLength( index );
+
+        line.push_back( ',' );
+        line.push_back( '"' );
+        appendLiteral( line, fields[i].Name );
+        line.push_back( '"' );
+        line.push_back( ':' );
+
+        switch( fields[i].Type )
+        {
+            case FIELD_TYPE_NUMBER:
+                if( length > 0 )
+                {
+                    appendDouble( line, CgiPayload::parseDouble( data, length ) );
+                }
+                else
+                {
+                    appendLiteral( line, "null" );
+                }
+                break;
+
+            case FIELD_TYPE_COUNTER:
+                if( length > 0 )
+                {
+                    appendUnsigned( line, CgiPayload::parseUnsigned( data, length ) );
+                }
+                else
+                {
+                    appendLiteral( line, "null" );
+                }
+                break;
+
+            case FIELD_TYPE_DURATION:
+                {
+                    const int64_t seconds = CgiPayload::parseDuration( data, length );
+
+                    if( seconds >= 0 )
+                    {
+                        appendUnsigned( line, static_cast<uint64_t>( seconds ) );
+                    }
+                    else
+                    {
+                        appendLiteral( line, "null" );
+                    }
+                }
+                break;
+
+            default:
+                appendText( line, data, length );
+                break;
+        }
+    }
+
+    line.push_back( '}' );
+    line.push_back( '\n' );
+
+    mFile.write( line.data(), static_cast<std::streamsize>( line.size() ) );
+}
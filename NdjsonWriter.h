@@ -0,0 +1,110 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+NdjsonWriter.h
+
+This file contains the definitions for exporting the published samples
+as newline delimited JSON.
+*/
+
+#ifndef NdjsonWriter_h
+#define NdjsonWriter_h
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "SampleSink.h"
+
+
+//************************************************************************
+// Class for writing each published sample as one JSON object per line,
+// keyed by the schema field names, e.g.
+//
+//     {"time_ms":1617000000000,"terminal":0,"source":"modem","keyframe":false,"rx_snr_db":11.4}
+//
+// Only the changed fields of a delta are written; a keyframe holds all
+// of them. A reply after a reset of the modem counters carries e.g.
+// "reset":"reboot". Every terminal has its own line buffer, reserved up front and
+// reused, and numbers are formatted by hand, so a line is serialized
+// without allocating.
+//************************************************************************
+class NdjsonWriter : public SampleSink
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        static const size_t LINE_CAPACITY = 4096;   //!< bytes reserved per terminal line
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        NdjsonWriter();
+
+        void close();
+
+        bool isOpen() const;
+
+        bool open
+            (
+            const std::string&  aPath       //!< output file, appended to
+            );
+
+        void publish
+            (
+            const SampleDelta&  aDelta      //!< changed fields of a reply
+            ) override;
+
+        static void appendDouble
+            (
+            std::vector<char>&  aLine,      //!< line to append to
+            const double        aValue      //!< value
+            );
+
+        static void appendText
+            (
+            std::vector<char>&  aLine,      //!< line to append to
+            const char*         aData,      //!< text, not null terminated
+            const int           aLength     //!< number of bytes
+            );
+
+        static void appendUnsigned
+            (
+            std::vector<char>&  aLine,      //!< line to append to
+            uint64_t            aValue      //!< value
+            );
+
+    private:
+        static void appendLiteral
+            (
+            std::vector<char>&  aLine,      //!< line to append to
+            const char*         aLiteral    //!< null terminated text, copied as is
+            );
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        std::ofstream                       mFile;      //!< output file
+        std::vector<std::vector<char>>      mLines;     //!< line buffer of each terminal
+};
+
+#endif // NdjsonWriter_h
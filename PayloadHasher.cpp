@@ -0,0 +1,269 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+PayloadHasher.cpp
+
+This file contains the sources for detecting the unchanged replies
+and fields.
+*/
+
+#include "PayloadHasher.h"
+
+#include <string.h>
+
+
+static const uint64_t PRIME_1 = 0x9E3779B185EBCA87ull;
+static const uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+static const uint64_t PRIME_3 = 0x165667B19E3779F9ull;
+static const uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ull;
+static const uint64_t PRIME_5 = 0x27D4EB2F165667C5ull;
+
+
+//!************************************************************************
+//! Rotate left
+//!
+//! @returns: the rotated value
+//!************************************************************************
+static inline uint64_t rotateLeft
+    (
+    const uint64_t  aValue,     //!< value
+    const int       aBits       //!< number of bits, 1 to 63
+    )
+{
+    return ( aValue << aBits ) | ( aValue >> ( 64 - aBits ) );
+}
+
+//!************************************************************************
+//! Read 8 bytes, unaligned, little endian hosts only
+//!
+//! @returns: the value
+//!************************************************************************
+static inline uint64_t read64
+    (
+    const char*     aData       //!< data
+    )
+{
+    uint64_t value;
+    memcpy( &value, aData, sizeof( value ) );
+    return value;
+}
+
+//!************************************************************************
+//! Read 4 bytes, unaligned, little endian hosts only
+//!
+//! @returns: the value
+//!************************************************************************
+static inline uint64_t read32
+    (
+    const char*     aData       //!< data
+    )
+{
+    uint32_t value;
+    memcpy( &value, aData, sizeof( value ) );
+    return value;
+}
+
+//!************************************************************************
+//! One xxHash64 accumulator round
+//!
+//! @returns: the new accumulator
+//!************************************************************************
+static inline uint64_t round64
+    (
+    uint64_t        aAccumulator,   //!< accumulator
+    const uint64_t  aInput          //!< input lane
+    )
+{
+    aAccumulator += aInput * PRIME_2;
+    aAccumulator = rotateLeft( aAccumulator, 31 );
+    return aAccumulator * PRIME_1;
+}
+
+//!************************************************************************
+//! Merge an accumulator into the hash
+//!
+//! @returns: the new hash
+//!************************************************************************
+static inline uint64_t merge64
+    (
+    uint64_t        aHash,          //!< hash
+    const uint64_t  aAccumulator    //!< accumulator
+    )
+{
+    aHash ^= round64( 0, aAccumulator );
+    return aHash * PRIME_1 + PRIME_4;
+}
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+PayloadHasher::PayloadHasher()
+{
+    reset();
+}
+
+//!************************************************************************
+//! Hash each field of a reply and flag the ones that differ from the
+//! previously compared reply. All fields are flagged if the field count
+//! changed.
+//!
+//! @returns: nothing
+//!************************************************************************
+void PayloadHasher::compareFields
+    (
+    const CgiPayload&   aPayload    //!< split reply
+    )
+{
+    const int count = aPayload.size();
+    const bool sameCount = ( static_cast<size_t>( count ) == mFieldHashes.size() );
+
+    mFieldHashes.resize( count );
+    mChanged.resize( count );
+
+    for( int i = 0; i < count; i++ )
+    {
+        const uint64_t fieldHash = hash( aPayload.fieldData( i ), aPayload.fieldLength( i ) );
+
+        mChanged[i] = !sameCount || fieldHash != mFieldHashes[i];
+        mFieldHashes[i] = fieldHash;
+    }
+}
+
+//!************************************************************************
+//! Hash a block of bytes with xxHash64
+//!
+//! @returns: the hash
+//!************************************************************************
+/* static */ uint64_t PayloadHasher::hash
+    (
+    const char*         aData,      //!< data to hash
+    const int           aLength,    //!< number of bytes
+    const uint64_t      aSeed       //!< seed
+    )
+{
+    const char* data = aData;
+    const char* const end = aData + aLength;
+    uint64_t result;
+
+    if( aLength >= 32 )
+    {
+        const char* const limit = end - 32;
+
+        uint64_t v1 = aSeed + PRIME_1 + PRIME_2;
+        uint64_t v2 = aSeed + PRIME_2;
+        uint64_t v3 = aSeed;
+        uint64_t v4 = aSeed - PRIME_1;
+
+        do
+        {
+            v1 = round64( v1, read64( data ) );
+            v2 = round64( v2, read64( data + 8 ) );
+            v3 = round64( v3, read64( data + 16 ) );
+            v4 = round64( v4, read64( data + 24 ) );
+            data += 32;
+        }
+        while( data <= limit );
+
+        result = rotateLeft( v1, 1 ) + rotateLeft( v2, 7 ) + rotateLeft( v3, 12 ) + rotateLeft( v4, 18 );
+        result = merge64( result, v1 );
+        result = merge64( result, v2 );
+        result = merge64( result, v3 );
+        result = merge64( result, v4 );
+    }
+    else
+    {
+        result = aSeed + PRIME_5;
+    }
+
+    result += static_cast<uint64_t>( aLength );
+
+    while( data + 8 <= end )
+    {
+        result ^= round64( 0, read64( data ) );
+        result = rotateLeft( result, 27 ) * PRIME_1 + PRIME_4;
+        data += 8;
+    }
+
+    if( data + 4 <= end )
+    {
+        result ^= read32( data ) * PRIME_1;
+        result = rotateLeft( result, 23 ) * PRIME_2 + PRIME_3;
+        data += 4;
+    }
+
+    while( data < end )
+    {
+        result ^= static_cast<uint8_t>( *data ) * PRIME_5;
+        result = rotateLeft( result, 11 ) * PRIME_1;
+        data++;
+    }
+
+    result ^= result >> 33;
+    result *= PRIME_2;
+    result ^= result >> 29;
+    result *= PRIME_3;
+    result ^= result >> 32;
+
+    return result;
+}
+
+//!************************************************************************
+//! Check whether a field changed in the last compared reply
+//!
+//! @returns: true if the field changed, or is beyond the compared fields
+//!************************************************************************
+bool PayloadHasher::isChanged
+    (
+    const int           aIndex      //!< field index
+    ) const
+{
+    return static_cast<size_t>( aIndex ) >= mChanged.size() || 0 != mChanged[aIndex];
+}
+
+//!************************************************************************
+//! Forget the previous reply, so that the next one is decoded in full
+//!
+//! @returns: nothing
+//!************************************************************************
+void PayloadHasher::reset()
+{
+    mHasReply = false;
+    mReplyHash = 0;
+    mFieldHashes.clear();
+    mChanged.clear();
+}
+
+//!************************************************************************
+//! Hash a raw reply and compare it with the previous one
+//!
+//! @returns: true if the reply differs from the previous one
+//!************************************************************************
+bool PayloadHasher::update
+    (
+    const QByteArray&   aBytes      //!< raw reply
+    )
+{
+    const uint64_t replyHash = hash( aBytes.constData(), aBytes.size() );
+    const bool changed = !mHasReply || replyHash != mReplyHash;
+
+    mHasReply = true;
+    mReplyHash = replyHash;
+
+    return changed;
+}
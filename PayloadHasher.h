@@ -0,0 +1,86 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+PayloadHasher.h
+
+This file contains the definitions for detecting the unchanged replies
+and fields.
+*/
+
+#ifndef PayloadHasher_h
+#define PayloadHasher_h
+
+#include <cstdint>
+#include <vector>
+
+#include <QByteArray>
+
+#include "CgiPayload.h"
+
+
+//************************************************************************
+// Class for finding what changed between consecutive replies of one
+// endpoint. The whole raw reply is hashed first, so that an identical
+// reply is recognized before it is even split; otherwise the hash of
+// each field span is compared with the one of the previous reply, so
+// that only the changed fields are decoded again. The hash is 64 bit
+// xxHash, whose collisions are negligible at these rates.
+//************************************************************************
+class PayloadHasher
+{
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        PayloadHasher();
+
+        void compareFields
+            (
+            const CgiPayload&   aPayload    //!< split reply
+            );
+
+        static uint64_t hash
+            (
+            const char*         aData,      //!< data to hash
+            const int           aLength,    //!< number of bytes
+            const uint64_t      aSeed = 0   //!< seed
+            );
+
+        bool isChanged
+            (
+            const int           aIndex      //!< field index
+            ) const;
+
+        void reset();
+
+        bool update
+            (
+            const QByteArray&   aBytes      //!< raw reply
+            );
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        bool                    mHasReply;      //!< true if a reply was hashed
+        uint64_t                mReplyHash;     //!< hash of the last raw reply
+        std::vector<uint64_t>   mFieldHashes;   //!< hash of each field of the last compared reply
+        std::vector<uint8_t>    mChanged;       //!< 1 for each field changed by the last compared reply
+};
+
+#endif // PayloadHasher_h
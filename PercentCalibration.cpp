@@ -0,0 +1,132 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+PercentCalibration.cpp
+
+This file contains the sources for the conversion of readings to
+percents.
+*/
+
+#include "PercentCalibration.h"
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+    #define PERCENT_CALIBRATION_SSE2
+    #include <emmintrin.h>
+#endif
+
+
+constexpr double PercentCalibration::PERCENT_MIN;
+constexpr double PercentCalibration::PERCENT_MAX;
+
+//************************************************************************
+// Fits of the stock dish and IFL cable, one per mapping
+//************************************************************************
+static const LinearFit DEFAULT_FITS[PercentCalibration::MAPPING_COUNT] =
+{
+    //  Threshold       Offset          Slope
+    {   -3.0,           10.71429,       3.57143     },  // MAPPING_RX_SNR [dB]
+    {   -72.586,        119.42208,      1.64524     },  // MAPPING_RX_PWR [dBm]
+    {   -35.5,          137.86408,      3.8835      },  // MAPPING_TX_IF_PWR [dBm]
+    {   14.5,           -56.31068,      3.8835      },  // MAPPING_TX_RF_PWR [dBm]
+    {   0.0,            0.0,            6.66666     }   // MAPPING_CABLE_ATTENUATION [dB]
+};
+
+
+//!************************************************************************
+//! Get the fit of the stock dish and IFL cable
+//!
+//! @returns: the default polynomial of the reading type
+//!************************************************************************
+const LinearFit& PercentCalibration::defaultFit
+    (
+    const Mapping   aMapping    //!< reading type
+    )
+{
+    return DEFAULT_FITS[aMapping];
+}
+
+//!************************************************************************
+//! Convert a reading to a percent, using the default fit
+//!
+//! @returns: the reading in percent
+//!************************************************************************
+double PercentCalibration::toPercent
+    (
+    const Mapping   aMapping,   //!< reading type
+    const double    aValue      //!< reading
+    )
+{
+    return toPercent( DEFAULT_FITS[aMapping], aValue );
+}
+
+//!************************************************************************
+//! Convert an array of readings to percents
+//!
+//! @returns: nothing
+//!************************************************************************
+void PercentCalibration::toPercents
+    (
+    const LinearFit&    aFit,       //!< polynomial
+    const double*       aValues,    //!< readings
+    const size_t        aCount,     //!< number of readings
+    double*             aPercents   //!< converted percents, one per reading
+    )
+{
+    size_t i = 0;
+
+#if defined( PERCENT_CALIBRATION_SSE2 )
+    const __m128d threshold = _mm_set1_pd( aFit.Threshold );
+    const __m128d offset = _mm_set1_pd( aFit.Offset );
+    const __m128d slope = _mm_set1_pd( aFit.Slope );
+    const __m128d percentMin = _mm_set1_pd( PERCENT_MIN );
+    const __m128d percentMax = _mm_set1_pd( PERCENT_MAX );
+
+    for( ; i + 2 <= aCount; i += 2 )
+    {
+        const __m128d value = _mm_loadu_pd( aValues + i );
+        __m128d percent = _mm_add_pd( offset, _mm_mul_pd( slope, value ) );
+        percent = _mm_max_pd( _mm_min_pd( percent, percentMax ), percentMin );
+
+        // readings below the threshold, or not a number, give all zero bits, i.e. 0%
+        percent = _mm_and_pd( percent, _mm_cmpge_pd( value, threshold ) );
+        _mm_storeu_pd( aPercents + i, percent );
+    }
+#endif
+
+    // tail, or the whole array where the compiler vectorises it on its own
+    for( ; i < aCount; i++ )
+    {
+        aPercents[i] = toPercent( aFit, aValues[i] );
+    }
+}
+
+//!************************************************************************
+//! Convert an array of readings to percents, using the default fit
+//!
+//! @returns: nothing
+//!************************************************************************
+void PercentCalibration::toPercents
+    (
+    const Mapping       aMapping,   //!< reading type
+    const double*       aValues,    //!< readings
+    const size_t        aCount,     //!< number of readings
+    double*             aPercents   //!< converted percents, one per reading
+    )
+{
+    toPercents( DEFAULT_FITS[aMapping], aValues, aCount, aPercents );
+}
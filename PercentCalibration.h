@@ -0,0 +1,120 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+PercentCalibration.h
+
+This file contains the definitions for the conversion of readings to
+percents.
+*/
+
+#ifndef PercentCalibration_h
+#define PercentCalibration_h
+
+#include <cstddef>
+
+
+//************************************************************************
+// First degree polynomial mapping a reading to a percent
+//************************************************************************
+typedef struct
+{
+    double                      Threshold;      //!< lowest reading mapped above 0%
+    double                      Offset;         //!< percent at a reading of 0
+    double                      Slope;          //!< percent per reading unit
+}LinearFit;
+
+//************************************************************************
+// Class for converting readings to percents, for the progress bars and
+// for the exporters. Readings below the threshold of a fit map to 0%,
+// the others are interpolated and clamped to 0..100%. The batch
+// conversions process arrays of readings a vector at a time.
+//************************************************************************
+class PercentCalibration
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        enum Mapping
+        {
+            MAPPING_RX_SNR,
+            MAPPING_RX_PWR,
+            MAPPING_TX_IF_PWR,
+            MAPPING_TX_RF_PWR,
+            MAPPING_CABLE_ATTENUATION,
+
+            MAPPING_COUNT
+        };
+
+        static constexpr double PERCENT_MIN = 0.0;      //!< lowest percent
+        static constexpr double PERCENT_MAX = 100.0;    //!< highest percent
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        static const LinearFit& defaultFit
+            (
+            const Mapping       aMapping        //!< reading type
+            );
+
+        static constexpr double toPercent
+            (
+            const LinearFit&    aFit,           //!< polynomial
+            const double        aValue          //!< reading
+            )
+        {
+            return !( aValue >= aFit.Threshold ) ? PERCENT_MIN
+                 : clamp( aFit.Offset + aFit.Slope * aValue );
+        }
+
+        static double toPercent
+            (
+            const Mapping       aMapping,       //!< reading type
+            const double        aValue          //!< reading
+            );
+
+        static void toPercents
+            (
+            const LinearFit&    aFit,           //!< polynomial
+            const double*       aValues,        //!< readings
+            const size_t        aCount,         //!< number of readings
+            double*             aPercents       //!< converted percents, one per reading
+            );
+
+        static void toPercents
+            (
+            const Mapping       aMapping,       //!< reading type
+            const double*       aValues,        //!< readings
+            const size_t        aCount,         //!< number of readings
+            double*             aPercents       //!< converted percents, one per reading
+            );
+
+    private:
+        static constexpr double clamp
+            (
+            const double        aPercent        //!< unclamped percent
+            )
+        {
+            return aPercent < PERCENT_MIN ? PERCENT_MIN
+                 : aPercent > PERCENT_MAX ? PERCENT_MAX
+                 : aPercent;
+        }
+};
+
+#endif // PercentCalibration_h
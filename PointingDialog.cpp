@@ -0,0 +1,152 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+PointingDialog.cpp
+
+This file contains the sources for the dish pointing window.
+*/
+
+#include "PointingDialog.h"
+
+#include <QFont>
+#include <QLabel>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+#include "PercentCalibration.h"
+
+
+constexpr double PointingDialog::NEAR_PEAK_DB;
+
+
+//************************************************************************
+// Style of the bar near the peak and away from it
+//************************************************************************
+static const char* const NEAR_PEAK_STYLE =
+    "QProgressBar { background-color: rgb( 191, 191, 191 ); border-radius: 5px; } QProgressBar::chunk { background-color: rgb( 0, 191, 0 ); border-radius: 5px; }";
+
+static const char* const OFF_PEAK_STYLE =
+    "QProgressBar { background-color: rgb( 191, 191, 191 ); border-radius: 5px; } QProgressBar::chunk { background-color: rgb( 255, 127, 0 ); border-radius: 5px; }";
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+PointingDialog::PointingDialog
+    (
+    QWidget*    aParent     //!< a parent widget
+    )
+    : QDialog( aParent )
+    , mSnrLabel( new QLabel( "-- dB", this ) )
+    , mSnrProgressbar( new QProgressBar( this ) )
+    , mPeakLabel( new QLabel( "Peak: -- dB", this ) )
+    , mRateLabel( new QLabel( "-- updates/s", this ) )
+    , mNearPeak( false )
+{
+    setWindowTitle( "Dish Pointing" );
+
+    QFont snrFont;
+    snrFont.setPointSize( 48 );
+    snrFont.setBold( true );
+    mSnrLabel->setFont( snrFont );
+    mSnrLabel->setAlignment( Qt::AlignCenter );
+
+    QFont peakFont;
+    peakFont.setPointSize( 20 );
+    mPeakLabel->setFont( peakFont );
+    mPeakLabel->setAlignment( Qt::AlignCenter );
+
+    mRateLabel->setAlignment( Qt::AlignCenter );
+
+    mSnrProgressbar->setRange( 0, 100 );
+    mSnrProgressbar->setTextVisible( false );
+    mSnrProgressbar->setMinimumSize( 400, 40 );
+    mSnrProgressbar->setStyleSheet( OFF_PEAK_STYLE );
+
+    QPushButton* resetButton = new QPushButton( "Reset peak", this );
+    connect( resetButton, &QPushButton::clicked, this, &PointingDialog::resetPeak );
+
+    QVBoxLayout* layout = new QVBoxLayout( this );
+    layout->addWidget( mSnrLabel );
+    layout->addWidget( mSnrProgressbar );
+    layout->addWidget( mPeakLabel );
+    layout->addWidget( mRateLabel );
+    layout->addWidget( resetButton );
+}
+
+//!************************************************************************
+//! Show a new SNR reading
+//!
+//! @returns: nothing
+//!************************************************************************
+void PointingDialog::addSnr
+    (
+    const int64_t   aTimeMs,    //!< time of the reply, ms since epoch
+    const double    aSnrDb      //!< raw SNR [dB]
+    )
+{
+    mFilter.add( aTimeMs, aSnrDb );
+
+    const double snr = mFilter.smoothed();
+    const bool nearPeak = snr >= mFilter.peak() - NEAR_PEAK_DB;
+
+    mSnrLabel->setText( QString::number( snr, 'f', 1 ) + " dB" );
+    mSnrProgressbar->setValue( static_cast<int>( PercentCalibration::toPercent( PercentCalibration::MAPPING_RX_SNR, snr ) ) );
+
+    // parsing a style sheet is costly at the pointing rate, so it is only
+    // set when the bar changes color
+    if( nearPeak != mNearPeak )
+    {
+        mSnrProgressbar->setStyleSheet( nearPeak ? NEAR_PEAK_STYLE : OFF_PEAK_STYLE );
+        mNearPeak = nearPeak;
+    }
+
+    mPeakLabel->setText( "Peak: " + QString::number( mFilter.peak(), 'f', 1 ) + " dB" );
+    mRateLabel->setText( QString::number( mFilter.sampleRate(), 'f', 1 ) + " updates/s" );
+}
+
+//!************************************************************************
+//! Clear the readings of the previous session, before the dialog is
+//! shown again
+//!
+//! @returns: nothing
+//!************************************************************************
+void PointingDialog::reset()
+{
+    mFilter.reset();
+
+    mSnrLabel->setText( "-- dB" );
+    mSnrProgressbar->setValue( 0 );
+    mSnrProgressbar->setStyleSheet( OFF_PEAK_STYLE );
+    mPeakLabel->setText( "Peak: -- dB" );
+    mRateLabel->setText( "-- updates/s" );
+
+    mNearPeak = false;
+}
+
+//!************************************************************************
+//! Restart the peak from the current SNR
+//!
+//! @returns: nothing
+//!************************************************************************
+/* slot */ void PointingDialog::resetPeak()
+{
+    mFilter.resetPeak();
+    mPeakLabel->setText( "Peak: " + QString::number( mFilter.peak(), 'f', 1 ) + " dB" );
+}
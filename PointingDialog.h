@@ -0,0 +1,86 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+PointingDialog.h
+
+This file contains the definitions for the dish pointing window.
+*/
+
+#ifndef PointingDialog_h
+#define PointingDialog_h
+
+#include <cstdint>
+
+#include <QDialog>
+
+#include "PointingFilter.h"
+
+
+class QLabel;
+class QProgressBar;
+
+//************************************************************************
+// Class for the window shown while the dish is peaked: a large smoothed
+// SNR, a bar turning green near the session peak, the peak itself and
+// the rate the modem is polled at.
+//************************************************************************
+class PointingDialog : public QDialog
+{
+    Q_OBJECT
+
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    private:
+        static constexpr double NEAR_PEAK_DB = 0.5;     //!< distance from the peak shown as on peak
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        explicit PointingDialog
+            (
+            QWidget* aParent = nullptr  //!< a parent widget
+            );
+
+        void addSnr
+            (
+            const int64_t   aTimeMs,    //!< time of the reply, ms since epoch
+            const double    aSnrDb      //!< raw SNR [dB]
+            );
+
+        void reset();
+
+    public slots:
+        void resetPeak();
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        PointingFilter          mFilter;            //!< SNR smoothing and peak
+
+        QLabel*                 mSnrLabel;          //!< smoothed SNR
+        QProgressBar*           mSnrProgressbar;    //!< smoothed SNR, as a bar
+        QLabel*                 mPeakLabel;         //!< session peak
+        QLabel*                 mRateLabel;         //!< polling rate
+
+        bool                    mNearPeak;          //!< true if the bar is shown as on peak
+};
+
+#endif // PointingDialog_h
@@ -0,0 +1,135 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+PointingFilter.cpp
+
+This file contains the sources for the SNR smoothing used when
+pointing the dish.
+*/
+
+#include "PointingFilter.h"
+
+#include <math.h>
+
+
+constexpr double PointingFilter::TIME_CONSTANT_MS;
+constexpr double PointingFilter::RATE_TIME_CONSTANT_MS;
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+PointingFilter::PointingFilter()
+{
+    reset();
+}
+
+//!************************************************************************
+//! Add a raw SNR sample
+//!
+//! @returns: nothing
+//!************************************************************************
+void PointingFilter::add
+    (
+    const int64_t   aTimeMs,    //!< time of the sample, ms since epoch
+    const double    aSnrDb      //!< raw SNR [dB]
+    )
+{
+    if( mLastTimeMs < 0 )
+    {
+        mSmoothed = aSnrDb;
+        mPeak = aSnrDb;
+        mLastTimeMs = aTimeMs;
+        return;
+    }
+
+    const double elapsedMs = static_cast<double>( aTimeMs > mLastTimeMs ? aTimeMs - mLastTimeMs : 1 );
+    mLastTimeMs = aTimeMs;
+
+    const double weight = 1.0 - exp( -elapsedMs / TIME_CONSTANT_MS );
+    mSmoothed += weight * ( aSnrDb - mSmoothed );
+
+    if( mIntervalMs <= 0.0 )
+    {
+        mIntervalMs = elapsedMs;
+    }
+    else
+    {
+        const double rateWeight = 1.0 - exp( -elapsedMs / RATE_TIME_CONSTANT_MS );
+        mIntervalMs += rateWeight * ( elapsedMs - mIntervalMs );
+    }
+
+    if( mSmoothed > mPeak )
+    {
+        mPeak = mSmoothed;
+    }
+}
+
+//!************************************************************************
+//! Get the session peak
+//!
+//! @returns: the highest smoothed SNR [dB]
+//!************************************************************************
+double PointingFilter::peak() const
+{
+    return mPeak;
+}
+
+//!************************************************************************
+//! Start a new session
+//!
+//! @returns: nothing
+//!************************************************************************
+void PointingFilter::reset()
+{
+    mLastTimeMs = -1;
+    mSmoothed = 0.0;
+    mPeak = 0.0;
+    mIntervalMs = 0.0;
+}
+
+//!************************************************************************
+//! Restart the peak from the current smoothed SNR, e.g. after a coarse
+//! sweep
+//!
+//! @returns: nothing
+//!************************************************************************
+void PointingFilter::resetPeak()
+{
+    mPeak = mSmoothed;
+}
+
+//!************************************************************************
+//! Get the rate of the samples
+//!
+//! @returns: the samples per second, 0 before the second sample
+//!************************************************************************
+double PointingFilter::sampleRate() const
+{
+    return mIntervalMs > 0.0 ? 1000.0 / mIntervalMs : 0.0;
+}
+
+//!************************************************************************
+//! Get the smoothed SNR
+//!
+//! @returns: the smoothed SNR [dB]
+//!************************************************************************
+double PointingFilter::smoothed() const
+{
+    return mSmoothed;
+}
@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+PointingFilter.h
+
+This file contains the definitions for the SNR smoothing used when
+pointing the dish.
+*/
+
+#ifndef PointingFilter_h
+#define PointingFilter_h
+
+#include <cstdint>
+
+
+//************************************************************************
+// Class for smoothing the SNR while the dish is peaked. The filter is a
+// first order low pass whose weight follows the actual sample interval,
+// so that its lag stays the same whatever rate the modem sustains; the
+// peak of the smoothed SNR is kept for the session.
+//************************************************************************
+class PointingFilter
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        static constexpr double TIME_CONSTANT_MS = 300.0;           //!< lag of the smoothed SNR
+        static constexpr double RATE_TIME_CONSTANT_MS = 2000.0;     //!< lag of the sample rate estimate
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        PointingFilter();
+
+        void add
+            (
+            const int64_t   aTimeMs,    //!< time of the sample, ms since epoch
+            const double    aSnrDb      //!< raw SNR [dB]
+            );
+
+        double peak() const;
+
+        void reset();
+
+        void resetPeak();
+
+        double sampleRate() const;
+
+        double smoothed() const;
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        int64_t                     mLastTimeMs;        //!< time of the last sample, -1 if none
+        double                      mSmoothed;          //!< smoothed SNR [dB]
+        double                      mPeak;              //!< highest smoothed SNR [dB]
+        double                      mIntervalMs;        //!< smoothed sample interval
+};
+
+#endif // PointingFilter_h
@@ -0,0 +1,221 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+PollScheduler.cpp
+
+This file contains the sources for scheduling the CGI requests.
+*/
+
+#include "PollScheduler.h"
+
+
+const int64_t PollScheduler::NEVER;
+const int64_t PollScheduler::TOLERANCE_MS;
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+PollScheduler::PollScheduler()
+{
+    for( int i = 0; i < ENDPOINT_COUNT; i++ )
+    {
+        mPeriodMs[i] = NEVER;
+        mNextMs[i] = 0;
+    }
+}
+
+//!************************************************************************
+//! Add a consumer, enabled
+//!
+//! @returns: the index of the consumer
+//!************************************************************************
+size_t PollScheduler::addConsumer
+    (
+    const PollConsumer& aConsumer   //!< consumer to add
+    )
+{
+    mConsumers.push_back( aConsumer );
+    mEnabled.push_back( true );
+    updatePeriods();
+
+    return mConsumers.size() - 1;
+}
+
+//!************************************************************************
+//! Check whether an endpoint has to be requested
+//!
+//! @returns: true if the endpoint is used and its period has elapsed
+//!************************************************************************
+bool PollScheduler::due
+    (
+    const Endpoint  aEndpoint,      //!< endpoint
+    const int64_t   aTimeMs         //!< current time, ms since epoch
+    ) const
+{
+    return NEVER != mPeriodMs[aEndpoint]
+        && aTimeMs + TOLERANCE_MS >= mNextMs[aEndpoint];
+}
+
+//!************************************************************************
+//! Get the endpoint reporting a metric
+//!
+//! @returns: the endpoint
+//!************************************************************************
+/* static */ Endpoint PollScheduler::endpointOf
+    (
+    const Metric    aMetric         //!< metric
+    )
+{
+    switch( aMetric )
+    {
+        case METRIC_TX_IF_PWR_DBM:
+        case METRIC_TX_RF_PWR_DBM:
+        case METRIC_TEMPERATURE_C:
+            return ENDPOINT_TRIA;
+
+        default:
+            return ENDPOINT_MODEM;
+    }
+}
+
+//!************************************************************************
+//! Get the period an endpoint is requested at
+//!
+//! @returns: the period [ms], NEVER if no enabled consumer uses it
+//!************************************************************************
+int64_t PollScheduler::period
+    (
+    const Endpoint  aEndpoint       //!< endpoint
+    ) const
+{
+    return mPeriodMs[aEndpoint];
+}
+
+//!************************************************************************
+//! Account a request of an endpoint. The next request keeps the phase of
+//! the previous ones unless the requests fell behind.
+//!
+//! @returns: nothing
+//!************************************************************************
+void PollScheduler::polled
+    (
+    const Endpoint  aEndpoint,      //!< endpoint
+    const int64_t   aTimeMs         //!< time of the request, ms since epoch
+    )
+{
+    const int64_t periodMs = mPeriodMs[aEndpoint];
+
+    if( NEVER == periodMs )
+    {
+        return;
+    }
+
+    const bool late = aTimeMs - mNextMs[aEndpoint] > TOLERANCE_MS;
+    mNextMs[aEndpoint] = ( late ? aTimeMs : mNextMs[aEndpoint] ) + periodMs;
+}
+
+//!************************************************************************
+//! Enable or disable a consumer, e.g. when a window is shown or hidden
+//!
+//! @returns: nothing
+//!************************************************************************
+void PollScheduler::setEnabled
+    (
+    const size_t    aConsumer,      //!< consumer index
+    const bool      aEnabled        //!< true to account the consumer
+    )
+{
+    if( aConsumer < mEnabled.size() && mEnabled[aConsumer] != aEnabled )
+    {
+        mEnabled[aConsumer] = aEnabled;
+        updatePeriods();
+    }
+}
+
+//!************************************************************************
+//! Get the period the scheduler needs to be ticked at
+//!
+//! @returns: the shortest endpoint period [ms], NEVER if nothing is used
+//!************************************************************************
+int64_t PollScheduler::tickMs() const
+{
+    int64_t tickMs = NEVER;
+
+    for( int i = 0; i < ENDPOINT_COUNT; i++ )
+    {
+        if( NEVER != mPeriodMs[i] && ( NEVER == tickMs || mPeriodMs[i] < tickMs ) )
+        {
+            tickMs = mPeriodMs[i];
+        }
+    }
+
+    return tickMs;
+}
+
+//!************************************************************************
+//! Recompute the period of each endpoint from the enabled consumers. An
+//! endpoint whose period got shorter is requested at the next tick.
+//!
+//! @returns: nothing
+//!************************************************************************
+void PollScheduler::updatePeriods()
+{
+    int64_t periodMs[ENDPOINT_COUNT];
+
+    for( int i = 0; i < ENDPOINT_COUNT; i++ )
+    {
+        periodMs[i] = NEVER;
+    }
+
+    for( size_t c = 0; c < mConsumers.size(); c++ )
+    {
+        if( !mEnabled[c] )
+        {
+            continue;
+        }
+
+        uint32_t endpoints = mConsumers[c].Endpoints;
+
+        for( int m = 0; m < METRIC_COUNT; m++ )
+        {
+            if( mConsumers[c].Metrics & ( 1u << m ) )
+            {
+                endpoints |= 1u << endpointOf( static_cast<Metric>( m ) );
+            }
+        }
+
+        for( int i = 0; i < ENDPOINT_COUNT; i++ )
+        {
+            if( ( endpoints & ( 1u << i ) ) && ( NEVER == periodMs[i] || mConsumers[c].PeriodMs < periodMs[i] ) )
+            {
+                periodMs[i] = mConsumers[c].PeriodMs;
+            }
+        }
+    }
+
+    for( int i = 0; i < ENDPOINT_COUNT; i++ )
+    {
+        if( NEVER != periodMs[i] && ( NEVER == mPeriodMs[i] || periodMs[i] < mPeriodMs[i] ) )
+        {
+            mNextMs[i] = 0;
+        }
+
+        mPeriodMs[i] = periodMs[i];
+    }
+}
@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+PollScheduler.h
+
+This file contains the definitions for scheduling the CGI requests.
+*/
+
+#ifndef PollScheduler_h
+#define PollScheduler_h
+
+#include <cstdint>
+#include <vector>
+
+#include <QString>
+
+#include "SurfBeam2Types.h"
+
+
+//************************************************************************
+// Consumer of the polled data, as declared
+//************************************************************************
+typedef struct
+{
+    QString                     Name;           //!< name of the consumer
+    uint32_t                    Metrics;        //!< metrics used, as a mask of 1 << Metric
+    uint32_t                    Endpoints;      //!< endpoints fully used, as a mask of 1 << Endpoint
+    int64_t                     PeriodMs;       //!< maximum age of the data the consumer accepts
+}PollConsumer;
+
+//************************************************************************
+// Class for deciding which endpoints are requested at each tick. Every
+// consumer declares the metrics or the whole endpoints it uses and how
+// fresh it needs them; an endpoint is requested at the shortest period
+// of the enabled consumers using it, and not at all if none does.
+//************************************************************************
+class PollScheduler
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        static const int64_t NEVER = -1;            //!< period of an endpoint no consumer uses
+        static const int64_t TOLERANCE_MS = 50;     //!< timer jitter accepted before a tick is missed
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        PollScheduler();
+
+        size_t addConsumer
+            (
+            const PollConsumer& aConsumer   //!< consumer to add
+            );
+
+        bool due
+            (
+            const Endpoint  aEndpoint,      //!< endpoint
+            const int64_t   aTimeMs         //!< current time, ms since epoch
+            ) const;
+
+        static Endpoint endpointOf
+            (
+            const Metric    aMetric         //!< metric
+            );
+
+        int64_t period
+            (
+            const Endpoint  aEndpoint       //!< endpoint
+            ) const;
+
+        void polled
+            (
+            const Endpoint  aEndpoint,      //!< endpoint
+            const int64_t   aTimeMs         //!< time of the request, ms since epoch
+            );
+
+        void setEnabled
+            (
+            const size_t    aConsumer,      //!< consumer index
+            const bool      aEnabled        //!< true to account the consumer
+            );
+
+        int64_t tickMs() const;
+
+    private:
+        void updatePeriods();
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        std::vector<PollConsumer>   mConsumers;                 //!< declared consumers
+        std::vector<bool>           mEnabled;                   //!< enabled flag of each consumer
+
+        int64_t                     mPeriodMs[ENDPOINT_COUNT];  //!< resulting period of each endpoint
+        int64_t                     mNextMs[ENDPOINT_COUNT];    //!< time of the next request, 0 to request at once
+};
+
+#endif // PollScheduler_h
@@ -0,0 +1,170 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+PowerFormatter.cpp
+
+This file contains the sources for the dBm to Watts formatter.
+*/
+
+#include "PowerFormatter.h"
+
+#include <vector>
+
+#include <math.h>
+
+
+//!************************************************************************
+//! Convert a power to a string, without the table
+//!
+//! @returns: a string with the power in Watts and a unit prefix
+//!************************************************************************
+QString PowerFormatter::format
+    (
+    const double aDbm   //!< power in dBm
+    )
+{
+    const QString MU_SMALL = QString::fromUtf8( "\u03BC" );   //!< small Greek mu
+
+    QString pwrString;
+    double pwrWatts = toWatts( aDbm );
+
+    if( fabs( pwrWatts ) >= 1.0 )
+    {
+        pwrString = QString::number( pwrWatts, 'f', 3 ) + " W";
+    }
+    else if( fabs( pwrWatts ) >= 1.0e-3 )
+    {
+        pwrString = QString::number( pwrWatts * 1.e3, 'f', 1 ) + " mW";
+    }
+    else if( fabs( pwrWatts ) >= 1.0e-6 )
+    {
+        pwrString = QString::number( pwrWatts * 1.e6, 'f', 1 ) + " " + MU_SMALL + "W";
+    }
+    else if( fabs( pwrWatts ) >= 1.0e-9 )
+    {
+        pwrString = QString::number( pwrWatts * 1.e9, 'f', 1 ) + " nW";
+    }
+    else if( fabs( pwrWatts ) >= 1.0e-12 )
+    {
+        pwrString = QString::number( pwrWatts * 1.e12, 'f', 1 ) + " pW";
+    }
+    else if( fabs( pwrWatts ) >= 1.0e-15 )
+    {
+        pwrString = QString::number( pwrWatts * 1.e15, 'f', 1 ) + " fW";
+    }
+    else
+    {
+        pwrString = QString::number( pwrWatts, 'g', 3 ) + " W";
+    }
+
+    return pwrString;
+}
+
+//!************************************************************************
+//! Get the table of preformatted strings, building it on first use
+//!
+//! @returns: the string of each power from TABLE_MIN_DECI_DBM to
+//!           TABLE_MAX_DECI_DBM, in 0.1 dB steps
+//!************************************************************************
+const QString* PowerFormatter::table()
+{
+    static const std::vector<QString> TABLE = []()
+    {
+        std::vector<QString> strings;
+        strings.reserve( TABLE_MAX_DECI_DBM - TABLE_MIN_DECI_DBM + 1 );
+
+        for( int deciDbm = TABLE_MIN_DECI_DBM; deciDbm <= TABLE_MAX_DECI_DBM; deciDbm++ )
+        {
+            strings.push_back( format( deciDbm / 10.0 ) );
+        }
+
+        return strings;
+    }();
+
+    return TABLE.data();
+}
+
+//!************************************************************************
+//! Convert a power in dBm to a string in Watts, with a submultiple or a
+//! multiple suffix.
+//!
+//! @returns: a string with the power conversion
+//!************************************************************************
+QString PowerFormatter::toString
+    (
+    const double aDbm   //!< power in dBm
+    )
+{
+    const double deciDbm = aDbm * 10.0;
+    const double rounded = floor( deciDbm + 0.5 );
+
+    if( fabs( deciDbm - rounded ) < 1.0e-6
+     && rounded >= TABLE_MIN_DECI_DBM
+     && rounded <= TABLE_MAX_DECI_DBM )
+    {
+        return table()[static_cast<int>( rounded ) - TABLE_MIN_DECI_DBM];
+    }
+
+    return format( aDbm );
+}
+
+//!************************************************************************
+//! Convert many powers in dBm to strings in Watts, e.g. for exporting
+//! the readings of a whole fleet
+//!
+//! @returns: nothing
+//!************************************************************************
+void PowerFormatter::toStrings
+    (
+    const double*   aDbm,       //!< powers in dBm
+    const size_t    aCount,     //!< number of powers
+    QString*        aStrings    //!< converted strings, one per power
+    )
+{
+    const QString* strings = table();
+
+    for( size_t i = 0; i < aCount; i++ )
+    {
+        const double deciDbm = aDbm[i] * 10.0;
+        const double rounded = floor( deciDbm + 0.5 );
+
+        if( fabs( deciDbm - rounded ) < 1.0e-6
+         && rounded >= TABLE_MIN_DECI_DBM
+         && rounded <= TABLE_MAX_DECI_DBM )
+        {
+            aStrings[i] = strings[static_cast<int>( rounded ) - TABLE_MIN_DECI_DBM];
+        }
+        else
+        {
+            aStrings[i] = format( aDbm[i] );
+        }
+    }
+}
+
+//!************************************************************************
+//! Convert power from dBm to Watts
+//!
+//! @returns: power in Watts
+//!************************************************************************
+double PowerFormatter::toWatts
+    (
+    const double aDbm   //!< power in dBm
+    )
+{
+    return pow( 10.0, 0.1 * ( aDbm - 30.0 ) );
+}
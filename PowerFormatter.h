@@ -0,0 +1,77 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+PowerFormatter.h
+
+This file contains the definitions for the dBm to Watts formatter.
+*/
+
+#ifndef PowerFormatter_h
+#define PowerFormatter_h
+
+#include <cstddef>
+
+#include <QString>
+
+
+//************************************************************************
+// Class for converting powers in dBm to Watts strings with a unit prefix.
+// The modem reports powers with a 0.1 dB resolution, so the strings of
+// the usual range are formatted once into a table, and only values off
+// the 0.1 dB grid or outside the table are converted on the fly.
+//************************************************************************
+class PowerFormatter
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    private:
+        static const int TABLE_MIN_DECI_DBM = -1500;    //!< lowest tabulated power [0.1 dBm]
+        static const int TABLE_MAX_DECI_DBM = 500;      //!< highest tabulated power [0.1 dBm]
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        static double toWatts
+            (
+            const double aDbm           //!< power in dBm
+            );
+
+        static QString toString
+            (
+            const double aDbm           //!< power in dBm
+            );
+
+        static void toStrings
+            (
+            const double*   aDbm,       //!< powers in dBm
+            const size_t    aCount,     //!< number of powers
+            QString*        aStrings    //!< converted strings, one per power
+            );
+
+    private:
+        static QString format
+            (
+            const double aDbm           //!< power in dBm
+            );
+
+        static const QString* table();
+};
+
+#endif // PowerFormatter_h
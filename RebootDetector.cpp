@@ -0,0 +1,166 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+RebootDetector.cpp
+
+This file contains the sources for the detection of modem reboots
+and network re-entries.
+*/
+
+#include "RebootDetector.h"
+
+
+const int64_t RebootDetector::ONLINE_TIME_TOLERANCE_S;
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+RebootDetector::RebootDetector()
+    : mPrevious()
+    , mHasPrevious( false )
+    , mIncrements()
+{
+}
+
+//!************************************************************************
+//! Get the name of the resets detected with a reply
+//!
+//! @returns: "reboot", "network re-entry" or "counter reset", or an empty
+//!           string for RESET_CAUSE_NONE
+//!************************************************************************
+/* static */ const char* RebootDetector::causeName
+    (
+    const uint8_t   aCauses         //!< ResetCause bits
+    )
+{
+    switch( aCauses )
+    {
+        case RESET_CAUSE_REBOOT:        return "reboot";
+        case RESET_CAUSE_ONLINE_TIME:   return "network re-entry";
+        case RESET_CAUSE_COUNTERS:      return "counter reset";
+        default:                        return "";
+    }
+}
+
+//!************************************************************************
+//! Get the detected resets
+//!
+//! @returns: the resets, in time order
+//!************************************************************************
+const std::vector<ResetEvent>& RebootDetector::events() const
+{
+    return mEvents;
+}
+
+//!************************************************************************
+//! Get the increment of a counter
+//!
+//! @returns: the increase, or the current value if the counter restarted
+//!************************************************************************
+uint64_t RebootDetector::increment
+    (
+    const uint64_t  aPrevious,      //!< previous counter value
+    const uint64_t  aCurrent,       //!< current counter value
+    bool&           aReset          //!< set if the counter went backwards
+    )
+{
+    if( aCurrent < aPrevious )
+    {
+        aReset = true;
+        return aCurrent;
+    }
+
+    return aCurrent - aPrevious;
+}
+
+//!************************************************************************
+//! Get the increments between the last two replies. The online time
+//! increment is -1 if either reply did not report it.
+//!
+//! @returns: the increments, with TimeMs holding the elapsed time
+//!************************************************************************
+const CounterReading& RebootDetector::increments() const
+{
+    return mIncrements;
+}
+
+//!************************************************************************
+//! Check the values of a reply against the previous reply
+//!
+//! @returns: the ResetCause bits of the reply, RESET_CAUSE_NONE if none
+//!************************************************************************
+uint8_t RebootDetector::update
+    (
+    const CounterReading& aReading      //!< values of the new reply
+    )
+{
+    if( !mHasPrevious )
+    {
+        mPrevious = aReading;
+        mHasPrevious = true;
+        mIncrements = CounterReading();
+        mIncrements.OnlineTimeSeconds = -1;
+        return RESET_CAUSE_NONE;
+    }
+
+    uint8_t causes = RESET_CAUSE_NONE;
+    bool countersReset = false;
+
+    mIncrements.TimeMs = aReading.TimeMs - mPrevious.TimeMs;
+    mIncrements.TxPackets = increment( mPrevious.TxPackets, aReading.TxPackets, countersReset );
+    mIncrements.TxBytes = increment( mPrevious.TxBytes, aReading.TxBytes, countersReset );
+    mIncrements.RxPackets = increment( mPrevious.RxPackets, aReading.RxPackets, countersReset );
+    mIncrements.RxBytes = increment( mPrevious.RxBytes, aReading.RxBytes, countersReset );
+    mIncrements.OnlineTimeSeconds = -1;
+
+    if( countersReset )
+    {
+        causes |= RESET_CAUSE_COUNTERS;
+    }
+
+    if( mPrevious.OnlineTimeSeconds >= 0 && aReading.OnlineTimeSeconds >= 0 )
+    {
+        // compared to the wall clock, so that a restart is noticed even
+        // when the replies in between were missed
+        const int64_t expectedSeconds = mPrevious.OnlineTimeSeconds + mIncrements.TimeMs / 1000;
+
+        if( aReading.OnlineTimeSeconds + ONLINE_TIME_TOLERANCE_S < expectedSeconds )
+        {
+            causes |= RESET_CAUSE_ONLINE_TIME;
+            mIncrements.OnlineTimeSeconds = aReading.OnlineTimeSeconds;
+        }
+        else
+        {
+            mIncrements.OnlineTimeSeconds = aReading.OnlineTimeSeconds - mPrevious.OnlineTimeSeconds;
+        }
+    }
+
+    if( RESET_CAUSE_NONE != causes )
+    {
+        ResetEvent event;
+        event.TimeMs = aReading.TimeMs;
+        event.Causes = causes;
+        event.PreviousOnlineTimeSeconds = mPrevious.OnlineTimeSeconds;
+        event.OnlineTimeSeconds = aReading.OnlineTimeSeconds;
+        mEvents.push_back( event );
+    }
+
+    mPrevious = aReading;
+    return causes;
+}
@@ -0,0 +1,118 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+RebootDetector.h
+
+This file contains the definitions for the detection of modem reboots
+and network re-entries.
+*/
+
+#ifndef RebootDetector_h
+#define RebootDetector_h
+
+#include <cstdint>
+#include <vector>
+
+
+enum ResetCause
+{
+    RESET_CAUSE_NONE            = 0x00,     //!< no reset
+    RESET_CAUSE_ONLINE_TIME     = 0x01,     //!< the online time restarted, e.g. a network re-entry
+    RESET_CAUSE_COUNTERS        = 0x02,     //!< a traffic counter went backwards
+
+    RESET_CAUSE_REBOOT          = RESET_CAUSE_ONLINE_TIME | RESET_CAUSE_COUNTERS   //!< both, i.e. the modem rebooted
+};
+
+//************************************************************************
+// Cumulative values of one modem reply
+//************************************************************************
+typedef struct
+{
+    int64_t                     TimeMs;             //!< time of the reply, ms since epoch
+    int64_t                     OnlineTimeSeconds;  //!< online time, -1 if not reported
+    uint64_t                    TxPackets;          //!< transmitted packets
+    uint64_t                    TxBytes;            //!< transmitted bytes
+    uint64_t                    RxPackets;          //!< received packets
+    uint64_t                    RxBytes;            //!< received bytes
+}CounterReading;
+
+//************************************************************************
+// Detected reset
+//************************************************************************
+typedef struct
+{
+    int64_t                     TimeMs;                     //!< time of the first reply after the reset
+    uint8_t                     Causes;                     //!< ResetCause bits
+    int64_t                     PreviousOnlineTimeSeconds;  //!< online time before the reset
+    int64_t                     OnlineTimeSeconds;          //!< online time after the reset
+}ResetEvent;
+
+//************************************************************************
+// Class for detecting resets of the cumulative values of a modem. The
+// online time is expected to advance with the wall clock, and the traffic
+// counters never to decrease. The increments since the previous reply
+// count a reset counter from zero, so that throughput computed from them
+// does not spike, or go negative, when the counters restart.
+//************************************************************************
+class RebootDetector
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        static const int64_t ONLINE_TIME_TOLERANCE_S = 5;   //!< online time lag accepted before a restart is assumed
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        RebootDetector();
+
+        static const char* causeName
+            (
+            const uint8_t   aCauses             //!< ResetCause bits
+            );
+
+        const CounterReading& increments() const;
+
+        const std::vector<ResetEvent>& events() const;
+
+        uint8_t update
+            (
+            const CounterReading& aReading      //!< values of the new reply
+            );
+
+    private:
+        static uint64_t increment
+            (
+            const uint64_t  aPrevious,          //!< previous counter value
+            const uint64_t  aCurrent,           //!< current counter value
+            bool&           aReset              //!< set if the counter went backwards
+            );
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        CounterReading              mPrevious;      //!< values of the previous reply
+        bool                        mHasPrevious;   //!< true if mPrevious is set
+        CounterReading              mIncrements;    //!< increments since the previous reply
+        std::vector<ResetEvent>     mEvents;        //!< detected resets, in time order
+};
+
+#endif // RebootDetector_h
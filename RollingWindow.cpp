@@ -0,0 +1,228 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+RollingWindow.cpp
+
+This file contains the sources for the rolling statistics over a
+time window.
+*/
+
+#include "RollingWindow.h"
+
+#include <math.h>
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+RollingWindow::RollingWindow
+    (
+    const int64_t   aDurationMs,    //!< window length
+    const int       aBucketCount    //!< number of buckets the window is cut into
+    )
+    : mBuckets( aBucketCount > 0 ? aBucketCount : 1 )
+    , mBucketMs( aDurationMs / static_cast<int64_t>( mBuckets.size() ) )
+    , mCurrent( -1 )
+    , mCount( 0 )
+    , mSum( 0.0 )
+    , mSumSquares( 0.0 )
+{
+    if( mBucketMs <= 0 )
+    {
+        mBucketMs = 1;
+    }
+
+    clear();
+}
+
+//!************************************************************************
+//! Add a sample. Samples older than the newest bucket are counted in the
+//! newest bucket.
+//!
+//! @returns: nothing
+//!************************************************************************
+void RollingWindow::add
+    (
+    const int64_t   aTimeMs,        //!< time of the sample, ms since epoch
+    const double    aValue          //!< sample
+    )
+{
+    advance( aTimeMs );
+
+    Bucket& bucket = mBuckets[mCurrent % mBuckets.size()];
+
+    if( bucket.Index != mCurrent )
+    {
+        bucket.Index = mCurrent;
+        bucket.Count = 0;
+        bucket.Sum = 0.0;
+        bucket.SumSquares = 0.0;
+        bucket.Min = aValue;
+    }
+
+    bucket.Count++;
+    bucket.Sum += aValue;
+    bucket.SumSquares += aValue * aValue;
+
+    if( aValue < bucket.Min )
+    {
+        bucket.Min = aValue;
+    }
+
+    mCount++;
+    mSum += aValue;
+    mSumSquares += aValue * aValue;
+}
+
+//!************************************************************************
+//! Slide the window to a time, dropping the buckets that fell out of it.
+//! The window totals are summed again from the buckets left, so rounding
+//! errors do not build up.
+//!
+//! @returns: nothing
+//!************************************************************************
+void RollingWindow::advance
+    (
+    const int64_t   aTimeMs         //!< current time, ms since epoch
+    )
+{
+    const int64_t index = aTimeMs / mBucketMs;
+
+    if( index <= mCurrent )
+    {
+        return;
+    }
+
+    const int64_t oldest = index - static_cast<int64_t>( mBuckets.size() ) + 1;
+    bool dropped = false;
+
+    for( size_t i = 0; i < mBuckets.size(); i++ )
+    {
+        Bucket& bucket = mBuckets[i];
+
+        if( bucket.Index >= 0 && bucket.Index < oldest )
+        {
+            bucket.Index = -1;
+            bucket.Count = 0;
+            dropped = true;
+        }
+    }
+
+    mCurrent = index;
+
+    if( dropped )
+    {
+        mCount = 0;
+        mSum = 0.0;
+        mSumSquares = 0.0;
+
+        for( size_t i = 0; i < mBuckets.size(); i++ )
+        {
+            const Bucket& bucket = mBuckets[i];
+
+            if( bucket.Index >= 0 )
+            {
+                mCount += bucket.Count;
+                mSum += bucket.Sum;
+                mSumSquares += bucket.SumSquares;
+            }
+        }
+    }
+}
+
+//!************************************************************************
+//! Drop all samples
+//!
+//! @returns: nothing
+//!************************************************************************
+void RollingWindow::clear()
+{
+    for( size_t i = 0; i < mBuckets.size(); i++ )
+    {
+        mBuckets[i].Index = -1;
+        mBuckets[i].Count = 0;
+        mBuckets[i].Sum = 0.0;
+        mBuckets[i].SumSquares = 0.0;
+        mBuckets[i].Min = 0.0;
+    }
+
+    mCurrent = -1;
+    mCount = 0;
+    mSum = 0.0;
+    mSumSquares = 0.0;
+}
+
+//!************************************************************************
+//! Get the number of samples in the window
+//!
+//! @returns: the sample count
+//!************************************************************************
+uint32_t RollingWindow::count() const
+{
+    return mCount;
+}
+
+//!************************************************************************
+//! Get the mean of the window
+//!
+//! @returns: the mean, or NaN if the window is empty
+//!************************************************************************
+double RollingWindow::mean() const
+{
+    return mCount > 0 ? mSum / mCount : NAN;
+}
+
+//!************************************************************************
+//! Get the minimum of the window
+//!
+//! @returns: the smallest sample, or NaN if the window is empty
+//!************************************************************************
+double RollingWindow::min() const
+{
+    double minimum = NAN;
+
+    for( size_t i = 0; i < mBuckets.size(); i++ )
+    {
+        const Bucket& bucket = mBuckets[i];
+
+        if( bucket.Index >= 0 && bucket.Count > 0 && !( bucket.Min >= minimum ) )
+        {
+            minimum = bucket.Min;
+        }
+    }
+
+    return minimum;
+}
+
+//!************************************************************************
+//! Get the standard deviation of the window
+//!
+//! @returns: the population standard deviation, or NaN if the window is empty
+//!************************************************************************
+double RollingWindow::standardDeviation() const
+{
+    if( 0 == mCount )
+    {
+        return NAN;
+    }
+
+    const double average = mSum / mCount;
+    const double variance = mSumSquares / mCount - average * average;
+
+    return variance > 0.0 ? sqrt( variance ) : 0.0;
+}
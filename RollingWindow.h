@@ -0,0 +1,96 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+RollingWindow.h
+
+This file contains the definitions for the rolling statistics over a
+time window.
+*/
+
+#ifndef RollingWindow_h
+#define RollingWindow_h
+
+#include <cstdint>
+#include <vector>
+
+
+//************************************************************************
+// Class for the mean, variance and minimum of the samples of the last
+// time window. The window is cut into a fixed number of buckets holding
+// only sums, so its memory and the cost of a sample do not depend on the
+// sample rate; the window slides one bucket at a time.
+//************************************************************************
+class RollingWindow
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    private:
+        typedef struct
+        {
+            int64_t                     Index;          //!< bucket number since epoch, -1 if empty
+            uint32_t                    Count;          //!< number of samples
+            double                      Sum;            //!< sum of the samples
+            double                      SumSquares;     //!< sum of the squared samples
+            double                      Min;            //!< smallest sample
+        }Bucket;
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        RollingWindow
+            (
+            const int64_t   aDurationMs,    //!< window length
+            const int       aBucketCount    //!< number of buckets the window is cut into
+            );
+
+        void add
+            (
+            const int64_t   aTimeMs,        //!< time of the sample, ms since epoch
+            const double    aValue          //!< sample
+            );
+
+        void advance
+            (
+            const int64_t   aTimeMs         //!< current time, ms since epoch
+            );
+
+        void clear();
+
+        uint32_t count() const;
+
+        double mean() const;
+
+        double min() const;
+
+        double standardDeviation() const;
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        std::vector<Bucket>         mBuckets;       //!< ring of buckets
+        int64_t                     mBucketMs;      //!< time covered by a bucket
+        int64_t                     mCurrent;       //!< number of the newest bucket, -1 before the first sample
+        uint32_t                    mCount;         //!< number of samples in the window
+        double                      mSum;           //!< sum of the samples in the window
+        double                      mSumSquares;    //!< sum of the squared samples in the window
+};
+
+#endif // RollingWindow_h
@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+RollupArchive.cpp
+
+This file contains the sources for keeping the completed rollup
+buckets.
+*/
+
+#include "RollupArchive.h"
+
+
+const size_t RollupArchive::DEFAULT_CAPACITY[ROLLUP_LEVEL_COUNT] =
+{
+    7 * 24 * 60,                    // ROLLUP_LEVEL_MINUTE
+    366 * 24,                       // ROLLUP_LEVEL_HOUR
+    10 * 366                        // ROLLUP_LEVEL_DAY
+};
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+RollupArchive::RollupArchive()
+{
+    for( int level = 0; level < ROLLUP_LEVEL_COUNT; level++ )
+    {
+        mCapacity[level] = DEFAULT_CAPACITY[level];
+    }
+}
+
+//!************************************************************************
+//! Add a completed bucket, overwriting the oldest one of its terminal
+//! and level when the ring is full. Buckets come in time order from the
+//! rollup engine.
+//!
+//! @returns: nothing
+//!************************************************************************
+void RollupArchive::add
+    (
+    const RollupBucket& aBucket     //!< completed bucket
+    )
+{
+    const size_t index = aBucket.Terminal * ROLLUP_LEVEL_COUNT + aBucket.Level;
+
+    if( index >= mRings.size() )
+    {
+        Ring ring;
+        ring.Next = 0;
+        ring.Size = 0;
+
+        mRings.resize( ( aBucket.Terminal + 1 ) * ROLLUP_LEVEL_COUNT, ring );
+    }
+
+    Ring& ring = mRings[index];
+    const size_t capacity = mCapacity[aBucket.Level];
+
+    if( ring.Buckets.size() < capacity )
+    {
+        // grow until full, then wrap
+        ring.Buckets.push_back( aBucket );
+        ring.Next = ring.Buckets.size() % capacity;
+        ring.Size = ring.Buckets.size();
+        return;
+    }
+
+    ring.Buckets[ring.Next] = aBucket;
+    ring.Next = ( ring.Next + 1 ) % capacity;
+}
+
+//!************************************************************************
+//! Get a bucket
+//!
+//! @returns: the bucket, counted from the oldest one kept
+//!************************************************************************
+const RollupBucket& RollupArchive::at
+    (
+    const size_t        aTerminal,  //!< terminal index
+    const RollupLevel   aLevel,     //!< level
+    const size_t        aIndex      //!< 0 for the oldest bucket
+    ) const
+{
+    const Ring& ring = mRings[aTerminal * ROLLUP_LEVEL_COUNT + aLevel];
+    const size_t capacity = ring.Buckets.size();
+
+    return ring.Buckets[( ring.Next + capacity - ring.Size + aIndex ) % capacity];
+}
+
+//!************************************************************************
+//! Get the number of buckets kept per terminal for a level
+//!
+//! @returns: the capacity of the rings of the level
+//!************************************************************************
+size_t RollupArchive::capacity
+    (
+    const RollupLevel   aLevel      //!< level
+    ) const
+{
+    return mCapacity[aLevel];
+}
+
+//!************************************************************************
+//! Set the number of buckets kept per terminal for a level. To be called
+//! before buckets are added.
+//!
+//! @returns: nothing
+//!************************************************************************
+void RollupArchive::setCapacity
+    (
+    const RollupLevel   aLevel,     //!< level
+    const size_t        aCapacity   //!< buckets kept per terminal
+    )
+{
+    mCapacity[aLevel] = aCapacity > 0 ? aCapacity : 1;
+}
+
+//!************************************************************************
+//! Get the number of buckets kept
+//!
+//! @returns: the number of buckets of a terminal and level
+//!************************************************************************
+size_t RollupArchive::size
+    (
+    const size_t        aTerminal,  //!< terminal index
+    const RollupLevel   aLevel      //!< level
+    ) const
+{
+    const size_t index = aTerminal * ROLLUP_LEVEL_COUNT + aLevel;
+    return index < mRings.size() ? mRings[index].Size : 0;
+}
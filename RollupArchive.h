@@ -0,0 +1,98 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+RollupArchive.h
+
+This file contains the definitions for keeping the completed rollup
+buckets.
+*/
+
+#ifndef RollupArchive_h
+#define RollupArchive_h
+
+#include <cstddef>
+#include <vector>
+
+#include "RollupEngine.h"
+
+
+//************************************************************************
+// Class for keeping the completed buckets of each terminal and level in
+// time order, in rings of fixed capacity: by default a week of minutes,
+// a year of hours and ten years of days.
+//************************************************************************
+class RollupArchive
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        static const size_t DEFAULT_CAPACITY[ROLLUP_LEVEL_COUNT];  //!< buckets kept per level
+
+    private:
+        typedef struct
+        {
+            std::vector<RollupBucket>   Buckets;    //!< ring of buckets
+            size_t                      Next;       //!< index of the next bucket to write
+            size_t                      Size;       //!< number of buckets kept
+        }Ring;
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        RollupArchive();
+
+        void add
+            (
+            const RollupBucket& aBucket     //!< completed bucket
+            );
+
+        const RollupBucket& at
+            (
+            const size_t        aTerminal,  //!< terminal index
+            const RollupLevel   aLevel,     //!< level
+            const size_t        aIndex      //!< 0 for the oldest bucket
+            ) const;
+
+        size_t capacity
+            (
+            const RollupLevel   aLevel      //!< level
+            ) const;
+
+        void setCapacity
+            (
+            const RollupLevel   aLevel,     //!< level
+            const size_t        aCapacity   //!< buckets kept per terminal
+            );
+
+        size_t size
+            (
+            const size_t        aTerminal,  //!< terminal index
+            const RollupLevel   aLevel      //!< level
+            ) const;
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        size_t                  mCapacity[ROLLUP_LEVEL_COUNT];  //!< buckets kept per terminal and level
+        std::vector<Ring>       mRings;                         //!< ROLLUP_LEVEL_COUNT rings per terminal
+};
+
+#endif // RollupArchive_h
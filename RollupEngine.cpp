@@ -0,0 +1,300 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+RollupEngine.cpp
+
+This file contains the sources for aggregating the samples into
+minute, hour and day buckets.
+*/
+
+#include "RollupEngine.h"
+
+#include <math.h>
+
+
+const int64_t RollupEngine::LEVEL_MS[ROLLUP_LEVEL_COUNT] =
+{
+    60 * 1000,                      // ROLLUP_LEVEL_MINUTE
+    3600 * 1000,                    // ROLLUP_LEVEL_HOUR
+    24 * 3600 * 1000                // ROLLUP_LEVEL_DAY
+};
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+RollupEngine::RollupEngine()
+{
+}
+
+//!************************************************************************
+//! Add a sample to the minute bucket of a terminal, completing first the
+//! buckets the sample is past. Samples older than the open minute bucket
+//! are ignored.
+//!
+//! @returns: nothing
+//!************************************************************************
+void RollupEngine::add
+    (
+    const size_t                aTerminal,  //!< terminal index
+    const MetricSample&         aSample,    //!< sample, NaN for the metrics not reported
+    std::vector<RollupBucket>&  aCompleted  //!< appended completed buckets
+    )
+{
+    advance( aTerminal, aSample.TimeMs, aCompleted );
+
+    RollupBucket& bucket = mOpen[aTerminal * ROLLUP_LEVEL_COUNT + ROLLUP_LEVEL_MINUTE];
+
+    if( bucket.StartMs < 0 )
+    {
+        open( bucket, aSample.TimeMs );
+    }
+    else if( aSample.TimeMs < bucket.StartMs )
+    {
+        return;
+    }
+
+    for( int i = 0; i < METRIC_COUNT; i++ )
+    {
+        const double value = aSample.Values[i];
+
+        if( isnan( value ) )
+        {
+            continue;
+        }
+
+        RollupAggregate& aggregate = bucket.Values[i];
+
+        if( 0 == aggregate.Count || value < aggregate.Min )
+        {
+            aggregate.Min = value;
+        }
+
+        if( 0 == aggregate.Count || value > aggregate.Max )
+        {
+            aggregate.Max = value;
+        }
+
+        aggregate.Sum += value;
+        aggregate.Last = value;
+        aggregate.Count++;
+    }
+}
+
+//!************************************************************************
+//! Add a terminal
+//!
+//! @returns: the index of the terminal
+//!************************************************************************
+size_t RollupEngine::addTerminal()
+{
+    RollupBucket bucket;
+    bucket.Terminal = terminalCount();
+    bucket.StartMs = -1;
+
+    for( int level = 0; level < ROLLUP_LEVEL_COUNT; level++ )
+    {
+        bucket.Level = static_cast<RollupLevel>( level );
+        mOpen.push_back( bucket );
+    }
+
+    return bucket.Terminal;
+}
+
+//!************************************************************************
+//! Complete the buckets of a terminal which ended before a given time,
+//! e.g. when a terminal stops reporting
+//!
+//! @returns: nothing
+//!************************************************************************
+void RollupEngine::advance
+    (
+    const size_t                aTerminal,  //!< terminal index
+    const int64_t               aTimeMs,    //!< current time, ms since epoch
+    std::vector<RollupBucket>&  aCompleted  //!< appended completed buckets
+    )
+{
+    for( int level = 0; level < ROLLUP_LEVEL_COUNT; level++ )
+    {
+        const RollupBucket& bucket = mOpen[aTerminal * ROLLUP_LEVEL_COUNT + level];
+
+        if( bucket.StartMs >= 0 && aTimeMs >= bucket.StartMs + LEVEL_MS[level] )
+        {
+            complete( aTerminal, level, aCompleted );
+        }
+    }
+}
+
+//!************************************************************************
+//! Reset an aggregate to no values
+//!
+//! @returns: nothing
+//!************************************************************************
+/* static */ void RollupEngine::clear
+    (
+    RollupAggregate&            aAggregate  //!< aggregate to reset
+    )
+{
+    aAggregate.Min = NAN;
+    aAggregate.Max = NAN;
+    aAggregate.Sum = 0.0;
+    aAggregate.Last = NAN;
+    aAggregate.Count = 0;
+}
+
+//!************************************************************************
+//! Emit an open bucket and merge it into the open bucket of the next
+//! level, which is completed first if the bucket is past it
+//!
+//! @returns: nothing
+//!************************************************************************
+void RollupEngine::complete
+    (
+    const size_t                aTerminal,  //!< terminal index
+    const int                   aLevel,     //!< level of the bucket
+    std::vector<RollupBucket>&  aCompleted  //!< appended completed buckets
+    )
+{
+    RollupBucket& bucket = mOpen[aTerminal * ROLLUP_LEVEL_COUNT + aLevel];
+    aCompleted.push_back( bucket );
+
+    if( aLevel + 1 < ROLLUP_LEVEL_COUNT )
+    {
+        RollupBucket& parent = mOpen[aTerminal * ROLLUP_LEVEL_COUNT + aLevel + 1];
+
+        if( parent.StartMs >= 0 && bucket.StartMs >= parent.StartMs + LEVEL_MS[aLevel + 1] )
+        {
+            complete( aTerminal, aLevel + 1, aCompleted );
+        }
+
+        if( parent.StartMs < 0 )
+        {
+            open( parent, bucket.StartMs );
+        }
+
+        for( int i = 0; i < METRIC_COUNT; i++ )
+        {
+            merge( parent.Values[i], bucket.Values[i] );
+        }
+    }
+
+    bucket.StartMs = -1;
+}
+
+//!************************************************************************
+//! Complete all the open buckets of a terminal, e.g. at shutdown. The
+//! partial buckets are emitted as they are; samples added afterwards go
+//! into new buckets with the same start times, to be merged with them
+//! when read.
+//!
+//! @returns: nothing
+//!************************************************************************
+void RollupEngine::flush
+    (
+    const size_t                aTerminal,  //!< terminal index
+    std::vector<RollupBucket>&  aCompleted  //!< appended completed buckets
+    )
+{
+    // a completed bucket opens its parent, which is completed next
+    for( int level = 0; level < ROLLUP_LEVEL_COUNT; level++ )
+    {
+        if( mOpen[aTerminal * ROLLUP_LEVEL_COUNT + level].StartMs >= 0 )
+        {
+            complete( aTerminal, level, aCompleted );
+        }
+    }
+}
+
+//!************************************************************************
+//! Get the mean of an aggregate
+//!
+//! @returns: the mean, NaN if there are no values
+//!************************************************************************
+/* static */ double RollupEngine::mean
+    (
+    const RollupAggregate&      aAggregate  //!< aggregate
+    )
+{
+    return aAggregate.Count > 0 ? aAggregate.Sum / aAggregate.Count : NAN;
+}
+
+//!************************************************************************
+//! Merge the aggregate of a later, shorter bucket into a longer one
+//!
+//! @returns: nothing
+//!************************************************************************
+/* static */ void RollupEngine::merge
+    (
+    RollupAggregate&            aInto,      //!< aggregate of the longer bucket
+    const RollupAggregate&      aFrom       //!< aggregate of a later, shorter bucket
+    )
+{
+    if( 0 == aFrom.Count )
+    {
+        return;
+    }
+
+    if( 0 == aInto.Count )
+    {
+        aInto = aFrom;
+        return;
+    }
+
+    if( aFrom.Min < aInto.Min )
+    {
+        aInto.Min = aFrom.Min;
+    }
+
+    if( aFrom.Max > aInto.Max )
+    {
+        aInto.Max = aFrom.Max;
+    }
+
+    aInto.Sum += aFrom.Sum;
+    aInto.Last = aFrom.Last;
+    aInto.Count += aFrom.Count;
+}
+
+//!************************************************************************
+//! Start a bucket, aligned on its length
+//!
+//! @returns: nothing
+//!************************************************************************
+void RollupEngine::open
+    (
+    RollupBucket&               aBucket,    //!< bucket to start
+    const int64_t               aTimeMs     //!< time falling in the bucket
+    )
+{
+    aBucket.StartMs = aTimeMs - aTimeMs % LEVEL_MS[aBucket.Level];
+
+    for( int i = 0; i < METRIC_COUNT; i++ )
+    {
+        clear( aBucket.Values[i] );
+    }
+}
+
+//!************************************************************************
+//! Get the number of terminals
+//!
+//! @returns: the number of terminals
+//!************************************************************************
+size_t RollupEngine::terminalCount() const
+{
+    return mOpen.size() / ROLLUP_LEVEL_COUNT;
+}
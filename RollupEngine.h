@@ -0,0 +1,148 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+RollupEngine.h
+
+This file contains the definitions for aggregating the samples into
+minute, hour and day buckets.
+*/
+
+#ifndef RollupEngine_h
+#define RollupEngine_h
+
+#include <cstdint>
+#include <vector>
+
+#include "SurfBeam2Types.h"
+
+
+enum RollupLevel
+{
+    ROLLUP_LEVEL_MINUTE,            //!< 1 min buckets
+    ROLLUP_LEVEL_HOUR,              //!< 1 h buckets
+    ROLLUP_LEVEL_DAY,               //!< 1 day buckets, UTC
+
+    ROLLUP_LEVEL_COUNT              //!< number of defined levels
+};
+
+//************************************************************************
+// Aggregate of one metric over a bucket
+//************************************************************************
+typedef struct
+{
+    double                      Min;            //!< lowest value
+    double                      Max;            //!< highest value
+    double                      Sum;            //!< sum of the values, for the mean
+    double                      Last;           //!< latest value
+    uint32_t                    Count;          //!< number of values, 0 if the metric was not reported
+}RollupAggregate;
+
+//************************************************************************
+// Completed bucket of one terminal
+//************************************************************************
+typedef struct
+{
+    size_t                      Terminal;               //!< terminal index
+    RollupLevel                 Level;                  //!< bucket length
+    int64_t                     StartMs;                //!< start of the bucket, ms since epoch
+    RollupAggregate             Values[METRIC_COUNT];   //!< aggregate of each metric
+}RollupBucket;
+
+//************************************************************************
+// Class for aggregating the samples of many terminals as they arrive.
+// Each terminal has one open bucket per level; the samples go into the
+// minute bucket, a completed minute bucket is merged into the hour
+// bucket and a completed hour bucket into the day bucket, so every
+// sample is touched once whatever the number of levels.
+//************************************************************************
+class RollupEngine
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        static const int64_t LEVEL_MS[ROLLUP_LEVEL_COUNT];     //!< bucket length of each level
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        RollupEngine();
+
+        void add
+            (
+            const size_t                aTerminal,  //!< terminal index
+            const MetricSample&         aSample,    //!< sample, NaN for the metrics not reported
+            std::vector<RollupBucket>&  aCompleted  //!< appended completed buckets
+            );
+
+        size_t addTerminal();
+
+        void advance
+            (
+            const size_t                aTerminal,  //!< terminal index
+            const int64_t               aTimeMs,    //!< current time, ms since epoch
+            std::vector<RollupBucket>&  aCompleted  //!< appended completed buckets
+            );
+
+        static void clear
+            (
+            RollupAggregate&            aAggregate  //!< aggregate to reset
+            );
+
+        void flush
+            (
+            const size_t                aTerminal,  //!< terminal index
+            std::vector<RollupBucket>&  aCompleted  //!< appended completed buckets
+            );
+
+        static double mean
+            (
+            const RollupAggregate&      aAggregate  //!< aggregate
+            );
+
+        static void merge
+            (
+            RollupAggregate&            aInto,      //!< aggregate of the longer bucket
+            const RollupAggregate&      aFrom       //!< aggregate of a later, shorter bucket
+            );
+
+        size_t terminalCount() const;
+
+    private:
+        void complete
+            (
+            const size_t                aTerminal,  //!< terminal index
+            const int                   aLevel,     //!< level of the bucket
+            std::vector<RollupBucket>&  aCompleted  //!< appended completed buckets
+            );
+
+        void open
+            (
+            RollupBucket&               aBucket,    //!< bucket to start
+            const int64_t               aTimeMs     //!< time falling in the bucket
+            );
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        std::vector<RollupBucket>       mOpen;      //!< open buckets, ROLLUP_LEVEL_COUNT per terminal, StartMs -1 if none
+};
+
+#endif // RollupEngine_h
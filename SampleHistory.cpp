@@ -0,0 +1,124 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+SampleHistory.cpp
+
+This file contains the sources for the history of the recent samples
+of a terminal.
+*/
+
+#include "SampleHistory.h"
+
+#include <math.h>
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+SampleHistory::SampleHistory
+    (
+    const size_t    aCapacity   //!< number of samples kept
+    )
+    : mSamples( aCapacity > 0 ? aCapacity : 1 )
+    , mNext( 0 )
+    , mSize( 0 )
+{
+}
+
+//!************************************************************************
+//! Get a sample
+//!
+//! @returns: the sample, counted from the oldest one kept
+//!************************************************************************
+const MetricSample& SampleHistory::at
+    (
+    const size_t    aIndex      //!< 0 for the oldest sample
+    ) const
+{
+    const size_t capacity = mSamples.size();
+    return mSamples[( mNext + capacity - mSize + aIndex ) % capacity];
+}
+
+//!************************************************************************
+//! Get the capacity
+//!
+//! @returns: the number of samples kept at most
+//!************************************************************************
+size_t SampleHistory::capacity() const
+{
+    return mSamples.size();
+}
+
+//!************************************************************************
+//! Drop all samples
+//!
+//! @returns: nothing
+//!************************************************************************
+void SampleHistory::clear()
+{
+    mNext = 0;
+    mSize = 0;
+}
+
+//!************************************************************************
+//! Get the newest sample. Must not be called on an empty history.
+//!
+//! @returns: the newest sample
+//!************************************************************************
+const MetricSample& SampleHistory::newest() const
+{
+    return mSamples[( mNext + mSamples.size() - 1 ) % mSamples.size()];
+}
+
+//!************************************************************************
+//! Add a sample, overwriting the oldest one when the ring is full
+//!
+//! @returns: nothing
+//!************************************************************************
+void SampleHistory::push
+    (
+    const MetricSample& aSample     //!< new sample, NaN for the metrics not reported
+    )
+{
+    MetricSample& entry = mSamples[mNext];
+    const MetricSample* previous = mSize > 0 ? &newest() : nullptr;
+
+    entry.TimeMs = aSample.TimeMs;
+
+    for( int i = 0; i < METRIC_COUNT; i++ )
+    {
+        entry.Values[i] = ( isnan( aSample.Values[i] ) && previous ) ? previous->Values[i] : aSample.Values[i];
+    }
+
+    mNext = ( mNext + 1 ) % mSamples.size();
+
+    if( mSize < mSamples.size() )
+    {
+        mSize++;
+    }
+}
+
+//!************************************************************************
+//! Get the number of samples kept
+//!
+//! @returns: the number of samples
+//!************************************************************************
+size_t SampleHistory::size() const
+{
+    return mSize;
+}
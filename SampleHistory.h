@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+SampleHistory.h
+
+This file contains the definitions for the history of the recent samples
+of a terminal.
+*/
+
+#ifndef SampleHistory_h
+#define SampleHistory_h
+
+#include <cstddef>
+#include <vector>
+
+#include "SurfBeam2Types.h"
+
+
+//************************************************************************
+// Class for keeping the most recent samples of a terminal in a ring of
+// fixed capacity. The modem and TRIA replies report disjoint metrics, so
+// the metrics missing from a sample are carried forward from the sample
+// before, and each entry holds the latest value of every metric.
+//************************************************************************
+class SampleHistory
+{
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        explicit SampleHistory
+            (
+            const size_t        aCapacity       //!< number of samples kept
+            );
+
+        const MetricSample& at
+            (
+            const size_t        aIndex          //!< 0 for the oldest sample
+            ) const;
+
+        size_t capacity() const;
+
+        void clear();
+
+        const MetricSample& newest() const;
+
+        void push
+            (
+            const MetricSample& aSample         //!< new sample, NaN for the metrics not reported
+            );
+
+        size_t size() const;
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        std::vector<MetricSample>   mSamples;   //!< ring of samples
+        size_t                      mNext;      //!< index of the next sample to write
+        size_t                      mSize;      //!< number of samples kept
+};
+
+#endif // SampleHistory_h
@@ -0,0 +1,149 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+SampleSchema.cpp
+
+This file contains the names and types of the decoded reply fields.
+*/
+
+#include "SampleSchema.h"
+
+#include <string.h>
+
+
+static const SchemaField MODEM_FIELDS[] =
+{
+    //  Index                                   Name                        Type
+    {   MODEM_INDEX_IP_ADDRESS,                 "ip_address",               FIELD_TYPE_TEXT         },
+    {   MODEM_INDEX_MAC_ADDRESS,                "mac_address",              FIELD_TYPE_TEXT         },
+    {   MODEM_INDEX_SW_VERSION,                 "sw_version",               FIELD_TYPE_TEXT         },
+    {   MODEM_INDEX_HW_VERSION,                 "hw_version",               FIELD_TYPE_TEXT         },
+    {   MODEM_INDEX_STATUS,                     "status",                   FIELD_TYPE_TEXT         },
+    {   MODEM_INDEX_RX_PACKETS,                 "rx_packets",               FIELD_TYPE_COUNTER      },
+    {   MODEM_INDEX_RX_BYTES,                   "rx_bytes",                 FIELD_TYPE_COUNTER      },
+    {   MODEM_INDEX_TX_PACKETS,                 "tx_packets",               FIELD_TYPE_COUNTER      },
+    {   MODEM_INDEX_TX_BYTES,                   "tx_bytes",                 FIELD_TYPE_COUNTER      },
+    {   MODEM_INDEX_ONLINE_TIME,                "online_time_s",            FIELD_TYPE_DURATION     },
+    {   MODEM_INDEX_LOSS_OF_SYNC_COUNT,         "loss_of_sync_count",       FIELD_TYPE_COUNTER      },
+    {   MODEM_INDEX_RX_SNR_DB,                  "rx_snr_db",                FIELD_TYPE_NUMBER       },
+    {   MODEM_INDEX_RX_SNR_PERCENT,             "rx_snr_percent",           FIELD_TYPE_COUNTER      },
+    {   MODEM_INDEX_SERIAL_NR,                  "serial_nr",                FIELD_TYPE_TEXT         },
+    {   MODEM_INDEX_RX_PWR_DBM,                 "rx_pwr_dbm",               FIELD_TYPE_NUMBER       },
+    {   MODEM_INDEX_RX_PWR_PERCENT,             "rx_pwr_percent",           FIELD_TYPE_COUNTER      },
+    {   MODEM_INDEX_CABLE_RESISTANCE_OHM,       "cable_resistance_ohm",     FIELD_TYPE_NUMBER       },
+    {   MODEM_INDEX_CABLE_RESISTANCE_PERCENT,   "cable_resistance_percent", FIELD_TYPE_COUNTER      },
+    {   MODEM_INDEX_ODU_TELEMETRY_STATUS,       "odu_telemetry_status",     FIELD_TYPE_TEXT         },
+    {   MODEM_INDEX_CABLE_ATTEN_DB,             "cable_atten_db",           FIELD_TYPE_NUMBER       },
+    {   MODEM_INDEX_CABLE_ATTEN_PERCENT,        "cable_atten_percent",      FIELD_TYPE_COUNTER      },
+    {   MODEM_INDEX_IFL_TYPE,                   "ifl_type",                 FIELD_TYPE_TEXT         },
+    {   MODEM_INDEX_PART_NR,                    "part_nr",                  FIELD_TYPE_TEXT         },
+    {   MODEM_INDEX_MODEM_STATUS,               "modem_status",             FIELD_TYPE_TEXT         },
+    {   MODEM_INDEX_SATELLITE_STATUS,           "satellite_status",         FIELD_TYPE_TEXT         },
+    {   MODEM_INDEX_CLIENT_SIDE_PROXY_STATUS,   "csp_status",               FIELD_TYPE_TEXT         },
+    {   MODEM_INDEX_CLIENT_SIDE_PROXY_HEALTH,   "csp_health",               FIELD_TYPE_TEXT         },
+    {   MODEM_INDEX_LAST_PAGE_LOAD_DURATION,    "last_page_load",           FIELD_TYPE_TEXT         },
+    {   MODEM_INDEX_UPLINK_SYMBOL_RATE,         "uplink_symbol_rate",       FIELD_TYPE_COUNTER      },
+    {   MODEM_INDEX_BDT_VERSION,                "bdt_version",              FIELD_TYPE_TEXT         },
+    {   MODEM_INDEX_VENDOR,                     "vendor",                   FIELD_TYPE_TEXT         },
+    {   MODEM_INDEX_DOWNLINK_SYMBOL_RATE,       "downlink_symbol_rate",     FIELD_TYPE_COUNTER      },
+    {   MODEM_INDEX_DOWNLINK_MODULATION,        "downlink_modulation",      FIELD_TYPE_TEXT         }
+};
+
+static const SchemaField TRIA_FIELDS[] =
+{
+    //  Index                                   Name                        Type
+    {   TRIA_INDEX_PWR_MODE,                    "pwr_mode",                 FIELD_TYPE_TEXT         },
+    {   TRIA_INDEX_POLARIZATION_TYPE,           "polarization_type",        FIELD_TYPE_TEXT         },
+    {   TRIA_INDEX_TX_IF_PWR_DBM,               "tx_if_pwr_dbm",            FIELD_TYPE_NUMBER       },
+    {   TRIA_INDEX_IFL_TYPE,                    "tria_ifl_type",            FIELD_TYPE_TEXT         },
+    {   TRIA_INDEX_TEMPERATURE_C,               "temperature_c",            FIELD_TYPE_NUMBER       },
+    {   TRIA_INDEX_SERIAL_NR,                   "tria_serial_nr",           FIELD_TYPE_TEXT         },
+    {   TRIA_INDEX_TX_RF_PWR_DBM,               "tx_rf_pwr_dbm",            FIELD_TYPE_NUMBER       },
+    {   TRIA_INDEX_FW_VERSION,                  "tria_fw_version",          FIELD_TYPE_TEXT         },
+    {   TRIA_INDEX_TX_IF_PWR_PERCENT,           "tx_if_pwr_percent",        FIELD_TYPE_COUNTER      },
+    {   TRIA_INDEX_TX_RF_PWR_PERCENT,           "tx_rf_pwr_percent",        FIELD_TYPE_COUNTER      },
+    {   TRIA_INDEX_SATELLITE_STATUS,            "tria_satellite_status",    FIELD_TYPE_TEXT         },
+    {   TRIA_INDEX_VENDOR,                      "tria_vendor",              FIELD_TYPE_TEXT         }
+};
+
+
+//!************************************************************************
+//! Get the number of decoded fields of an endpoint
+//!
+//! @returns: the number of fields
+//!************************************************************************
+/* static */ int SampleSchema::fieldCount
+    (
+    const Endpoint  aSource         //!< endpoint
+    )
+{
+    return ( ENDPOINT_TRIA == aSource )
+           ? static_cast<int>( sizeof( TRIA_FIELDS ) / sizeof( TRIA_FIELDS[0] ) )
+           : static_cast<int>( sizeof( MODEM_FIELDS ) / sizeof( MODEM_FIELDS[0] ) );
+}
+
+//!************************************************************************
+//! Get the decoded fields of an endpoint
+//!
+//! @returns: fieldCount() fields, in the order of their position
+//!************************************************************************
+/* static */ const SchemaField* SampleSchema::fields
+    (
+    const Endpoint  aSource         //!< endpoint
+    )
+{
+    return ( ENDPOINT_TRIA == aSource ) ? TRIA_FIELDS : MODEM_FIELDS;
+}
+
+//!************************************************************************
+//! Look up a field by name
+//!
+//! @returns: the field, or nullptr if the endpoint has no such field
+//!************************************************************************
+/* static */ const SchemaField* SampleSchema::find
+    (
+    const Endpoint  aSource,        //!< endpoint
+    const char*     aName           //!< field name
+    )
+{
+    const SchemaField* schemaFields = fields( aSource );
+    const int count = fieldCount( aSource );
+
+    for( int i = 0; i < count; i++ )
+    {
+        if( 0 == strcmp( schemaFields[i].Name, aName ) )
+        {
+            return &schemaFields[i];
+        }
+    }
+
+    return nullptr;
+}
+
+//!************************************************************************
+//! Get the name of an endpoint
+//!
+//! @returns: "modem" or "tria"
+//!************************************************************************
+/* static */ const char* SampleSchema::sourceName
+    (
+    const Endpoint  aSource         //!< endpoint
+    )
+{
+    return ( ENDPOINT_TRIA == aSource ) ? "tria" : "modem";
+}
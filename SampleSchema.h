@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+SampleSchema.h
+
+This file contains the names and types of the decoded reply fields.
+*/
+
+#ifndef SampleSchema_h
+#define SampleSchema_h
+
+#include "SurfBeam2Types.h"
+
+
+enum FieldType
+{
+    FIELD_TYPE_TEXT,                //!< text, exported as is
+    FIELD_TYPE_NUMBER,              //!< decimal number
+    FIELD_TYPE_COUNTER,             //!< unsigned integer
+    FIELD_TYPE_DURATION,            //!< "[N days ]hh:mm:ss", exported in seconds
+
+    FIELD_TYPE_COUNT                //!< number of defined field types
+};
+
+//************************************************************************
+// Decoded field of a reply
+//************************************************************************
+typedef struct
+{
+    int                         Index;          //!< position in the reply
+    const char*                 Name;           //!< name used by the exporters
+    FieldType                   Type;           //!< type of the value
+}SchemaField;
+
+//************************************************************************
+// Class for describing the fields decoded from the replies of each
+// endpoint, in the order of their position in the reply. The names are
+// the keys and column headers of the exported samples.
+//************************************************************************
+class SampleSchema
+{
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        static int fieldCount
+            (
+            const Endpoint  aSource         //!< endpoint
+            );
+
+        static const SchemaField* fields
+            (
+            const Endpoint  aSource         //!< endpoint
+            );
+
+        static const SchemaField* find
+            (
+            const Endpoint  aSource,        //!< endpoint
+            const char*     aName           //!< field name
+            );
+
+        static const char* sourceName
+            (
+            const Endpoint  aSource         //!< endpoint
+            );
+};
+
+#endif // SampleSchema_h
@@ -0,0 +1,70 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+SampleSink.h
+
+This file contains the definitions for the receivers of published samples.
+*/
+
+#ifndef SampleSink_h
+#define SampleSink_h
+
+#include <cstdint>
+
+#include "CgiPayload.h"
+#include "SurfBeam2Types.h"
+
+
+const int DELTA_MAX_FIELDS = 128;                   //!< fields a delta can describe
+const int DELTA_WORDS = DELTA_MAX_FIELDS / 64;      //!< words of the changed field bitmap
+
+//************************************************************************
+// Reply of one terminal endpoint, as published: the fields that changed
+// since the previous reply, or all of them for a keyframe
+//************************************************************************
+typedef struct
+{
+    size_t                      Terminal;               //!< terminal index
+    Endpoint                    Source;                 //!< endpoint of the reply
+    int64_t                     TimeMs;                 //!< time of the reply, ms since epoch
+    bool                        Keyframe;               //!< true if every field is flagged
+    uint8_t                     Resets;                 //!< ResetCause bits detected with the reply, 0 if none
+    int                         FieldCount;             //!< number of fields in the reply
+    uint64_t                    Changed[DELTA_WORDS];   //!< changed fields, bit i of word i / 64 for field i
+    const CgiPayload*           Payload;                //!< split reply, valid during the publish call only
+}SampleDelta;
+
+//************************************************************************
+// Interface of the receivers of published samples, e.g. an archive or an
+// exporter
+//************************************************************************
+class SampleSink
+{
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        virtual ~SampleSink() {}
+
+        virtual void publish
+            (
+            const SampleDelta&  aDelta      //!< changed fields of a reply
+            ) = 0;
+};
+
+#endif // SampleSink_h
@@ -0,0 +1,594 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+SampleStore.cpp
+
+This file contains the sources for the SQLite history of the
+published samples.
+*/
+
+#include "SampleStore.h"
+
+#include "DeltaPublisher.h"
+
+#include <QDate>
+#include <QDebug>
+#include <QSqlError>
+#include <QStringList>
+
+
+const int SampleStore::BATCH_SAMPLES;
+const int64_t SampleStore::BATCH_MS;
+const int64_t SampleStore::ONE_DAY_MS;
+
+static const char* const COLUMN_TYPES[FIELD_TYPE_COUNT] =
+{
+    "TEXT",         // FIELD_TYPE_TEXT
+    "REAL",         // FIELD_TYPE_NUMBER
+    "INTEGER",      // FIELD_TYPE_COUNTER
+    "INTEGER"       // FIELD_TYPE_DURATION
+};
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+SampleStore::SampleStore()
+    : mConnection( "SampleStore" + QString::number( reinterpret_cast<quintptr>( this ) ) )
+    , mRetentionDays( 0 )
+    , mInTransaction( false )
+    , mBatchCount( 0 )
+    , mBatchStartMs( 0 )
+{
+    for( int i = 0; i < ENDPOINT_COUNT; i++ )
+    {
+        mDay[i] = -1;
+    }
+}
+
+//!************************************************************************
+//! Destructor
+//!************************************************************************
+SampleStore::~SampleStore()
+{
+    close();
+}
+
+//!************************************************************************
+//! Add a completed rollup bucket, one row per reported metric
+//!
+//! @returns: nothing
+//!************************************************************************
+void SampleStore::addRollup
+    (
+    const RollupBucket& aBucket         //!< completed bucket
+    )
+{
+    if( !isOpen() )
+    {
+        return;
+    }
+
+    begin( aBucket.StartMs );
+
+    QSqlQuery& insert = mRollupInsert[aBucket.Level];
+
+    for( int i = 0; i < METRIC_COUNT; i++ )
+    {
+        const RollupAggregate& aggregate = aBucket.Values[i];
+
+        if( 0 == aggregate.Count )
+        {
+            continue;
+        }
+
+        insert.bindValue( 0, static_cast<qlonglong>( aBucket.StartMs ) );
+        insert.bindValue( 1, static_cast<qulonglong>( aBucket.Terminal ) );
+        insert.bindValue( 2, i );
+        insert.bindValue( 3, aggregate.Min );
+        insert.bindValue( 4, aggregate.Max );
+        insert.bindValue( 5, RollupEngine::mean( aggregate ) );
+        insert.bindValue( 6, aggregate.Last );
+        insert.bindValue( 7, aggregate.Count );
+
+        if( !insert.exec() )
+        {
+            qWarning() << "History rollup insert failed:" << insert.lastError().text();
+        }
+
+        mBatchCount++;
+    }
+}
+
+//!************************************************************************
+//! Open a batch if none is open
+//!
+//! @returns: nothing
+//!************************************************************************
+void SampleStore::begin
+    (
+    const int64_t       aTimeMs         //!< time of the first row
+    )
+{
+    if( !mInTransaction )
+    {
+        mInTransaction = database().transaction();
+        mBatchStartMs = aTimeMs;
+    }
+}
+
+//!************************************************************************
+//! Commit the open batch and close the database
+//!
+//! @returns: nothing
+//!************************************************************************
+void SampleStore::close()
+{
+    if( !QSqlDatabase::contains( mConnection ) )
+    {
+        return;
+    }
+
+    commit();
+
+    for( int i = 0; i < ENDPOINT_COUNT; i++ )
+    {
+        mInsert[i] = QSqlQuery();
+        mDay[i] = -1;
+        mValues[i].clear();
+    }
+
+    for( int i = 0; i < ROLLUP_LEVEL_COUNT; i++ )
+    {
+        mRollupInsert[i] = QSqlQuery();
+    }
+
+    {
+        QSqlDatabase db = database();
+        db.close();
+    }
+
+    QSqlDatabase::removeDatabase( mConnection );
+}
+
+//!************************************************************************
+//! Commit the open batch
+//!
+//! @returns: nothing
+//!************************************************************************
+void SampleStore::commit()
+{
+    if( !mInTransaction )
+    {
+        return;
+    }
+
+    QSqlDatabase db = database();
+
+    if( !db.commit() )
+    {
+        qWarning() << "History store commit failed:" << db.lastError().text();
+    }
+
+    mInTransaction = false;
+    mBatchCount = 0;
+}
+
+//!************************************************************************
+//! Commit the open batch if it is older than BATCH_MS, for when no rows
+//! are added for a while
+//!
+//! @returns: nothing
+//!************************************************************************
+void SampleStore::commitIfDue
+    (
+    const int64_t       aTimeMs         //!< current time, ms since epoch
+    )
+{
+    if( mInTransaction && aTimeMs - mBatchStartMs >= BATCH_MS )
+    {
+        commit();
+    }
+}
+
+//!************************************************************************
+//! Get the database connection, e.g. for the history queries
+//!
+//! @returns: the connection, invalid if the store is not open
+//!************************************************************************
+QSqlDatabase SampleStore::database() const
+{
+    return QSqlDatabase::database( mConnection, false );
+}
+
+//!************************************************************************
+//! Drop the tables of the days before a given day
+//!
+//! @returns: nothing
+//!************************************************************************
+void SampleStore::expire
+    (
+    const int64_t       aOldestDay      //!< oldest day kept, days since epoch
+    )
+{
+    QSqlDatabase db = database();
+    const QStringList tables = db.tables();
+
+    for( int source = 0; source < ENDPOINT_COUNT; source++ )
+    {
+        const QString prefix = QString( SampleSchema::sourceName( static_cast<Endpoint>( source ) ) ) + "_";
+
+        for( int i = 0; i < tables.size(); i++ )
+        {
+            if( !tables[i].startsWith( prefix ) )
+            {
+                continue;
+            }
+
+            const QDate date = QDate::fromString( tables[i].mid( prefix.size() ), "yyyyMMdd" );
+
+            if( date.isValid() && QDate( 1970, 1, 1 ).daysTo( date ) < aOldestDay )
+            {
+                QSqlQuery drop( db );
+
+                if( !drop.exec( "DROP TABLE " + tables[i] ) )
+                {
+                    qWarning() << "History table" << tables[i] << "could not be dropped:" << drop.lastError().text();
+                }
+            }
+        }
+    }
+}
+
+//!************************************************************************
+//! Check whether samples are stored
+//!
+//! @returns: true if the database is open
+//!************************************************************************
+bool SampleStore::isOpen() const
+{
+    return database().isOpen();
+}
+
+//!************************************************************************
+//! Read the stored rollup buckets back into an archive, e.g. at startup,
+//! as far back as the archive keeps each level. The rows of a bucket,
+//! one per reported metric, are grouped again. The buckets open at
+//! shutdown are stored partly (see RollupEngine::flush()) and completed
+//! under the same start after the restart; their rows are merged, in
+//! insertion order so that the last value is the latest one.
+//!
+//! @returns: the number of buckets loaded
+//!************************************************************************
+size_t SampleStore::loadRollups
+    (
+    RollupArchive&      aArchive,       //!< archive to fill, before any bucket is added
+    const int64_t       aTimeMs         //!< current time, ms since epoch
+    ) const
+{
+    size_t loaded = 0;
+
+    if( !isOpen() )
+    {
+        return loaded;
+    }
+
+    for( int level = 0; level < ROLLUP_LEVEL_COUNT; level++ )
+    {
+        const RollupLevel rollupLevel = static_cast<RollupLevel>( level );
+        const int64_t fromMs = aTimeMs - static_cast<int64_t>( aArchive.capacity( rollupLevel ) ) * RollupEngine::LEVEL_MS[level];
+
+        QSqlQuery query( database() );
+        query.setForwardOnly( true );
+        query.prepare( "SELECT start_ms, terminal, metric, min, max, mean, last, count FROM " + rollupTableName( rollupLevel )
+                       + " WHERE start_ms >= ? ORDER BY terminal, start_ms, rowid" );
+        query.bindValue( 0, static_cast<qlonglong>( fromMs ) );
+
+        if( !query.exec() )
+        {
+            qWarning() << "History rollups could not be read:" << query.lastError().text();
+            continue;
+        }
+
+        RollupBucket bucket;
+        bool pending = false;
+
+        while( query.next() )
+        {
+            const int64_t startMs = query.value( 0 ).toLongLong();
+            const size_t terminal = static_cast<size_t>( query.value( 1 ).toULongLong() );
+            const int metric = query.value( 2 ).toInt();
+
+            if( pending && ( terminal != bucket.Terminal || startMs != bucket.StartMs ) )
+            {
+                aArchive.add( bucket );
+                loaded++;
+                pending = false;
+            }
+
+            if( !pending )
+            {
+                bucket.Terminal = terminal;
+                bucket.Level = rollupLevel;
+                bucket.StartMs = startMs;
+
+                for( int i = 0; i < METRIC_COUNT; i++ )
+                {
+                    RollupEngine::clear( bucket.Values[i] );
+                }
+
+                pending = true;
+            }
+
+            if( metric < 0 || metric >= METRIC_COUNT )
+            {
+                continue;
+            }
+
+            RollupAggregate aggregate;
+            aggregate.Min = query.value( 3 ).toDouble();
+            aggregate.Max = query.value( 4 ).toDouble();
+            aggregate.Last = query.value( 6 ).toDouble();
+            aggregate.Count = query.value( 7 ).toUInt();
+            aggregate.Sum = query.value( 5 ).toDouble() * aggregate.Count;
+
+            RollupEngine::merge( bucket.Values[metric], aggregate );
+        }
+
+        if( pending )
+        {
+            aArchive.add( bucket );
+            loaded++;
+        }
+    }
+
+    return loaded;
+}
+
+//!************************************************************************
+//! Open the database, creating it if needed, and switch it to WAL mode
+//!
+//! @returns: true if the database could be opened
+//!************************************************************************
+bool SampleStore::open
+    (
+    const QString&      aPath,          //!< database file
+    const int           aRetentionDays  //!< days of history kept, 0 to keep all
+    )
+{
+    close();
+
+    mRetentionDays = aRetentionDays;
+
+    QSqlDatabase db = QSqlDatabase::addDatabase( "QSQLITE", mConnection );
+    db.setDatabaseName( aPath );
+
+    if( !db.open() )
+    {
+        qWarning() << "History store" << aPath << "could not be opened:" << db.lastError().text();
+        return false;
+    }
+
+    QSqlQuery pragma( db );
+    pragma.exec( "PRAGMA journal_mode=WAL" );
+    pragma.exec( "PRAGMA synchronous=NORMAL" );
+
+    for( int level = 0; level < ROLLUP_LEVEL_COUNT; level++ )
+    {
+        const QString table = rollupTableName( static_cast<RollupLevel>( level ) );
+        QSqlQuery query( db );
+
+        if( !query.exec( "CREATE TABLE IF NOT EXISTS " + table
+                         + " (start_ms INTEGER NOT NULL, terminal INTEGER NOT NULL, metric INTEGER NOT NULL,"
+                           " min REAL, max REAL, mean REAL, last REAL, count INTEGER)" )
+         || !query.exec( "CREATE INDEX IF NOT EXISTS " + table + "_terminal_metric_start ON " + table + " (terminal, metric, start_ms)" ) )
+        {
+            qWarning() << "History table" << table << "could not be created:" << query.lastError().text();
+            return false;
+        }
+
+        mRollupInsert[level] = QSqlQuery( db );
+        mRollupInsert[level].prepare( "INSERT INTO " + table + " VALUES (?, ?, ?, ?, ?, ?, ?, ?)" );
+    }
+
+    return true;
+}
+
+//!************************************************************************
+//! Prepare the insert into the table of a day, creating the table if
+//! needed. Creating a table also expires the days beyond the retention.
+//!
+//! @returns: true if the insert is prepared
+//!************************************************************************
+bool SampleStore::prepareDay
+    (
+    const Endpoint      aSource,        //!< endpoint
+    const int64_t       aDay            //!< day, days since epoch
+    )
+{
+    QSqlDatabase db = database();
+    const QString table = tableName( aSource, aDay );
+    const SchemaField* fields = SampleSchema::fields( aSource );
+    const int fieldCount = SampleSchema::fieldCount( aSource );
+
+    QString create = "CREATE TABLE IF NOT EXISTS " + table + " (time_ms INTEGER NOT NULL, terminal INTEGER NOT NULL";
+    QString insert = "INSERT INTO " + table + " VALUES (?, ?";
+
+    for( int i = 0; i < fieldCount; i++ )
+    {
+        create += QString( ", " ) + fields[i].Name + " " + COLUMN_TYPES[fields[i].Type];
+        insert += ", ?";
+    }
+
+    create += ")";
+    insert += ")";
+
+    QSqlQuery query( db );
+
+    if( !query.exec( create )
+     || !query.exec( "CREATE INDEX IF NOT EXISTS " + table + "_terminal_time ON " + table + " (terminal, time_ms)" ) )
+    {
+        qWarning() << "History table" << table << "could not be created:" << query.lastError().text();
+        return false;
+    }
+
+    mInsert[aSource] = QSqlQuery( db );
+
+    if( !mInsert[aSource].prepare( insert ) )
+    {
+        qWarning() << "History insert into" << table << "could not be prepared:" << mInsert[aSource].lastError().text();
+        return false;
+    }
+
+    mDay[aSource] = aDay;
+
+    if( mRetentionDays > 0 )
+    {
+        expire( aDay - mRetentionDays + 1 );
+    }
+
+    return true;
+}
+
+//!************************************************************************
+//! Add a row with the latest value of every field of a terminal
+//!
+//! @returns: nothing
+//!************************************************************************
+void SampleStore::publish
+    (
+    const SampleDelta&  aDelta          //!< changed fields of a reply
+    )
+{
+    if( !isOpen() )
+    {
+        return;
+    }
+
+    const Endpoint source = aDelta.Source;
+    const int64_t day = aDelta.TimeMs / ONE_DAY_MS;
+
+    if( day != mDay[source] )
+    {
+        commit();
+
+        if( !prepareDay( source, day ) )
+        {
+            return;
+        }
+    }
+
+    const SchemaField* fields = SampleSchema::fields( source );
+    const int fieldCount = SampleSchema::fieldCount( source );
+
+    std::vector<std::vector<QVariant>>& terminals = mValues[source];
+
+    while( terminals.size() <= aDelta.Terminal )
+    {
+        terminals.push_back( std::vector<QVariant>( fieldCount ) );
+    }
+
+    std::vector<QVariant>& values = terminals[aDelta.Terminal];
+    const CgiPayload& payload = *aDelta.Payload;
+
+    for( int i = 0; i < fieldCount; i++ )
+    {
+        const int index = fields[i].Index;
+
+        if( index >= aDelta.FieldCount || !DeltaPublisher::isChanged( aDelta, index ) )
+        {
+            continue;
+        }
+
+        const char* data = payload.fieldData( index );
+        const int length = payload.fieldLength( index );
+
+        switch( fields[i].Type )
+        {
+            case FIELD_TYPE_NUMBER:
+                values[i] = ( length > 0 ) ? QVariant( CgiPayload::parseDouble( data, length ) ) : QVariant();
+                break;
+
+            case FIELD_TYPE_COUNTER:
+                values[i] = ( length > 0 ) ? QVariant( static_cast<qulonglong>( CgiPayload::parseUnsigned( data, length ) ) ) : QVariant();
+                break;
+
+            case FIELD_TYPE_DURATION:
+                {
+                    const int64_t seconds = CgiPayload::parseDuration( data, length );
+                    values[i] = ( seconds >= 0 ) ? QVariant( static_cast<qlonglong>( seconds ) ) : QVariant();
+                }
+                break;
+
+            default:
+                values[i] = QString::fromUtf8( data, length );
+                break;
+        }
+    }
+
+    begin( aDelta.TimeMs );
+
+    QSqlQuery& insert = mInsert[source];
+    insert.bindValue( 0, static_cast<qlonglong>( aDelta.TimeMs ) );
+    insert.bindValue( 1, static_cast<qulonglong>( aDelta.Terminal ) );
+
+    for( int i = 0; i < fieldCount; i++ )
+    {
+        insert.bindValue( i + 2, values[i] );
+    }
+
+    if( !insert.exec() )
+    {
+        qWarning() << "History insert failed:" << insert.lastError().text();
+    }
+
+    mBatchCount++;
+
+    if( mBatchCount >= BATCH_SAMPLES || aDelta.TimeMs - mBatchStartMs >= BATCH_MS )
+    {
+        commit();
+    }
+}
+
+//!************************************************************************
+//! Get the name of the table of a rollup level
+//!
+//! @returns: e.g. "rollup_minute"
+//!************************************************************************
+/* static */ QString SampleStore::rollupTableName
+    (
+    const RollupLevel   aLevel          //!< level
+    )
+{
+    const char* const LEVEL_NAMES[ROLLUP_LEVEL_COUNT] = { "rollup_minute", "rollup_hour", "rollup_day" };
+    return LEVEL_NAMES[aLevel];
+}
+
+//!************************************************************************
+//! Get the name of the table of a day
+//!
+//! @returns: e.g. "modem_20210329"
+//!************************************************************************
+/* static */ QString SampleStore::tableName
+    (
+    const Endpoint      aSource,        //!< endpoint
+    const int64_t       aDay            //!< day, days since epoch
+    )
+{
+    return QString( SampleSchema::sourceName( aSource ) ) + "_" + QDate( 1970, 1, 1 ).addDays( aDay ).toString( "yyyyMMdd" );
+}
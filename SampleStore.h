@@ -0,0 +1,153 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+SampleStore.h
+
+This file contains the definitions for the SQLite history of the
+published samples.
+*/
+
+#ifndef SampleStore_h
+#define SampleStore_h
+
+#include <cstdint>
+#include <vector>
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QVariant>
+
+#include "RollupArchive.h"
+#include "RollupEngine.h"
+#include "SampleSchema.h"
+#include "SampleSink.h"
+
+
+//************************************************************************
+// Class for keeping a queryable history of the published samples in a
+// SQLite database. Every endpoint has one table per UTC day, named e.g.
+// modem_20210329, with a column per schema field, so that expiring a day
+// is a DROP TABLE. Each delta adds a row with the latest value of every
+// field of its terminal. Rows are inserted with one prepared statement
+// per table, inside transactions committed every BATCH_SAMPLES rows or
+// BATCH_MS, and the database runs in WAL mode so readers do not block
+// the inserts. Completed rollup buckets go to one table per level, with
+// a row per reported metric, and are never expired; they are read back
+// into the rollup archive at startup.
+//************************************************************************
+class SampleStore : public SampleSink
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        static const int BATCH_SAMPLES = 2000;          //!< rows per transaction
+        static const int64_t BATCH_MS = 1000;           //!< maximum duration of a transaction
+        static const int64_t ONE_DAY_MS = 24 * 3600 * 1000;   //!< length of a daily sample table [ms]
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        SampleStore();
+
+        ~SampleStore();
+
+        void addRollup
+            (
+            const RollupBucket& aBucket         //!< completed bucket
+            );
+
+        void close();
+
+        void commitIfDue
+            (
+            const int64_t       aTimeMs         //!< current time, ms since epoch
+            );
+
+        QSqlDatabase database() const;
+
+        void expire
+            (
+            const int64_t       aOldestDay      //!< oldest day kept, days since epoch
+            );
+
+        bool isOpen() const;
+
+        size_t loadRollups
+            (
+            RollupArchive&      aArchive,       //!< archive to fill, before any bucket is added
+            const int64_t       aTimeMs         //!< current time, ms since epoch
+            ) const;
+
+        bool open
+            (
+            const QString&      aPath,          //!< database file
+            const int           aRetentionDays  //!< days of history kept, 0 to keep all
+            );
+
+        void publish
+            (
+            const SampleDelta&  aDelta          //!< changed fields of a reply
+            ) override;
+
+        static QString tableName
+            (
+            const Endpoint      aSource,        //!< endpoint
+            const int64_t       aDay            //!< day, days since epoch
+            );
+
+        static QString rollupTableName
+            (
+            const RollupLevel   aLevel          //!< level
+            );
+
+    private:
+        void begin
+            (
+            const int64_t       aTimeMs         //!< time of the first row
+            );
+
+        void commit();
+
+        bool prepareDay
+            (
+            const Endpoint      aSource,        //!< endpoint
+            const int64_t       aDay            //!< day, days since epoch
+            );
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        QString                                 mConnection;                //!< name of the database connection
+        int                                     mRetentionDays;             //!< days of history kept, 0 to keep all
+
+        int64_t                                 mDay[ENDPOINT_COUNT];       //!< day of the prepared insert, -1 if none
+        QSqlQuery                               mInsert[ENDPOINT_COUNT];    //!< prepared insert of each endpoint
+        QSqlQuery                               mRollupInsert[ROLLUP_LEVEL_COUNT];  //!< prepared insert of each rollup level
+
+        std::vector<std::vector<QVariant>>      mValues[ENDPOINT_COUNT];    //!< latest field values of each terminal
+
+        bool                                    mInTransaction;             //!< true while a batch is open
+        int                                     mBatchCount;                //!< rows in the open batch
+        int64_t                                 mBatchStartMs;              //!< time of the first row of the open batch
+};
+
+#endif // SampleStore_h
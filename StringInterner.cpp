@@ -0,0 +1,172 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+StringInterner.cpp
+
+This file contains the sources for the string interning table.
+*/
+
+#include "StringInterner.h"
+
+#include <string.h>
+
+
+const uint32_t StringInterner::INITIAL_SLOT_COUNT;
+const uint32_t StringInterner::EMPTY_SLOT;
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+StringInterner::StringInterner()
+    : mSlots( INITIAL_SLOT_COUNT, EMPTY_SLOT )
+{
+}
+
+//!************************************************************************
+//! Hash raw bytes, four at a time
+//!
+//! @returns: a 32-bit hash of the bytes
+//!************************************************************************
+uint32_t StringInterner::hash
+    (
+    const char* aData,      //!< raw bytes
+    const int   aLength     //!< number of bytes
+    )
+{
+    const uint32_t PRIME_1 = 0x9E3779B1;
+    const uint32_t PRIME_2 = 0x85EBCA77;
+
+    uint32_t h = PRIME_2 ^ static_cast<uint32_t>( aLength );
+    int i = 0;
+
+    for( ; i + 4 <= aLength; i += 4 )
+    {
+        uint32_t word;
+        memcpy( &word, aData + i, sizeof( word ) );
+        h ^= word * PRIME_1;
+        h = ( ( h << 13 ) | ( h >> 19 ) ) * PRIME_2;
+    }
+
+    for( ; i < aLength; i++ )
+    {
+        h = ( h ^ static_cast<uint8_t>( aData[i] ) ) * PRIME_1;
+    }
+
+    h ^= h >> 15;
+    h *= PRIME_2;
+    h ^= h >> 13;
+
+    return h;
+}
+
+//!************************************************************************
+//! Look up raw bytes, adding them as a new value if not seen before
+//!
+//! @returns: the ID of the value
+//!************************************************************************
+StringInterner::Id StringInterner::intern
+    (
+    const char* aData,      //!< raw bytes
+    const int   aLength     //!< number of bytes
+    )
+{
+    const uint32_t h = hash( aData, aLength );
+    const uint32_t mask = static_cast<uint32_t>( mSlots.size() ) - 1;
+    uint32_t slot = h & mask;
+
+    while( EMPTY_SLOT != mSlots[slot] )
+    {
+        const Entry& entry = mEntries[mSlots[slot] - 1];
+
+        if( entry.Hash == h
+         && entry.Bytes.size() == aLength
+         && 0 == memcmp( entry.Bytes.constData(), aData, aLength ) )
+        {
+            return mSlots[slot] - 1;
+        }
+
+        slot = ( slot + 1 ) & mask;
+    }
+
+    Entry entry;
+    entry.Hash = h;
+    entry.Bytes = QByteArray( aData, aLength );
+    entry.Text = QString::fromUtf8( aData, aLength );
+    mEntries.push_back( entry );
+
+    const Id id = static_cast<Id>( mEntries.size() ) - 1;
+    mSlots[slot] = id + 1;
+
+    // keep the load factor below 1/2
+    if( 2 * mEntries.size() > mSlots.size() )
+    {
+        rehash( 2 * static_cast<uint32_t>( mSlots.size() ) );
+    }
+
+    return id;
+}
+
+//!************************************************************************
+//! Rebuild the hash table with a new number of slots
+//!
+//! @returns: nothing
+//!************************************************************************
+void StringInterner::rehash
+    (
+    const uint32_t aSlotCount   //!< new number of slots, power of 2
+    )
+{
+    mSlots.assign( aSlotCount, EMPTY_SLOT );
+    const uint32_t mask = aSlotCount - 1;
+
+    for( size_t i = 0; i < mEntries.size(); i++ )
+    {
+        uint32_t slot = mEntries[i].Hash & mask;
+
+        while( EMPTY_SLOT != mSlots[slot] )
+        {
+            slot = ( slot + 1 ) & mask;
+        }
+
+        mSlots[slot] = static_cast<uint32_t>( i ) + 1;
+    }
+}
+
+//!************************************************************************
+//! Get the number of interned values
+//!
+//! @returns: the number of distinct values seen so far
+//!************************************************************************
+int StringInterner::size() const
+{
+    return static_cast<int>( mEntries.size() );
+}
+
+//!************************************************************************
+//! Get the string of an interned value
+//!
+//! @returns: the shared string owned by the ID
+//!************************************************************************
+const QString& StringInterner::string
+    (
+    const Id    aId     //!< interned ID
+    ) const
+{
+    return mEntries.at( aId ).Text;
+}
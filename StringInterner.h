@@ -0,0 +1,98 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+StringInterner.h
+
+This file contains the definitions for the string interning table.
+*/
+
+#ifndef StringInterner_h
+#define StringInterner_h
+
+#include <cstdint>
+#include <vector>
+
+#include <QByteArray>
+#include <QString>
+
+
+//************************************************************************
+// Class for mapping raw field bytes to stable small integer IDs, each ID
+// owning one shared string. Repeated values are matched on their bytes
+// and reuse the existing string, so a new string is only allocated the
+// first time a value is seen.
+//************************************************************************
+class StringInterner
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        typedef uint32_t Id;
+
+    private:
+        static const uint32_t INITIAL_SLOT_COUNT = 64;  //!< initial hash table size, power of 2
+        static const uint32_t EMPTY_SLOT = 0;           //!< marker of an unused hash table slot
+
+        typedef struct
+        {
+            uint32_t                    Hash;
+            QByteArray                  Bytes;
+            QString                     Text;
+        }Entry;
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        StringInterner();
+
+        static uint32_t hash
+            (
+            const char* aData,          //!< raw bytes
+            const int   aLength         //!< number of bytes
+            );
+
+        Id intern
+            (
+            const char* aData,          //!< raw bytes
+            const int   aLength         //!< number of bytes
+            );
+
+        int size() const;
+
+        const QString& string
+            (
+            const Id    aId             //!< interned ID
+            ) const;
+
+    private:
+        void rehash
+            (
+            const uint32_t aSlotCount   //!< new number of slots, power of 2
+            );
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        std::vector<Entry>      mEntries;       //!< interned values, indexed by ID
+        std::vector<uint32_t>   mSlots;         //!< open addressing table with ID + 1 per slot
+};
+
+#endif // StringInterner_h
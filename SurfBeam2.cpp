@@ -24,6 +24,20 @@ This file contains the sources for the ViaSat SurfBeam 2 modem.
 #include "SurfBeam2.h"
 #include "ui_SurfBeam2.h"
 
+#include "FleetDialog.h"
+#include "HistoryQuery.h"
+#include "PercentCalibration.h"
+#include "PointingDialog.h"
+#include "PowerFormatter.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QFileDialog>
+#include <QMenuBar>
+#include <QSettings>
+#include <QStatusBar>
+#include <QStringList>
 #include <QTimer>
 #include <QtNetwork>
 
@@ -43,9 +57,94 @@ SurfBeam2::SurfBeam2
     )
     : QMainWindow( aParent )
     , mMainUi( new Ui::SurfBeam2 )
+    , mBeamColorClassifier( FieldClassifier::beamColor() )
+    , mModemStateClassifier( FieldClassifier::modemState() )
+    , mPolarizationClassifier( FieldClassifier::polarization() )
+    , mAlertTerminal( 0 )
+    , mStateTrackerTerminal( 0 )
+    , mSampleHistory( SyncLossDetector::PRE_SAMPLES + 1 )
+    , mRollupTerminal( 0 )
+    , mFleetTerminal( 0 )
+    , mBeamTerminal( 0 )
+    , mDeltaTerminal( 0 )
+    , mModemInfo()
+    , mTriaInfo()
+    , mCgiRequestTimer( nullptr )
+    , mPointingDialog( nullptr )
+    , mPointingMode( false )
+    , mFleetDialog( nullptr )
+    , mNdjsonAction( nullptr )
+    , mReplyModem( nullptr )
+    , mReplyTria( nullptr )
 {
     mMainUi->setupUi( this );
 
+    mCalibrationProfiles.load( QCoreApplication::applicationDirPath() + "/" + CALIBRATION_FILE );
+
+    const std::vector<AlertRule> alertRules = AlertEngine::defaultRules();
+
+    for( size_t i = 0; i < alertRules.size(); i++ )
+    {
+        mAlertEngine.addRule( alertRules[i] );
+    }
+
+    mAlertTerminal = mAlertEngine.addTerminal();
+
+    //****************************************
+    // consumers of the polled data
+    //****************************************
+    PollConsumer modemPanels = { "Modem panels", 0, 1u << ENDPOINT_MODEM, CGI_REQUEST_MS };
+    mPollScheduler.addConsumer( modemPanels );
+
+    PollConsumer triaPanels = { "TRIA panels", 0, 1u << ENDPOINT_TRIA, TRIA_REQUEST_MS };
+    mPollScheduler.addConsumer( triaPanels );
+
+    for( size_t i = 0; i < alertRules.size(); i++ )
+    {
+        const int64_t rulePeriodMs = alertRules[i].MinDurationMs / ALERT_SAMPLES;
+        PollConsumer alertRule = { alertRules[i].Name, 1u << alertRules[i].Watched, 0, rulePeriodMs > CGI_REQUEST_MS ? rulePeriodMs : CGI_REQUEST_MS };
+        mPollScheduler.addConsumer( alertRule );
+    }
+
+    mStateTrackerTerminal = mModemStateTracker.addTerminal();
+    mDeltaTerminal = mDeltaPublisher.addTerminal();
+    mRollupTerminal = mRollupEngine.addTerminal();
+    mFleetTerminal = mFleetModel.addTerminal( "Local modem" );
+    mBeamTerminal = mBeamAggregator.addTerminal();
+
+    CsvLoggerConfig csvConfig = CsvLogger::defaultConfig();
+    csvConfig.Path = ( QCoreApplication::applicationDirPath() + "/" + CSV_LOG_FILE ).toStdString();
+
+    if( mCsvLogger.load( QCoreApplication::applicationDirPath() + "/" + LOGGING_FILE, csvConfig ) )
+    {
+        if( mCsvLogger.open( csvConfig ) )
+        {
+            mDeltaPublisher.addSink( &mCsvLogger );
+        }
+        else
+        {
+            qWarning() << "CSV log" << csvConfig.Path.c_str() << "could not be opened";
+        }
+    }
+
+#ifdef SURFBEAM2_HISTORY_STORE
+    // [History] Enabled, Path, RetentionDays
+    QSettings logging( QCoreApplication::applicationDirPath() + "/" + LOGGING_FILE, QSettings::IniFormat );
+
+    if( logging.value( "History/Enabled", false ).toBool() )
+    {
+        const QString historyPath = logging.value( "History/Path", QCoreApplication::applicationDirPath() + "/" + HISTORY_FILE ).toString();
+
+        if( mSampleStore.open( historyPath, logging.value( "History/RetentionDays", 0 ).toInt() ) )
+        {
+            mDeltaPublisher.addSink( &mSampleStore );
+            mSampleStore.loadRollups( mRollupArchive, QDateTime::currentMSecsSinceEpoch() );
+        }
+    }
+#endif
+
+    updateSnrHistory( QDateTime::currentMSecsSinceEpoch() );
+
     //****************************************
     // progress bar setup
     //****************************************
@@ -69,13 +168,29 @@ SurfBeam2::SurfBeam2
     mMainUi->cableResistanceProgressbar->setStyleSheet(
     "QProgressBar { background-color: rgb( 191, 191, 191 ); border-radius: 5px; } QProgressBar::chunk { background-color: rgb( 0, 191, 0 ); border-radius: 5px; }" );
 
+    //****************************************
+    // menu
+    //****************************************
+    QMenu* toolsMenu = menuBar()->addMenu( "Tools" );
+
+    QAction* pointingAction = toolsMenu->addAction( "Dish pointing..." );
+    connect( pointingAction, SIGNAL( triggered() ), this, SLOT( startPointingMode() ) );
+
+    QAction* fleetAction = toolsMenu->addAction( "Fleet overview..." );
+    connect( fleetAction, SIGNAL( triggered() ), this, SLOT( showFleetView() ) );
+
+    toolsMenu->addSeparator();
+
+    mNdjsonAction = toolsMenu->addAction( "Export NDJSON..." );
+    mNdjsonAction->setCheckable( true );
+    connect( mNdjsonAction, SIGNAL( toggled( bool ) ), this, SLOT( toggleNdjsonExport( bool ) ) );
+
     //****************************************
     // timer
     //****************************************
-    QTimer* cgiRequestTimer = new QTimer( this );
-    connect( cgiRequestTimer, SIGNAL( timeout() ), this, SLOT( startCgiRequest() ) );
-    const uint32_t CGI_REQUEST_MS = 500;
-    cgiRequestTimer->start( CGI_REQUEST_MS );
+    mCgiRequestTimer = new QTimer( this );
+    connect( mCgiRequestTimer, SIGNAL( timeout() ), this, SLOT( startCgiRequest() ) );
+    mCgiRequestTimer->start( static_cast<int>( mPollScheduler.tickMs() ) );
     startCgiRequest();
 } 
 
@@ -84,6 +199,20 @@ SurfBeam2::SurfBeam2
 //!************************************************************************
 SurfBeam2::~SurfBeam2()
 {
+    // keep the samples of the open rollup buckets over a restart
+    mRollupEngine.flush( mRollupTerminal, mRollupBuckets );
+
+#ifdef SURFBEAM2_HISTORY_STORE
+    for( size_t i = 0; i < mRollupBuckets.size(); i++ )
+    {
+        mSampleStore.addRollup( mRollupBuckets[i] );
+    }
+
+    mSampleStore.close();
+#endif
+
+    mRollupBuckets.clear();
+
     delete mMainUi;
 } 
 
@@ -97,7 +226,7 @@ double SurfBeam2::convertDbmToWatts
     const double aDbm   //!< power in dBm
     )
 {
-    return pow( 10.0, 0.1 * ( aDbm - 30.0 ) );
+    return PowerFormatter::toWatts( aDbm );
 }
 
 //!************************************************************************
@@ -111,43 +240,82 @@ QString SurfBeam2::convertDbmToQstring
     const double aDbm   //!< power in dBm
     )
 {
-    QString pwrString;
-    double pwrWatts = convertDbmToWatts( aDbm );
+    return PowerFormatter::toString( aDbm );
+}
 
-    if( fabs( pwrWatts ) >= 1.0 )
-    {
-        pwrString = QString::number( pwrWatts, 'f', 3 ) + " W";
-    }
-    else if( fabs( pwrWatts ) >= 1.0e-3 )
-    {
-        pwrString = QString::number( pwrWatts * 1.e3, 'f', 1 ) + " mW";
-    }
-    else if( fabs( pwrWatts ) >= 1.0e-6 )
+//!************************************************************************
+//! Check the online time and the traffic counters of the latest reply for
+//! a reboot or a network re-entry, and show the last one next to the
+//! online time
+//!
+//! @returns: the ResetCause bits of the reply, RESET_CAUSE_NONE if none
+//!************************************************************************
+uint8_t SurfBeam2::detectResets
+    (
+    const int64_t   aTimeMs     //!< time of the reply, ms since epoch
+    )
+{
+    CounterReading reading;
+    reading.TimeMs = aTimeMs;
+    reading.OnlineTimeSeconds = mModemInfo.OnlineTimeSeconds;
+    reading.TxPackets = mModemInfo.TxPackets;
+    reading.TxBytes = mModemInfo.TxBytes;
+    reading.RxPackets = mModemInfo.RxPackets;
+    reading.RxBytes = mModemInfo.RxBytes;
+
+    const uint8_t causes = mRebootDetector.update( reading );
+
+    if( RESET_CAUSE_NONE != causes )
     {
-        pwrString = QString::number( pwrWatts * 1.e6, 'f', 1 ) + " " + MU_SMALL + "W";
+        mMainUi->onlineTimeLabel->setToolTip( "Last " + QString( RebootDetector::causeName( causes ) ) + ": "
+                                              + QDateTime::fromMSecsSinceEpoch( aTimeMs ).toString( "yyyy-MM-dd hh:mm:ss" ) );
     }
-    else if( fabs( pwrWatts ) >= 1.0e-9 )
+
+    return causes;
+}
+
+//!************************************************************************
+//! Evaluate the alert rules on a sample and show the raised alerts in the
+//! status bar
+//!
+//! @returns: nothing
+//!************************************************************************
+void SurfBeam2::evaluateAlerts
+    (
+    const MetricSample& aSample     //!< sample of the latest reply
+    )
+{
+    mAlertEvents.clear();
+    mAlertEngine.evaluate( mAlertTerminal, aSample, mAlertEvents );
+
+    if( mAlertEvents.empty() )
     {
-        pwrString = QString::number( pwrWatts * 1.e9, 'f', 1 ) + " nW";
+        return;
     }
-    else if( fabs( pwrWatts ) >= 1.0e-12 )
+
+    QStringList activeAlerts;
+
+    for( size_t i = 0; i < mAlertEngine.ruleCount(); i++ )
     {
-        pwrString = QString::number( pwrWatts * 1.e12, 'f', 1 ) + " pW";
+        if( mAlertEngine.isActive( mAlertTerminal, i ) )
+        {
+            activeAlerts.append( mAlertEngine.rule( i ).Name );
+        }
     }
-    else if( fabs( pwrWatts ) >= 1.0e-15 )
+
+    if( activeAlerts.isEmpty() )
     {
-        pwrString = QString::number( pwrWatts * 1.e15, 'f', 1 ) + " fW";
+        statusBar()->clearMessage();
     }
     else
     {
-        pwrString = QString::number( pwrWatts, 'g', 3 ) + " W";
+        statusBar()->showMessage( "Alert: " + activeAlerts.join( ", " ) );
     }
-
-    return pwrString;
 }
 
 //!************************************************************************
-//! Convert a cable attenuation in dB to a percent, using a first degree polynomial interpolation.
+//! Convert a cable attenuation in dB to a percent, using a first degree polynomial interpolation,
+//! clamped to 0..100%.
 //!
 //! @returns: the cable attenuation in percent
 //!************************************************************************
@@ -156,18 +324,12 @@ double SurfBeam2::getCableAttenuationPercent
     const double aCableAttenuationDb    //!< attenuation in dB
     )
 {
-    double percent = 0;
-
-    if( aCableAttenuationDb >= 0.0 )
-    {
-        percent = aCableAttenuationDb * 6.66666;
-    }
-
-    return percent;
+    return PercentCalibration::toPercent( PercentCalibration::MAPPING_CABLE_ATTENUATION, aCableAttenuationDb );
 } 
 
 //!************************************************************************
-//! Convert a Rx power in dBm to a percent, using a first degree polynomial interpolation.
+//! Convert a Rx power in dBm to a percent, using a first degree polynomial interpolation,
+//! clamped to 0..100%.
 //!
 //! @returns: the Rx power in percent
 //!************************************************************************
@@ -176,18 +338,12 @@ double SurfBeam2::getRxPwrPercent
     const double aRxPwrDbm  //!< power in dBm
     )
 {
-    double percent = 0;
-
-    if( aRxPwrDbm >= -72.586 )
-    {
-        percent = 119.42208 + aRxPwrDbm * 1.64524;
-    }
-
-    return percent;
+    return PercentCalibration::toPercent( PercentCalibration::MAPPING_RX_PWR, aRxPwrDbm );
 } 
 
 //!************************************************************************
-//! Convert a Rx SNR in dB to a percent, using a first degree polynomial interpolation.
+//! Convert a Rx SNR in dB to a percent, using a first degree polynomial interpolation,
+//! clamped to 0..100%.
 //!
 //! @returns: the Rx SNR in percent
 //!************************************************************************
@@ -196,18 +352,12 @@ double SurfBeam2::getRxSnrPercent
     const double aRxSnrDb   //!< SNR in dB
     )
 {
-    double percent = 0;
-
-    if( aRxSnrDb >= -3.0 )
-    {
-        percent = 10.71429 + aRxSnrDb * 3.57143;
-    }
-
-    return percent;
+    return PercentCalibration::toPercent( PercentCalibration::MAPPING_RX_SNR, aRxSnrDb );
 }
 
 //!************************************************************************
-//! Convert a Tx IF power in dBm to a percent, using a first degree polynomial interpolation.
+//! Convert a Tx IF power in dBm to a percent, using a first degree polynomial interpolation,
+//! clamped to 0..100%.
 //!
 //! @returns: the Tx IF power in percent
 //!************************************************************************
@@ -216,18 +366,12 @@ double SurfBeam2::getTxIfPwrPercent
     const double aTxIfPwrDbm    //!< power in dBm
     )
 {
-    double percent = 0;
-
-    if( aTxIfPwrDbm >= -35.5 )
-    {
-        percent = 137.86408 + aTxIfPwrDbm * 3.8835;
-    }
-
-    return percent;
+    return PercentCalibration::toPercent( PercentCalibration::MAPPING_TX_IF_PWR, aTxIfPwrDbm );
 } 
 
 //!************************************************************************
-//! Convert a Tx RF power in dBm to a percent, using a first degree polynomial interpolation.
+//! Convert a Tx RF power in dBm to a percent, using a first degree polynomial interpolation,
+//! clamped to 0..100%.
 //!
 //! @returns: the Tx RF power in percent
 //!************************************************************************
@@ -236,14 +380,7 @@ double SurfBeam2::getTxRfPwrPercent
     const double aTxRfPwrDbm    //!< power in dBm
     )
 {
-    double percent = 0;
-
-    if( aTxRfPwrDbm >= 14.5 )
-    {
-        percent = -56.31068 + aTxRfPwrDbm * 3.8835;
-    }
-
-    return percent;
+    return PercentCalibration::toPercent( PercentCalibration::MAPPING_TX_RF_PWR, aTxRfPwrDbm );
 } 
 
 //!************************************************************************
@@ -253,14 +390,47 @@ double SurfBeam2::getTxRfPwrPercent
 //!************************************************************************
 /* slot */ void SurfBeam2::httpFinishedModem()
 {
-    QString rawString = QString::fromStdString( mByteArrayModem.toStdString() );
-    mModemRawStringsList = rawString.split( FIELD_DELIMITER );
+    if( mPointingMode )
+    {
+        mModemPayload.split( mByteArrayModem );
+
+        // only the SNR is of interest while pointing, the next request
+        // is chained to this reply to get the highest rate the modem sustains
+        if( FIELD_COUNT_MODEM == mModemPayload.size() )
+        {
+            mPointingDialog->addSnr( QDateTime::currentMSecsSinceEpoch(), mModemPayload.toDouble( MODEM_INDEX_RX_SNR_DB ) );
+        }
+
+        mReplyModem->deleteLater();
+        mReplyModem = nullptr;
+
+        QTimer::singleShot( POINTING_REQUEST_MS, this, SLOT( startModemRequest() ) );
+        return;
+    }
+
+    // an identical reply leaves the decoded information and the UI as they are
+    if( mModemHasher.update( mByteArrayModem ) )
+    {
+        mModemPayload.split( mByteArrayModem );
+
+        // Important: the left-hand term needs to be checked after each firmware update
+        if( FIELD_COUNT_MODEM == mModemPayload.size() )
+        {
+            mModemHasher.compareFields( mModemPayload );
+            updateModemInfo();
+            updateContent();
+        }
+    }
 
-    // Important: the left-hand term needs to be checked after each firmware update
-    if( FIELD_COUNT_MODEM == mModemRawStringsList.size() )
+    if( FIELD_COUNT_MODEM == mModemPayload.size() )
     {
-        updateModemInfo();
-        updateContent();
+        const MetricSample sample = sampleMetrics( true, false );
+        const uint8_t resets = detectResets( sample.TimeMs );
+        mDeltaPublisher.publish( mDeltaTerminal, ENDPOINT_MODEM, sample.TimeMs, mModemPayload, resets );
+        trackModemState( sample.TimeMs );
+        recordSample( sample );
+        evaluateAlerts( sample );
+        updateFleet( sample.TimeMs );
     }
 
     if( mReplyModem->error() )
@@ -268,6 +438,7 @@ double SurfBeam2::getTxRfPwrPercent
     }
 
     mReplyModem->deleteLater();
+    mReplyModem = nullptr;
 }
 
 //!************************************************************************
@@ -277,14 +448,26 @@ double SurfBeam2::getTxRfPwrPercent
 //!************************************************************************
 /* slot */ void SurfBeam2::httpFinishedTria()
 {
-    QString rawString = QString::fromStdString( mByteArrayTria.toStdString() );
-    mTriaRawStringsList = rawString.split( FIELD_DELIMITER );
+    // an identical reply leaves the decoded information and the UI as they are
+    if( mTriaHasher.update( mByteArrayTria ) )
+    {
+        mTriaPayload.split( mByteArrayTria );
+
+        // Important: the left-hand term needs to be checked after each firmware update
+        if( FIELD_COUNT_TRIA == mTriaPayload.size() )
+        {
+            mTriaHasher.compareFields( mTriaPayload );
+            updateTriaInfo();
+            updateContent();
+        }
+    }
 
-    // Important: the left-hand term needs to be checked after each firmware update
-    if( FIELD_COUNT_TRIA == mTriaRawStringsList.size() )
+    if( FIELD_COUNT_TRIA == mTriaPayload.size() )
     {
-        updateTriaInfo();
-        updateContent();
+        const MetricSample sample = sampleMetrics( false, true );
+        mDeltaPublisher.publish( mDeltaTerminal, ENDPOINT_TRIA, sample.TimeMs, mTriaPayload );
+        recordSample( sample );
+        evaluateAlerts( sample );
     }
 
     if( mReplyTria->error() )
@@ -292,6 +475,7 @@ double SurfBeam2::getTxRfPwrPercent
     }
 
     mReplyTria->deleteLater();
+    mReplyTria = nullptr;
 }
 
 //!************************************************************************
@@ -315,21 +499,296 @@ double SurfBeam2::getTxRfPwrPercent
 }
 
 //!************************************************************************
-//! Start the CGI requests from modem & TRIA predefined URLs.
+//! Get the shared string of a rarely changing field. The field bytes are
+//! matched against the values seen so far, and a new string is only
+//! allocated when the value is genuinely new.
+//!
+//! @returns: the interned string of the field
+//!************************************************************************
+const QString& SurfBeam2::internField
+    (
+    const CgiPayload&   aPayload,   //!< split reply
+    const int           aIndex      //!< field index
+    )
+{
+    return mStringInterner.string( mStringInterner.intern( aPayload.fieldData( aIndex ), aPayload.fieldLength( aIndex ) ) );
+}
+
+//!************************************************************************
+//! Add a sample to the history, the rollups and the fade detector, and
+//! archive the completed rollup buckets. Show the last loss-of-sync event
+//! when it has been recorded completely, and the fade in progress or the
+//! last one
+//!
+//! @returns: nothing
+//!************************************************************************
+void SurfBeam2::recordSample
+    (
+    const MetricSample& aSample     //!< sample of the latest reply
+    )
+{
+    mSampleHistory.push( aSample );
+
+    if( mSyncLossDetector.update( mSampleHistory ) )
+    {
+        const SyncLossDetector::Event& event = mSyncLossDetector.events().back();
+
+        mMainUi->lossOfSyncLabel->setToolTip( "Last loss of sync: "
+                                              + QDateTime::fromMSecsSinceEpoch( event.TimeMs ).toString( "yyyy-MM-dd hh:mm:ss" )
+                                              + "\nSNR drop: " + QString::number( event.SnrDropDb, 'f', 1 ) + " dB"
+                                              + "\nRx power drop: " + QString::number( event.RxPwrDropDb, 'f', 1 ) + " dB" );
+    }
+
+    mRollupEngine.add( mRollupTerminal, aSample, mRollupBuckets );
+
+    bool hourCompleted = false;
+
+    for( size_t i = 0; i < mRollupBuckets.size(); i++ )
+    {
+        mRollupArchive.add( mRollupBuckets[i] );
+#ifdef SURFBEAM2_HISTORY_STORE
+        mSampleStore.addRollup( mRollupBuckets[i] );
+#endif
+        hourCompleted |= ( ROLLUP_LEVEL_HOUR == mRollupBuckets[i].Level );
+    }
+
+    mRollupBuckets.clear();
+
+    if( hourCompleted )
+    {
+        updateSnrHistory( aSample.TimeMs );
+    }
+
+    const bool fadeEnded = mFadeDetector.update( aSample );
+
+    if( mFadeDetector.inFade() )
+    {
+        mMainUi->rxSnrLabel->setToolTip( "Fade in progress: " + QString::number( mFadeDetector.currentDepth(), 'f', 1 ) + " dB below the 24 h baseline" );
+    }
+    else if( fadeEnded )
+    {
+        const char* const KIND_NAMES[FADE_KIND_COUNT] = { "blockage", "rain", "interference", "persistent" };
+        const FadeEvent& event = mFadeDetector.events().back();
+
+        mMainUi->rxSnrLabel->setToolTip( "Last fade: " + QString( KIND_NAMES[event.Kind] )
+                                         + ", " + QString::number( event.PeakSnrDepthDb, 'f', 1 ) + " dB"
+                                         + ", " + QString::number( ( event.EndMs - event.StartMs ) / 1000.0, 'f', 0 ) + " s" );
+    }
+}
+
+//!************************************************************************
+//! Sample the metrics of the latest reply. The metrics of the other
+//! reply are left out, so that each reply is evaluated once.
+//!
+//! @returns: the sample, with NaN for the metrics left out
+//!************************************************************************
+MetricSample SurfBeam2::sampleMetrics
+    (
+    const bool  aModem,     //!< true to sample the modem metrics
+    const bool  aTria       //!< true to sample the TRIA metrics
+    ) const
+{
+    MetricSample sample;
+    sample.TimeMs = QDateTime::currentMSecsSinceEpoch();
+
+    for( int i = 0; i < METRIC_COUNT; i++ )
+    {
+        sample.Values[i] = NAN;
+    }
+
+    if( aModem )
+    {
+        sample.Values[METRIC_RX_SNR_DB] = mModemInfo.RxSnrDb;
+        sample.Values[METRIC_RX_PWR_DBM] = mModemInfo.RxPwrDbm;
+        sample.Values[METRIC_CABLE_RESISTANCE_OHM] = mModemInfo.CableResistanceOhm;
+        sample.Values[METRIC_CABLE_ATTEN_DB] = mModemInfo.CableAttenuationDb;
+        sample.Values[METRIC_LOSS_OF_SYNC_COUNT] = mModemInfo.LossOfSyncCount;
+        sample.Values[METRIC_MODEM_STATE] = mModemInfo.ModemStatus;
+    }
+
+    if( aTria )
+    {
+        sample.Values[METRIC_TX_IF_PWR_DBM] = mTriaInfo.TxIfPwrDbm;
+        sample.Values[METRIC_TX_RF_PWR_DBM] = mTriaInfo.TxRfPwrDbm;
+        sample.Values[METRIC_TEMPERATURE_C] = mTriaInfo.TemperatureCelsius;
+    }
+
+    return sample;
+}
+
+//!************************************************************************
+//! Show the fleet overview window
+//!
+//! @returns: nothing
+//!************************************************************************
+/* slot */ void SurfBeam2::showFleetView()
+{
+    if( !mFleetDialog )
+    {
+        mFleetDialog = new FleetDialog( &mFleetModel, this );
+    }
+
+    mFleetDialog->show();
+}
+
+//!************************************************************************
+//! Start the CGI requests of the endpoints whose consumers need fresh
+//! data. An endpoint with a reply still in flight is retried at the next
+//! tick.
 //!
 //! @returns: nothing
 //!************************************************************************
 /* slot */ void SurfBeam2::startCgiRequest()
 {
+    const int64_t timeMs = QDateTime::currentMSecsSinceEpoch();
+
+    mCsvLogger.flushIfDue( timeMs );
+#ifdef SURFBEAM2_HISTORY_STORE
+    mSampleStore.commitIfDue( timeMs );
+#endif
+
+    if( !mReplyModem && mPollScheduler.due( ENDPOINT_MODEM, timeMs ) )
+    {
+        startModemRequest();
+        mPollScheduler.polled( ENDPOINT_MODEM, timeMs );
+    }
+
+    if( !mReplyTria && mPollScheduler.due( ENDPOINT_TRIA, timeMs ) )
+    {
+        startTriaRequest();
+        mPollScheduler.polled( ENDPOINT_TRIA, timeMs );
+    }
+}
+
+//!************************************************************************
+//! Start the CGI request from the modem predefined URL.
+//!
+//! @returns: nothing
+//!************************************************************************
+/* slot */ void SurfBeam2::startModemRequest()
+{
+    if( mReplyModem )
+    {
+        return;
+    }
+
     mByteArrayModem.clear();
     mReplyModem = mQnam.get( QNetworkRequest( URL_MODEM ) );
     connect( mReplyModem, &QNetworkReply::finished, this, &SurfBeam2::httpFinishedModem );
     connect( mReplyModem, &QIODevice::readyRead, this, &SurfBeam2::httpReadyReadModem );
 
+    // a stalled reply is aborted, which finishes it, so polling goes on
+    QTimer::singleShot( REPLY_TIMEOUT_MS, mReplyModem, SLOT( abort() ) );
+}
+
+//!************************************************************************
+//! Show the pointing window and poll only the modem, as fast as it
+//! answers, until the window is closed.
+//!
+//! @returns: nothing
+//!************************************************************************
+/* slot */ void SurfBeam2::startPointingMode()
+{
+    if( mPointingMode )
+    {
+        return;
+    }
+
+    if( !mPointingDialog )
+    {
+        mPointingDialog = new PointingDialog( this );
+        connect( mPointingDialog, SIGNAL( finished( int ) ), this, SLOT( stopPointingMode() ) );
+    }
+
+    mCgiRequestTimer->stop();
+    mPointingMode = true;
+    mPointingDialog->reset();
+    mPointingDialog->show();
+    startModemRequest();
+}
+
+//!************************************************************************
+//! Start the CGI request from the TRIA predefined URL.
+//!
+//! @returns: nothing
+//!************************************************************************
+/* slot */ void SurfBeam2::startTriaRequest()
+{
     mByteArrayTria.clear();
     mReplyTria = mQnam.get( QNetworkRequest( URL_TRIA ) );
     connect( mReplyTria, &QNetworkReply::finished, this, &SurfBeam2::httpFinishedTria );
     connect( mReplyTria, &QIODevice::readyRead, this, &SurfBeam2::httpReadyReadTria );
+
+    // a stalled reply is aborted, which finishes it, so polling goes on
+    QTimer::singleShot( REPLY_TIMEOUT_MS, mReplyTria, SLOT( abort() ) );
+}
+
+//!************************************************************************
+//! Go back to polling the modem & TRIA periodically.
+//!
+//! @returns: nothing
+//!************************************************************************
+/* slot */ void SurfBeam2::stopPointingMode()
+{
+    mPointingMode = false;
+    mModemHasher.reset();
+    mCgiRequestTimer->start( static_cast<int>( mPollScheduler.tickMs() ) );
+}
+
+//!************************************************************************
+//! Start writing the published samples to an NDJSON file chosen by the
+//! user, or stop writing them.
+//!
+//! @returns: nothing
+//!************************************************************************
+/* slot */ void SurfBeam2::toggleNdjsonExport
+    (
+    bool aEnabled       //!< true to start the export
+    )
+{
+    mDeltaPublisher.removeSink( &mNdjsonWriter );
+    mNdjsonWriter.close();
+
+    if( !aEnabled )
+    {
+        return;
+    }
+
+    const QString path = QFileDialog::getSaveFileName( this, "Export NDJSON", QString(), "NDJSON files (*.ndjson)" );
+
+    if( path.isEmpty() || !mNdjsonWriter.open( path.toStdString() ) )
+    {
+        mNdjsonAction->setChecked( false );
+        return;
+    }
+
+    mDeltaPublisher.addSink( &mNdjsonWriter );
+}
+
+//!************************************************************************
+//! Account the modem state of the latest reply, and show the availability
+//! of the current day next to the state
+//!
+//! @returns: nothing
+//!************************************************************************
+void SurfBeam2::trackModemState
+    (
+    const int64_t   aTimeMs     //!< time of the reply, ms since epoch
+    )
+{
+    mModemStateTracker.update( mStateTrackerTerminal, aTimeMs, mModemInfo.ModemStatus );
+
+    const double availability = mModemStateTracker.availability( mStateTrackerTerminal, aTimeMs / ModemStateTracker::ONE_DAY_MS );
+    QString toolTip = "Availability today: " + QString::number( 100.0 * availability, 'f', 2 ) + " %";
+
+    const std::vector<int64_t>& reacquisitionTimes = mModemStateTracker.reacquisitionTimes( mStateTrackerTerminal );
+
+    if( !reacquisitionTimes.empty() )
+    {
+        toolTip += "\nLast re-acquisition: " + QString::number( reacquisitionTimes.back() / 1000.0, 'f', 1 ) + " s";
+    }
+
+    mMainUi->modemStateLabel->setToolTip( toolTip );
 }
 
 //!************************************************************************
@@ -343,9 +802,26 @@ void SurfBeam2::updateContent()
     // Modem State
     //***************************************************************************
     mMainUi->modemStateLabel->setText( mModemInfo.ModemStatusLabel );
-    mMainUi->onlineTimeLabel->setText( mModemInfo.OnlineTime );
+    if( mModemInfo.OnlineTimeSeconds >= 0 )
+    {
+        const int64_t ONE_MINUTE_S = 60;
+        const int64_t ONE_HOUR_S = 60 * ONE_MINUTE_S;
+        const int64_t ONE_DAY_S = 24 * ONE_HOUR_S;
+
+        const int64_t seconds = mModemInfo.OnlineTimeSeconds;
+
+        mMainUi->onlineTimeLabel->setText( QString::number( seconds / ONE_DAY_S ) + " d "
+                                           + QString( "%1:%2:%3" ).arg( ( seconds % ONE_DAY_S ) / ONE_HOUR_S, 2, 10, QChar( '0' ) )
+                                                                  .arg( ( seconds % ONE_HOUR_S ) / ONE_MINUTE_S, 2, 10, QChar( '0' ) )
+                                                                  .arg( seconds % ONE_MINUTE_S, 2, 10, QChar( '0' ) ) );
+    }
+    else
+    {
+        mMainUi->onlineTimeLabel->setText( mModemInfo.OnlineTime );
+    }
     mMainUi->ipAddressLabel->setText( mModemInfo.IpAddress );
     mMainUi->oduTelemetryLabel->setText( mModemInfo.OutdoorUnitTelemetryStatus );
+    mMainUi->lossOfSyncLabel->setText( QString::number( mModemInfo.LossOfSyncCount ) );
 
     QString colorString;
 
@@ -430,23 +906,29 @@ void SurfBeam2::updateContent()
     mMainUi->firmwareVersionLabel->setText( mTriaInfo.FwVersion );
     mMainUi->temperatureLabel->setText( QString::number( mTriaInfo.TemperatureCelsius ) + " °C"  );
 
-    QString polString = "unknown";
-    
-    if( mTriaInfo.PolarizationType.contains( "left", Qt::CaseInsensitive ) )
-    {
-         polString = "Circular Left";
-    }
-    else if( mTriaInfo.PolarizationType.contains( "right", Qt::CaseInsensitive ) )
-    {
-         polString = "Circular Right";
-    }
-    else if( mTriaInfo.PolarizationType.contains( "horiz", Qt::CaseInsensitive ) )
-    {
-         polString = "Horizontal";
-    }
-    else if( mTriaInfo.PolarizationType.contains( "vert", Qt::CaseInsensitive ) )
+    QString polString;
+
+    switch( mTriaInfo.Polarization )
     {
-         polString = "Vertical";
+        case POLARIZATION_CIRCULAR_LEFT:
+            polString = "Circular Left";
+            break;
+
+        case POLARIZATION_CIRCULAR_RIGHT:
+            polString = "Circular Right";
+            break;
+
+        case POLARIZATION_HORIZONTAL:
+            polString = "Horizontal";
+            break;
+
+        case POLARIZATION_VERTICAL:
+            polString = "Vertical";
+            break;
+
+        default:
+            polString = "unknown";
+            break;
     }
 
     mMainUi->polarizationLabel->setText( polString );
@@ -542,11 +1024,32 @@ void SurfBeam2::updateContent()
     mMainUi->rxBytesLabel->setText( amount );
     mMainUi->rxBytesStatic->setText( units );
 
+    //***************************************************************************
+    // Calibration: the terminal reports percents for the stock installation,
+    // which are replaced when a profile matches its IFL type or part number
+    //***************************************************************************
+    int rxSnrPercent = mModemInfo.RxSnrPercent;
+    int rxPwrPercent = mModemInfo.RxPwrPercent;
+    int txIfPwrPercent = mTriaInfo.TxIfPwrPercent;
+    int txRfPwrPercent = mTriaInfo.TxRfPwrPercent;
+    int cableAttenuationPercent = mModemInfo.CableAttenuationPercent;
+
+    const LinearFit* fits = mCalibrationProfiles.select( mModemInfo.InterFacilityLinkType, mModemInfo.PartNr );
+
+    if( fits )
+    {
+        rxSnrPercent = static_cast<int>( PercentCalibration::toPercent( fits[PercentCalibration::MAPPING_RX_SNR], mModemInfo.RxSnrDb ) );
+        rxPwrPercent = static_cast<int>( PercentCalibration::toPercent( fits[PercentCalibration::MAPPING_RX_PWR], mModemInfo.RxPwrDbm ) );
+        txIfPwrPercent = static_cast<int>( PercentCalibration::toPercent( fits[PercentCalibration::MAPPING_TX_IF_PWR], mTriaInfo.TxIfPwrDbm ) );
+        txRfPwrPercent = static_cast<int>( PercentCalibration::toPercent( fits[PercentCalibration::MAPPING_TX_RF_PWR], mTriaInfo.TxRfPwrDbm ) );
+        cableAttenuationPercent = static_cast<int>( PercentCalibration::toPercent( fits[PercentCalibration::MAPPING_CABLE_ATTENUATION], mModemInfo.CableAttenuationDb ) );
+    }
+
     //***************************************************************************
     // RF Rx
     //***************************************************************************
     mMainUi->rxSnrLabel->setText( QString::number( mModemInfo.RxSnrDb, 'f', 1 ) + " dB" );
-    mMainUi->rxSnrProgressbar->setValue( mModemInfo.RxSnrPercent );
+    mMainUi->rxSnrProgressbar->setValue( rxSnrPercent );
 
     if( mModemInfo.RxSnrDb >= 10 )
     {
@@ -570,250 +1073,243 @@ void SurfBeam2::updateContent()
     }
     
     mMainUi->rxRfPowerLabel->setText( QString::number( mModemInfo.RxPwrDbm, 'f', 1 ) + " dBm / " + convertDbmToQstring( mModemInfo.RxPwrDbm ) );
-    mMainUi->rxRfPowerProgressbar->setValue( mModemInfo.RxPwrPercent );
+    mMainUi->rxRfPowerProgressbar->setValue( rxPwrPercent );
 
     //***************************************************************************
     // RF Tx
     //***************************************************************************
     mMainUi->txIfPowerLabel->setText( QString::number( mTriaInfo.TxIfPwrDbm, 'f', 1 ) + " dBm / " + convertDbmToQstring( mTriaInfo.TxIfPwrDbm ) );
-    mMainUi->txIfPowerProgressbar->setValue( mTriaInfo.TxIfPwrPercent );
+    mMainUi->txIfPowerProgressbar->setValue( txIfPwrPercent );
 
     mMainUi->txRfPowerLabel->setText( QString::number( mTriaInfo.TxRfPwrDbm, 'f', 1 ) + " dBm / " + convertDbmToQstring( mTriaInfo.TxRfPwrDbm ) );
-    mMainUi->txRfPowerProgressbar->setValue( mTriaInfo.TxRfPwrPercent );
+    mMainUi->txRfPowerProgressbar->setValue( txRfPwrPercent );
 
     //***************************************************************************
     // Cable
     //***************************************************************************
     mMainUi->cableAttenuationLabel->setText( QString::number( mModemInfo.CableAttenuationDb, 'f', 1 ) + " dB" );
-    mMainUi->cableAttenuationProgressbar->setValue( mModemInfo.CableAttenuationPercent );
+    mMainUi->cableAttenuationProgressbar->setValue( cableAttenuationPercent );
 
     mMainUi->cableResistanceLabel->setText( QString::number( mModemInfo.CableResistanceOhm, 'f', 1 ) + " " + OMEGA_CAPITAL );
     mMainUi->cableResistanceProgressbar->setValue( mModemInfo.CableResistancePercent );
 }
 
 //!************************************************************************
-//! Update the modem information
+//! Update the row of this modem in the fleet overview and its share of
+//! the beam aggregates, and show how it compares with its beam
+//!
+//! @returns: nothing
+//!************************************************************************
+void SurfBeam2::updateFleet
+    (
+    const int64_t   aTimeMs     //!< time of the reply, ms since epoch
+    )
+{
+    FleetSnapshot snapshot = mFleetModel.snapshot( mFleetTerminal );
+
+    if( !mModemInfo.SerialNumber.isEmpty() )
+    {
+        snapshot.Name = mModemInfo.SerialNumber;
+    }
+
+    snapshot.TimeMs = aTimeMs;
+    snapshot.State = mModemInfo.ModemStatus;
+    snapshot.BeamColor = mModemInfo.SatStatusBeamColor;
+    snapshot.RxSnrDb = mModemInfo.RxSnrDb;
+    snapshot.RxPwrDbm = mModemInfo.RxPwrDbm;
+    snapshot.TemperatureC = ( FIELD_COUNT_TRIA == mTriaPayload.size() ) ? mTriaInfo.TemperatureCelsius : NAN;
+
+    // the increments count a restarted counter from zero, so a reboot does
+    // not show as a burst of traffic
+    const CounterReading& increments = mRebootDetector.increments();
+    snapshot.RxRateBps = ( increments.TimeMs > 0 ) ? 8000.0 * increments.RxBytes / increments.TimeMs : NAN;
+    snapshot.TxRateBps = ( increments.TimeMs > 0 ) ? 8000.0 * increments.TxBytes / increments.TimeMs : NAN;
+
+    snapshot.AlertCount = 0;
+
+    for( size_t i = 0; i < mAlertEngine.ruleCount(); i++ )
+    {
+        if( mAlertEngine.isActive( mAlertTerminal, i ) )
+        {
+            snapshot.AlertCount++;
+        }
+    }
+
+    mFleetModel.update( mFleetTerminal, snapshot );
+
+    const StringInterner::Id bdt = mModemInfo.BeamDataTableVersion.isEmpty()
+                                   ? BeamAggregator::NO_BDT
+                                   : mBdtInterner.intern( mModemPayload.fieldData( MODEM_INDEX_BDT_VERSION ), mModemPayload.fieldLength( MODEM_INDEX_BDT_VERSION ) );
+
+    mBeamAggregator.update( mBeamTerminal, snapshot.BeamColor, bdt, snapshot.State, snapshot.RxSnrDb, snapshot.RxPwrDbm );
+
+    const BeamSums beam = mBeamAggregator.beamSums( snapshot.BeamColor );
+    const double meanSnr = BeamAggregator::meanSnr( beam );
+    const double meanRxPwr = BeamAggregator::meanRxPwr( beam );
+    const double onlineRatio = BeamAggregator::onlineRatio( beam );
+    const double snrOffset = mBeamAggregator.snrOffset( mBeamTerminal );
+
+    const BeamSums bdtGroup = mBeamAggregator.bdtSums( bdt );
+    const double bdtMeanSnr = BeamAggregator::meanSnr( bdtGroup );
+
+    // the means are unknown until a terminal of the group reports them
+    mMainUi->modemColorLabel->setToolTip( QString::number( beam.TerminalCount ) + " terminal(s) on this beam"
+                                          + "\nMean Rx SNR: " + ( isnan( meanSnr ) ? QString( "n/a" ) : QString::number( meanSnr, 'f', 1 ) + " dB" )
+                                          + "\nMean Rx power: " + ( isnan( meanRxPwr ) ? QString( "n/a" ) : QString::number( meanRxPwr, 'f', 1 ) + " dBm" )
+                                          + "\nOnline: " + ( isnan( onlineRatio ) ? QString( "n/a" ) : QString::number( 100.0 * onlineRatio, 'f', 0 ) + " %" )
+                                          + ( isnan( snrOffset ) ? QString() : "\nThis terminal: " + QString::number( snrOffset, 'f', 1 ) + " dB against the rest of the beam" )
+                                          + ( ( BeamAggregator::NO_BDT == bdt ) ? QString() : "\n\n" + QString::number( bdtGroup.TerminalCount ) + " terminal(s) on BDT " + mModemInfo.BeamDataTableVersion
+                                              + "\nMean Rx SNR: " + ( isnan( bdtMeanSnr ) ? QString( "n/a" ) : QString::number( bdtMeanSnr, 'f', 1 ) + " dB" ) ) );
+}
+
+//!************************************************************************
+//! Update the modem information from the fields changed since the
+//! previous reply
 //!
 //! @returns: nothing
 //!************************************************************************
 void SurfBeam2::updateModemInfo()
 {
-    for( int i = 0; i < mModemRawStringsList.size(); i++ )
+    for( int i = 0; i < mModemPayload.size(); i++ )
     {
+        if( !mModemHasher.isChanged( i ) )
+        {
+            continue;
+        }
+
         switch( i )
         {
             case MODEM_INDEX_IP_ADDRESS:
-                mModemInfo.IpAddress = mModemRawStringsList.at( i );
+                mModemInfo.IpAddress = mModemPayload.toString( i );
                 break;
 
             case MODEM_INDEX_MAC_ADDRESS:
-                mModemInfo.MacAddress = mModemRawStringsList.at( i );
+                mModemInfo.MacAddress = internField( mModemPayload, i );
                 break;
 
             case MODEM_INDEX_SW_VERSION:
-                mModemInfo.SwVersion = mModemRawStringsList.at( i );
+                mModemInfo.SwVersion = internField( mModemPayload, i );
                 break;
 
             case MODEM_INDEX_HW_VERSION:
-                mModemInfo.HwVersion = mModemRawStringsList.at( i );
+                mModemInfo.HwVersion = internField( mModemPayload, i );
                 break;
 
             case MODEM_INDEX_STATUS:
-                mModemInfo.ModemStatusLabel = mModemRawStringsList.at( i );
+                mModemInfo.ModemStatusLabel = internField( mModemPayload, i );
                 break;
 
             case MODEM_INDEX_TX_PACKETS:
-                {
-                    QString rawString = mModemRawStringsList.at( i );
-                    rawString.remove( ',' );
-                    mModemInfo.TxPackets = rawString.toULongLong();
-                }
+                mModemInfo.TxPackets = mModemPayload.toUnsigned( i );
                 break;
 
             case MODEM_INDEX_TX_BYTES:
-                {
-                    QString rawString = mModemRawStringsList.at( i );
-                    rawString.remove( ',' );
-                    mModemInfo.TxBytes = rawString.toULongLong();
-                }
+                mModemInfo.TxBytes = mModemPayload.toUnsigned( i );
                 break;
 
             case MODEM_INDEX_RX_PACKETS:
-                {
-                    QString rawString = mModemRawStringsList.at( i );
-                    rawString.remove( ',' );
-                    mModemInfo.RxPackets = rawString.toULongLong();
-                }
+                mModemInfo.RxPackets = mModemPayload.toUnsigned( i );
                 break;
 
             case MODEM_INDEX_RX_BYTES:
-                {
-                    QString rawString = mModemRawStringsList.at( i );
-                    rawString.remove( ',' );
-                    mModemInfo.RxBytes = rawString.toULongLong();
-                }
+                mModemInfo.RxBytes = mModemPayload.toUnsigned( i );
                 break;
 
             case MODEM_INDEX_ONLINE_TIME:
-                mModemInfo.OnlineTime = mModemRawStringsList.at( i );
+                mModemInfo.OnlineTime = mModemPayload.toString( i );
+                mModemInfo.OnlineTimeSeconds = mModemPayload.toDuration( i );
                 break;
 
             case MODEM_INDEX_LOSS_OF_SYNC_COUNT:
-                mModemInfo.LossOfSyncCount = mModemRawStringsList.at( i ).toULongLong();
+                mModemInfo.LossOfSyncCount = mModemPayload.toUnsigned( i );
                 break;
 
             case MODEM_INDEX_RX_SNR_DB:
-                mModemInfo.RxSnrDb = mModemRawStringsList.at( i ).toDouble();
+                mModemInfo.RxSnrDb = mModemPayload.toDouble( i );
                 break;
 
             case MODEM_INDEX_RX_SNR_PERCENT:
-                {
-                    QString rawString = mModemRawStringsList.at( i );
-                    rawString.remove( '%' );
-                    mModemInfo.RxSnrPercent = rawString.toUShort();
-                }
+                mModemInfo.RxSnrPercent = mModemPayload.toUnsigned( i );
                 break;
 
             case MODEM_INDEX_SERIAL_NR:
-                mModemInfo.SerialNumber = mModemRawStringsList.at( i );
+                mModemInfo.SerialNumber = internField( mModemPayload, i );
                 break;
 
             case MODEM_INDEX_RX_PWR_DBM:
-                mModemInfo.RxPwrDbm = mModemRawStringsList.at( i ).toDouble();
+                mModemInfo.RxPwrDbm = mModemPayload.toDouble( i );
                 break;
 
             case MODEM_INDEX_RX_PWR_PERCENT:
-                {
-                    QString rawString = mModemRawStringsList.at( i );
-                    rawString.remove( '%' );
-                    mModemInfo.RxPwrPercent = rawString.toUShort();
-                }
+                mModemInfo.RxPwrPercent = mModemPayload.toUnsigned( i );
                 break;
 
             case MODEM_INDEX_CABLE_RESISTANCE_OHM:
-                mModemInfo.CableResistanceOhm = mModemRawStringsList.at( i ).toDouble();
+                mModemInfo.CableResistanceOhm = mModemPayload.toDouble( i );
                 break;
 
             case MODEM_INDEX_CABLE_RESISTANCE_PERCENT:
-                {
-                    QString rawString = mModemRawStringsList.at( i );
-                    rawString.remove( '%' );
-                    mModemInfo.CableResistancePercent = rawString.toUShort();
-                }
+                mModemInfo.CableResistancePercent = mModemPayload.toUnsigned( i );
                 break;
 
             case MODEM_INDEX_ODU_TELEMETRY_STATUS:
-                mModemInfo.OutdoorUnitTelemetryStatus = mModemRawStringsList.at( i );
+                mModemInfo.OutdoorUnitTelemetryStatus = internField( mModemPayload, i );
                 break;
 
             case MODEM_INDEX_CABLE_ATTEN_DB:
-                mModemInfo.CableAttenuationDb = mModemRawStringsList.at( i ).toDouble();
+                mModemInfo.CableAttenuationDb = mModemPayload.toDouble( i );
                 break;
 
             case MODEM_INDEX_CABLE_ATTEN_PERCENT:
-                {
-                    QString rawString = mModemRawStringsList.at( i );
-                    rawString.remove( '%' );
-                    mModemInfo.CableAttenuationPercent = rawString.toUShort();
-                }
+                mModemInfo.CableAttenuationPercent = mModemPayload.toUnsigned( i );
                 break;
 
             case MODEM_INDEX_IFL_TYPE:
-                mModemInfo.InterFacilityLinkType = mModemRawStringsList.at( i );
+                mModemInfo.InterFacilityLinkType = internField( mModemPayload, i );
                 break;
 
             case MODEM_INDEX_PART_NR:
-                mModemInfo.PartNr = mModemRawStringsList.at( i );
+                mModemInfo.PartNr = internField( mModemPayload, i );
                 break;
 
             case MODEM_INDEX_MODEM_STATUS:
-                {
-                    QString stateString = mModemRawStringsList.at( i );
-
-                    if( stateString.contains( "scanning", Qt::CaseInsensitive ) )
-                    {
-                         mModemInfo.ModemStatus = MODEM_STATE_SCANNING;
-                    }
-                    else if( stateString.contains( "ranging", Qt::CaseInsensitive ) )
-                    {
-                         mModemInfo.ModemStatus = MODEM_STATE_RANGING;
-                    }
-                    else if( stateString.contains( "network", Qt::CaseInsensitive ) )
-                    {
-                         mModemInfo.ModemStatus = MODEM_STATE_NETWORK_ENTRY;
-                    }
-                    else if( stateString.contains( "dhcp", Qt::CaseInsensitive ) )
-                    {
-                         mModemInfo.ModemStatus = MODEM_STATE_DHCP;
-                    }
-                    else if( stateString.contains( "online", Qt::CaseInsensitive ) )
-                    {
-                         mModemInfo.ModemStatus = MODEM_STATE_ONLINE;
-                    }
-                    else
-                    {
-                        mModemInfo.ModemStatus = MODEM_STATE_UNKNOWN;
-                    }
-                }
+                mModemInfo.ModemStatus = static_cast<ModemState>( mModemStateClassifier.classify( mModemPayload.fieldData( i ), mModemPayload.fieldLength( i ) ) );
                 break;
 
             case MODEM_INDEX_SATELLITE_STATUS:
-                {
-                    QString beamColorString = mModemRawStringsList.at( i );
-
-                    if( beamColorString.contains( "blue", Qt::CaseInsensitive ) )
-                    {
-                         mModemInfo.SatStatusBeamColor = SATELLITE_STATUS_BEAM_COLOR_BLUE;
-                    }
-                    else if( beamColorString.contains( "orange", Qt::CaseInsensitive ) )
-                    {
-                         mModemInfo.SatStatusBeamColor = SATELLITE_STATUS_BEAM_COLOR_ORANGE;
-                    }
-                    else if( beamColorString.contains( "purple", Qt::CaseInsensitive ) )
-                    {
-                         mModemInfo.SatStatusBeamColor = SATELLITE_STATUS_BEAM_COLOR_PURPLE;
-                    }
-                    else if( beamColorString.contains( "green", Qt::CaseInsensitive ) )
-                    {
-                         mModemInfo.SatStatusBeamColor = SATELLITE_STATUS_BEAM_COLOR_GREEN;
-                    }
-                    else
-                    {
-                        mModemInfo.SatStatusBeamColor = SATELLITE_STATUS_BEAM_COLOR_UNKNOWN;
-                    }
-                }
+                mModemInfo.SatStatusBeamColor = static_cast<SatelliteStatusBeamColor>( mBeamColorClassifier.classify( mModemPayload.fieldData( i ), mModemPayload.fieldLength( i ) ) );
                 break;
 
             case MODEM_INDEX_CLIENT_SIDE_PROXY_STATUS:
-                mModemInfo.ClientSideProxyStatus = mModemRawStringsList.at( i );
+                mModemInfo.ClientSideProxyStatus = internField( mModemPayload, i );
                 break;
 
             case MODEM_INDEX_CLIENT_SIDE_PROXY_HEALTH:
-                mModemInfo.ClientSideProxyHealth = mModemRawStringsList.at( i );
+                mModemInfo.ClientSideProxyHealth = internField( mModemPayload, i );
                 break;
 
             case MODEM_INDEX_LAST_PAGE_LOAD_DURATION:
-                mModemInfo.LastPageLoadDuration = mModemRawStringsList.at( i );
+                mModemInfo.LastPageLoadDuration = mModemPayload.toString( i );
                 break;
 
             case MODEM_INDEX_UPLINK_SYMBOL_RATE:
-                mModemInfo.UplinkSymbolRate = mModemRawStringsList.at( i ).toULong();
+                mModemInfo.UplinkSymbolRate = mModemPayload.toUnsigned( i );
                 break;
 
             case MODEM_INDEX_BDT_VERSION:
-                mModemInfo.BeamDataTableVersion = mModemRawStringsList.at( i );
+                mModemInfo.BeamDataTableVersion = internField( mModemPayload, i );
                 break;
 
             case MODEM_INDEX_VENDOR:
-                mModemInfo.Vendor = mModemRawStringsList.at( i );
+                mModemInfo.Vendor = internField( mModemPayload, i );
                 break;
 
             case MODEM_INDEX_DOWNLINK_SYMBOL_RATE:
-                mModemInfo.DownlinkSymbolRate = mModemRawStringsList.at( i ).toULong();
+                mModemInfo.DownlinkSymbolRate = mModemPayload.toUnsigned( i );
                 break;
 
             case MODEM_INDEX_DOWNLINK_MODULATION:
-                mModemInfo.DownlinkModulation = mModemRawStringsList.at( i );
+                mModemInfo.DownlinkModulation = internField( mModemPayload, i );
                 break;
 
             default:
@@ -823,93 +1319,108 @@ void SurfBeam2::updateModemInfo()
 }
 
 //!************************************************************************
-//! Update the TRIA information
+//! Show the Rx SNR of the last 24 h, in points of 6 h read from the hour
+//! rollups, in the tooltip of the SNR bar. The rollups are kept over a
+//! restart when the history store is enabled.
+//!
+//! @returns: nothing
+//!************************************************************************
+void SurfBeam2::updateSnrHistory
+    (
+    const int64_t   aTimeMs             //!< current time, ms since epoch
+    )
+{
+    const int64_t RANGE_MS = 24 * 3600 * 1000LL;
+    const int64_t RESOLUTION_MS = 6 * 3600 * 1000LL;
+
+    HistoryQuery query( mRollupArchive );
+    query.start( mRollupTerminal, METRIC_RX_SNR_DB, aTimeMs - RANGE_MS, aTimeMs, RESOLUTION_MS );
+
+    QString toolTip = "Rx SNR over the last 24 h";
+    HistoryPoint point;
+    int points = 0;
+
+    while( query.next( point ) )
+    {
+        toolTip += "\n" + QDateTime::fromMSecsSinceEpoch( point.StartMs ).toString( "ddd hh:mm" )
+                 + "  min " + QString::number( point.Min, 'f', 1 )
+                 + "  mean " + QString::number( point.Mean, 'f', 1 )
+                 + "  max " + QString::number( point.Max, 'f', 1 ) + " dB";
+        points++;
+    }
+
+    if( 0 == points )
+    {
+        toolTip += ": no complete hour yet";
+    }
+
+    mMainUi->rxSnrProgressbar->setToolTip( toolTip );
+}
+
+//!************************************************************************
+//! Update the TRIA information from the fields changed since the
+//! previous reply
 //!
 //! @returns: nothing
 //!************************************************************************
 void SurfBeam2::updateTriaInfo()
 {
-    for( int i = 0; i < mTriaRawStringsList.size(); i++ )
+    for( int i = 0; i < mTriaPayload.size(); i++ )
     {
+        if( !mTriaHasher.isChanged( i ) )
+        {
+            continue;
+        }
+
         switch( i )
         {
             case TRIA_INDEX_PWR_MODE:
-                mTriaInfo.PwrMode = mTriaRawStringsList.at( i );
+                mTriaInfo.PwrMode = internField( mTriaPayload, i );
                 break;
 
             case TRIA_INDEX_POLARIZATION_TYPE:
-                mTriaInfo.PolarizationType = mTriaRawStringsList.at( i );
+                mTriaInfo.PolarizationType = internField( mTriaPayload, i );
+                mTriaInfo.Polarization = static_cast<AntennaPolarization>( mPolarizationClassifier.classify( mTriaPayload.fieldData( i ), mTriaPayload.fieldLength( i ) ) );
                 break;
 
             case TRIA_INDEX_TX_IF_PWR_DBM:
-                mTriaInfo.TxIfPwrDbm = mTriaRawStringsList.at( i ).toDouble();
+                mTriaInfo.TxIfPwrDbm = mTriaPayload.toDouble( i );
                 break;
 
             case TRIA_INDEX_IFL_TYPE:
-                mTriaInfo.InterFacilityLinkType = mTriaRawStringsList.at( i );
+                mTriaInfo.InterFacilityLinkType = internField( mTriaPayload, i );
                 break;
 
             case TRIA_INDEX_TEMPERATURE_C:
-                mTriaInfo.TemperatureCelsius = mTriaRawStringsList.at( i ).toDouble();
+                mTriaInfo.TemperatureCelsius = mTriaPayload.toDouble( i );
                 break;
 
             case TRIA_INDEX_SERIAL_NR:
-                mTriaInfo.SerialNumber = mTriaRawStringsList.at( i );
+                mTriaInfo.SerialNumber = internField( mTriaPayload, i );
                 break;
 
             case TRIA_INDEX_TX_RF_PWR_DBM:
-                mTriaInfo.TxRfPwrDbm = mTriaRawStringsList.at( i ).toDouble();
+                mTriaInfo.TxRfPwrDbm = mTriaPayload.toDouble( i );
                 break;
 
             case TRIA_INDEX_FW_VERSION:
-                mTriaInfo.FwVersion = mTriaRawStringsList.at( i );
+                mTriaInfo.FwVersion = internField( mTriaPayload, i );
                 break;
 
             case TRIA_INDEX_TX_IF_PWR_PERCENT:
-                {
-                    QString rawString = mTriaRawStringsList.at( i );
-                    rawString.remove( '%' );
-                    mTriaInfo.TxIfPwrPercent = rawString.toUShort();
-                }
+                mTriaInfo.TxIfPwrPercent = mTriaPayload.toUnsigned( i );
                 break;
 
             case TRIA_INDEX_TX_RF_PWR_PERCENT:
-                {
-                    QString rawString = mTriaRawStringsList.at( i );
-                    rawString.remove( '%' );
-                    mTriaInfo.TxRfPwrPercent = rawString.toUShort();
-                }
+                mTriaInfo.TxRfPwrPercent = mTriaPayload.toUnsigned( i );
                 break;
 
             case TRIA_INDEX_SATELLITE_STATUS:
-                {
-                    QString beamColorString = mTriaRawStringsList.at( i );
-
-                    if( beamColorString.contains( "blue", Qt::CaseInsensitive ) )
-                    {
-                         mTriaInfo.SatStatusBeamColor = SATELLITE_STATUS_BEAM_COLOR_BLUE;
-                    }
-                    else if( beamColorString.contains( "orange", Qt::CaseInsensitive ) )
-                    {
-                         mTriaInfo.SatStatusBeamColor = SATELLITE_STATUS_BEAM_COLOR_ORANGE;
-                    }
-                    else if( beamColorString.contains( "purple", Qt::CaseInsensitive ) )
-                    {
-                         mTriaInfo.SatStatusBeamColor = SATELLITE_STATUS_BEAM_COLOR_PURPLE;
-                    }
-                    else if( beamColorString.contains( "green", Qt::CaseInsensitive ) )
-                    {
-                         mTriaInfo.SatStatusBeamColor = SATELLITE_STATUS_BEAM_COLOR_GREEN;
-                    }
-                    else
-                    {
-                        mTriaInfo.SatStatusBeamColor = SATELLITE_STATUS_BEAM_COLOR_UNKNOWN;
-                    }
-                }
+                mTriaInfo.SatStatusBeamColor = static_cast<SatelliteStatusBeamColor>( mBeamColorClassifier.classify( mTriaPayload.fieldData( i ), mTriaPayload.fieldLength( i ) ) );
                 break;
 
             case TRIA_INDEX_VENDOR:
-                mTriaInfo.Vendor = mTriaRawStringsList.at( i );
+                mTriaInfo.Vendor = internField( mTriaPayload, i );
                 break;
 
             default:
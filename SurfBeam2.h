@@ -31,9 +31,37 @@ This file contains the definitions for the ViaSat SurfBeam 2 modem.
 #include <QMainWindow>
 #include <QNetworkAccessManager>
 #include <QString>
-#include <QStringList>
 #include <QUrl>
 
+#include "AlertEngine.h"
+#include "BeamAggregator.h"
+#include "CalibrationProfiles.h"
+#include "CgiPayload.h"
+#include "CsvLogger.h"
+#include "DeltaPublisher.h"
+#include "FadeDetector.h"
+#include "FieldClassifier.h"
+#include "FleetModel.h"
+#include "ModemStateTracker.h"
+#include "NdjsonWriter.h"
+#include "PayloadHasher.h"
+#include "PollScheduler.h"
+#include "RebootDetector.h"
+#include "RollupArchive.h"
+#include "RollupEngine.h"
+#include "SampleHistory.h"
+#ifdef SURFBEAM2_HISTORY_STORE
+#include "SampleStore.h"
+#endif
+#include "StringInterner.h"
+#include "SurfBeam2Types.h"
+#include "SyncLossDetector.h"
+
+
+class FleetDialog;
+class PointingDialog;
+class QAction;
+class QTimer;
 
 QT_BEGIN_NAMESPACE
 
@@ -58,162 +86,23 @@ class SurfBeam2 : public QMainWindow
         const QUrl URL_MODEM = QUrl( "http://192.168.100.1/index.cgi?page=modemStatusData" );   //!< modem CGI URL
         const QUrl URL_TRIA  = QUrl( "http://192.168.100.1/index.cgi?page=triaStatusData" );    //!< TRIA CGI URL
 
-        const uint8_t FIELD_COUNT_MODEM = 81;   //!< number of fields in the modem string array (matches fw ver. UT_3.7.8.9.5)
-        const uint8_t FIELD_COUNT_TRIA  = 84;   //!< number of fields in the TRIA string array (matches fw ver. UT_3.7.8.9.5)
-
-        const QString FIELD_DELIMITER = "##";   //!< field delimiter
-        const QString FIELD_FILL = "#";         //!< filling character
+        const QString CALIBRATION_FILE = "calibration.ini";             //!< calibration profiles, next to the executable
+        const QString LOGGING_FILE = "logging.ini";                     //!< logging settings, next to the executable
+        const QString CSV_LOG_FILE = "surfbeam2.csv";                   //!< default CSV log, next to the executable
+        const QString HISTORY_FILE = "history.sqlite";                  //!< default history store, next to the executable
 
         const QString OMEGA_CAPITAL = QString::fromUtf8( "\u03A9" );    //!< capital Greek Omega
-        const QString MU_SMALL = QString::fromUtf8( "\u03BC" );         //!< small Greek mu
+
+        static const int CGI_REQUEST_MS = 500;                          //!< polling period of the modem panels
+        static const int TRIA_REQUEST_MS = 5000;                        //!< polling period of the TRIA panels
+        static const int ALERT_SAMPLES = 3;                             //!< samples within the minimum duration of an alert rule
+        static const int POINTING_REQUEST_MS = 20;                      //!< pause between the modem requests when pointing
+        static const int REPLY_TIMEOUT_MS = 2000;                       //!< time after which an unfinished request is aborted
 
         static constexpr double ONE_KB = 1024.0;                        //!< bytes in one kB
         static constexpr double ONE_MB = ONE_KB * ONE_KB;               //!< bytes in one MB
         static constexpr double ONE_GB = ONE_KB * ONE_MB;               //!< bytes in one GB
 
-        enum SatelliteStatusBeamColor
-        {
-            SATELLITE_STATUS_BEAM_COLOR_UNKNOWN,    //!< unknown or uninitialized
-
-            SATELLITE_STATUS_BEAM_COLOR_BLUE,       //!< blue beam color
-            SATELLITE_STATUS_BEAM_COLOR_ORANGE,     //!< orange beam color
-            SATELLITE_STATUS_BEAM_COLOR_PURPLE,     //!< purple beam color
-            SATELLITE_STATUS_BEAM_COLOR_GREEN,      //!< green beam color
-
-            SATELLITE_STATUS_BEAM_COLOR_COUNT       //!< number of defined beam colors
-        };
-
-        enum ModemState
-        {
-            MODEM_STATE_UNKNOWN,        //!< unknown or uninitialized
-
-            MODEM_STATE_SCANNING,       //!< Scanning        - step 1 of 5
-            MODEM_STATE_RANGING,        //!< Ranging         - step 2 of 5
-            MODEM_STATE_NETWORK_ENTRY,  //!< Network entry   - step 3 of 5
-            MODEM_STATE_DHCP,           //!< DHCP            - step 4 of 5
-            MODEM_STATE_ONLINE,         //!< Online          - step 5 of 5
-
-            MODEM_STATE_COUNT           //!< Number of defined modem states
-        };
-
-        enum ModemIndexes
-        {
-            MODEM_INDEX_IP_ADDRESS              = 0,    //!< IPv4 address
-            MODEM_INDEX_MAC_ADDRESS             = 1,    //!< MAC address
-            MODEM_INDEX_SW_VERSION              = 2,    //!< software version
-            MODEM_INDEX_HW_VERSION              = 3,    //!< hardware version
-            MODEM_INDEX_STATUS                  = 4,    //!< status
-            MODEM_INDEX_RX_PACKETS              = 5,    //!< number of received packets
-            MODEM_INDEX_RX_BYTES                = 6,    //!< number of received bytes
-            MODEM_INDEX_TX_PACKETS              = 7,    //!< number of transmitted packets
-            MODEM_INDEX_TX_BYTES                = 8,    //!< number of transmitted bytes
-            MODEM_INDEX_ONLINE_TIME             = 9,    //!< online time
-            MODEM_INDEX_LOSS_OF_SYNC_COUNT      = 10,   //!< loss-of-sync count
-            MODEM_INDEX_RX_SNR_DB               = 11,   //!< Rx SNR [dB]
-            MODEM_INDEX_RX_SNR_PERCENT          = 12,   //!< Rx SNR [%]
-            MODEM_INDEX_SERIAL_NR               = 13,   //!< serial number
-            MODEM_INDEX_RX_PWR_DBM              = 14,   //!< Rx power [dBm]
-            MODEM_INDEX_RX_PWR_PERCENT          = 15,   //!< Rx power [%]
-            MODEM_INDEX_CABLE_RESISTANCE_OHM    = 16,   //!< cable resistance [Ohm]
-            MODEM_INDEX_CABLE_RESISTANCE_PERCENT= 17,   //!< cable resistance [%]
-            MODEM_INDEX_ODU_TELEMETRY_STATUS    = 18,   //!< ODU telemetry status
-            MODEM_INDEX_CABLE_ATTEN_DB          = 19,   //!< cable attenuation [dB]
-            MODEM_INDEX_CABLE_ATTEN_PERCENT     = 20,   //!< cable attenuation [%]
-            MODEM_INDEX_IFL_TYPE                = 21,   //!< IFL type
-            MODEM_INDEX_PART_NR                 = 22,   //!< part number
-            MODEM_INDEX_MODEM_STATUS            = 23,   //!< modem status
-            MODEM_INDEX_SATELLITE_STATUS        = 24,   //!< satellite status
-            //
-            MODEM_INDEX_CLIENT_SIDE_PROXY_STATUS= 26,   //!< client-side proxy status
-            MODEM_INDEX_CLIENT_SIDE_PROXY_HEALTH= 27,   //!< client-side proxy health
-            //
-            MODEM_INDEX_LAST_PAGE_LOAD_DURATION = 30,   //!< last page load duration
-            //
-            MODEM_INDEX_UPLINK_SYMBOL_RATE      = 32,   //!< uplink SR
-            //
-            MODEM_INDEX_BDT_VERSION             = 40,   //!< BDT version
-            //
-            MODEM_INDEX_VENDOR                  = 46,   //!< vendor
-            //
-            MODEM_INDEX_DOWNLINK_SYMBOL_RATE    = 50,   //!< downlink SR
-            MODEM_INDEX_DOWNLINK_MODULATION     = 51    //!< downlink modulation type
-        };
-
-        typedef struct
-        {
-            QString                     IpAddress;
-            QString                     MacAddress;
-            QString                     SwVersion;
-            QString                     HwVersion;
-            QString                     ModemStatusLabel;
-            uint64_t                    TxPackets;
-            uint64_t                    TxBytes;
-            uint64_t                    RxPackets;
-            uint64_t                    RxBytes;
-            QString                     OnlineTime;
-            uint32_t                    LossOfSyncCount;
-            double                      RxSnrDb;
-            uint8_t                     RxSnrPercent;
-            QString                     SerialNumber;
-            double                      RxPwrDbm;
-            uint8_t                     RxPwrPercent;
-            double                      CableResistanceOhm;
-            uint8_t                     CableResistancePercent;
-            QString                     OutdoorUnitTelemetryStatus;
-            double                      CableAttenuationDb;
-            uint8_t                     CableAttenuationPercent;
-            QString                     InterFacilityLinkType;
-            QString                     PartNr;
-            ModemState                  ModemStatus;
-            SatelliteStatusBeamColor    SatStatusBeamColor;
-            QString                     ClientSideProxyStatus;
-            QString                     ClientSideProxyHealth;
-            QString                     LastPageLoadDuration;
-            uint32_t                    UplinkSymbolRate;
-            QString                     BeamDataTableVersion;
-            QString                     Vendor;
-            uint32_t                    DownlinkSymbolRate;
-            QString                     DownlinkModulation;
-        }ModemInfo;
-
-        enum TriaIndexes
-        {
-            TRIA_INDEX_PWR_MODE                 = 4,    //!< power mode
-            TRIA_INDEX_POLARIZATION_TYPE        = 5,    //!< polarization type
-            //
-            TRIA_INDEX_TX_IF_PWR_DBM            = 7,    //!< Tx IF power [dBm]
-            //
-            TRIA_INDEX_IFL_TYPE                 = 9,    //!< IFL type
-            TRIA_INDEX_TEMPERATURE_C            = 10,   //!< temperature [C]
-            //
-            TRIA_INDEX_SERIAL_NR                = 16,   //!< serial number
-            TRIA_INDEX_TX_RF_PWR_DBM            = 17,   //!< Tx RF power [dBm]
-            //
-            TRIA_INDEX_FW_VERSION               = 24,   //!< firmware version
-            TRIA_INDEX_TX_IF_PWR_PERCENT        = 25,   //!< Tx IF power [%]
-            TRIA_INDEX_TX_RF_PWR_PERCENT        = 26,   //!< Tx RF power [%]
-            //
-            TRIA_INDEX_SATELLITE_STATUS         = 29,   //!< satellite status
-            //
-            TRIA_INDEX_VENDOR                   = 81    //!< vendor
-        };
-
-        typedef struct
-        {
-            QString                     PwrMode;
-            QString                     PolarizationType;
-            double                      TxIfPwrDbm;
-            QString                     InterFacilityLinkType;
-            double                      TemperatureCelsius;
-            QString                     SerialNumber;
-            double                      TxRfPwrDbm;
-            QString                     FwVersion;
-            uint8_t                     TxIfPwrPercent;
-            uint8_t                     TxRfPwrPercent;
-            SatelliteStatusBeamColor    SatStatusBeamColor;
-            QString                     Vendor;
-        }TriaInfo;
-
     //************************************************************************
     // functions
     //************************************************************************
@@ -237,6 +126,16 @@ class SurfBeam2 : public QMainWindow
             );
 
 
+        uint8_t detectResets
+            (
+            const int64_t   aTimeMs             //!< time of the reply, ms since epoch
+            );
+
+        void evaluateAlerts
+            (
+            const MetricSample& aSample         //!< sample of the latest reply
+            );
+
         double getCableAttenuationPercent
             (
             const double aCableAttenuationDb    //!< attenuation in dB
@@ -262,10 +161,42 @@ class SurfBeam2 : public QMainWindow
             const double aTxRfPwrDbm    //!< power in dBm
             );
 
+        const QString& internField
+            (
+            const CgiPayload&   aPayload,   //!< split reply
+            const int           aIndex      //!< field index
+            );
+
+        void recordSample
+            (
+            const MetricSample& aSample         //!< sample of the latest reply
+            );
+
+        MetricSample sampleMetrics
+            (
+            const bool  aModem,                 //!< true to sample the modem metrics
+            const bool  aTria                   //!< true to sample the TRIA metrics
+            ) const;
+
+        void trackModemState
+            (
+            const int64_t   aTimeMs             //!< time of the reply, ms since epoch
+            );
+
         void updateContent();
 
+        void updateFleet
+            (
+            const int64_t   aTimeMs             //!< time of the reply, ms since epoch
+            );
+
         void updateModemInfo();
 
+        void updateSnrHistory
+            (
+            const int64_t   aTimeMs             //!< current time, ms since epoch
+            );
+
         void updateTriaInfo();
 
     private slots:
@@ -275,7 +206,20 @@ class SurfBeam2 : public QMainWindow
         void httpReadyReadModem();
         void httpReadyReadTria();
 
+        void showFleetView();
+
         void startCgiRequest();
+        void startModemRequest();
+
+        void startPointingMode();
+        void stopPointingMode();
+
+        void startTriaRequest();
+
+        void toggleNdjsonExport
+            (
+            bool aEnabled               //!< true to start the export
+            );
 
 
     //************************************************************************
@@ -284,13 +228,64 @@ class SurfBeam2 : public QMainWindow
     private:
         Ui::SurfBeam2*          mMainUi;                //!< main UI
 
-        QStringList             mModemRawStringsList;   //!< raw strings list with modem items
-        QStringList             mTriaRawStringsList;    //!< raw strings list with TRIA items
+        CgiPayload              mModemPayload;          //!< split reply with modem items
+        CgiPayload              mTriaPayload;           //!< split reply with TRIA items
+
+        PayloadHasher           mModemHasher;           //!< changes between the modem replies
+        PayloadHasher           mTriaHasher;            //!< changes between the TRIA replies
+
+        StringInterner          mStringInterner;        //!< shared values of rarely changing fields
+        StringInterner          mBdtInterner;           //!< BDT versions only, so that their IDs stay dense
+
+        FieldClassifier         mBeamColorClassifier;   //!< classifier of the satellite status beam color
+        FieldClassifier         mModemStateClassifier;  //!< classifier of the modem state
+        FieldClassifier         mPolarizationClassifier;//!< classifier of the antenna polarization
+
+        CalibrationProfiles     mCalibrationProfiles;   //!< calibration of the percent mappings
+
+        AlertEngine             mAlertEngine;           //!< threshold alerts
+        size_t                  mAlertTerminal;         //!< terminal index of this modem in the alert engine
+        std::vector<AlertEvent> mAlertEvents;           //!< alert changes of the latest sample
+
+        ModemStateTracker       mModemStateTracker;     //!< modem state transitions and availability
+        size_t                  mStateTrackerTerminal;  //!< terminal index of this modem in the state tracker
+
+        RebootDetector          mRebootDetector;        //!< reboots and network re-entries
+
+        SampleHistory           mSampleHistory;         //!< recent samples
+        SyncLossDetector        mSyncLossDetector;      //!< loss-of-sync events
+        FadeDetector            mFadeDetector;          //!< Rx fades
+
+        RollupEngine            mRollupEngine;          //!< minute, hour and day aggregates of the samples
+        size_t                  mRollupTerminal;        //!< terminal index of this modem in the rollup engine
+        RollupArchive           mRollupArchive;         //!< completed rollup buckets, read by the SNR history
+        std::vector<RollupBucket> mRollupBuckets;       //!< buckets completed by the latest sample
+
+        FleetModel              mFleetModel;            //!< latest state of the terminals, for the fleet overview
+        size_t                  mFleetTerminal;         //!< terminal index of this modem in the fleet model
+        BeamAggregator          mBeamAggregator;        //!< SNR, Rx power and online ratio per beam color and BDT version
+        size_t                  mBeamTerminal;          //!< terminal index of this modem in the beam aggregator
+
+        DeltaPublisher          mDeltaPublisher;        //!< changed fields of the replies, to the sinks
+        size_t                  mDeltaTerminal;         //!< terminal index of this modem in the delta publisher
+        NdjsonWriter            mNdjsonWriter;          //!< NDJSON export of the published samples
+        CsvLogger               mCsvLogger;             //!< CSV log of the published samples
+#ifdef SURFBEAM2_HISTORY_STORE
+        SampleStore             mSampleStore;           //!< SQLite history of the published samples
+#endif
 
         ModemInfo               mModemInfo;             //!< object with modem information
         TriaInfo                mTriaInfo;              //!< object with TRIA information
 
         QNetworkAccessManager   mQnam;                  //!< network access manager
+        QTimer*                 mCgiRequestTimer;       //!< periodic CGI requests
+        PollScheduler           mPollScheduler;         //!< endpoints requested at each tick of the timer
+
+        PointingDialog*         mPointingDialog;        //!< dish pointing window, created on first use
+        bool                    mPointingMode;          //!< true while only the modem is polled, back to back
+        FleetDialog*            mFleetDialog;           //!< fleet overview window, created on first use
+
+        QAction*                mNdjsonAction;          //!< menu action toggling the NDJSON export
 
         QNetworkReply*          mReplyModem;            //!< modem network reply
         QNetworkReply*          mReplyTria;             //!< TRIA network reply
@@ -0,0 +1,202 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+SyncLossDetector.cpp
+
+This file contains the sources for the detection of loss-of-sync
+events.
+*/
+
+#include "SyncLossDetector.h"
+
+#include <math.h>
+
+
+const int SyncLossDetector::PRE_SAMPLES;
+const int SyncLossDetector::POST_SAMPLES;
+const int SyncLossDetector::WINDOW_SIZE;
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+SyncLossDetector::SyncLossDetector()
+    : mPending()
+    , mPendingActive( false )
+    , mPostRemaining( 0 )
+    , mPreviousCount( 0.0 )
+    , mHasPreviousCount( false )
+{
+}
+
+//!************************************************************************
+//! Record a sample in the pending event
+//!
+//! @returns: nothing
+//!************************************************************************
+void SyncLossDetector::appendPoint
+    (
+    const MetricSample& aSample     //!< sample to record
+    )
+{
+    if( mPending.PointCount >= WINDOW_SIZE )
+    {
+        return;
+    }
+
+    const int i = mPending.PointCount++;
+    mPending.OffsetMs[i] = static_cast<int32_t>( aSample.TimeMs - mPending.TimeMs );
+    mPending.RxSnrDb[i] = static_cast<float>( aSample.Values[METRIC_RX_SNR_DB] );
+    mPending.RxPwrDbm[i] = static_cast<float>( aSample.Values[METRIC_RX_PWR_DBM] );
+    mPending.TxRfPwrDbm[i] = static_cast<float>( aSample.Values[METRIC_TX_RF_PWR_DBM] );
+}
+
+//!************************************************************************
+//! Get the drop of a recorded metric, from the mean of the first half of
+//! the samples before the increment to the minimum of the window
+//!
+//! @returns: the drop, 0 if the metric did not drop or was not reported
+//!************************************************************************
+float SyncLossDetector::dropOf
+    (
+    const float*    aValues,    //!< recorded values
+    const int       aCount,     //!< number of recorded values
+    const int       aTrigger    //!< index of the sample showing the increment
+    )
+{
+    const int baselineCount = aTrigger > 1 ? aTrigger / 2 : 1;
+    double baseline = 0.0;
+    int used = 0;
+
+    for( int i = 0; i < baselineCount && i < aCount; i++ )
+    {
+        if( !isnan( aValues[i] ) )
+        {
+            baseline += aValues[i];
+            used++;
+        }
+    }
+
+    if( 0 == used )
+    {
+        return 0.0f;
+    }
+
+    baseline /= used;
+    double minimum = baseline;
+
+    for( int i = 0; i < aCount; i++ )
+    {
+        if( !isnan( aValues[i] ) && aValues[i] < minimum )
+        {
+            minimum = aValues[i];
+        }
+    }
+
+    return static_cast<float>( baseline - minimum );
+}
+
+//!************************************************************************
+//! Get the recorded events
+//!
+//! @returns: the completed events, in time order
+//!************************************************************************
+const std::vector<SyncLossDetector::Event>& SyncLossDetector::events() const
+{
+    return mEvents;
+}
+
+//!************************************************************************
+//! Complete the pending event
+//!
+//! @returns: nothing
+//!************************************************************************
+void SyncLossDetector::finishEvent()
+{
+    mPending.SnrDropDb = dropOf( mPending.RxSnrDb, mPending.PointCount, mPending.TriggerIndex );
+    mPending.RxPwrDropDb = dropOf( mPending.RxPwrDbm, mPending.PointCount, mPending.TriggerIndex );
+
+    mEvents.push_back( mPending );
+    mPendingActive = false;
+}
+
+//!************************************************************************
+//! Check the newest sample of a history for an increment of the
+//! loss-of-sync count. Increments while an event is being recorded are
+//! merged into that event; a decrement, e.g. a modem reboot, only resets
+//! the reference count.
+//!
+//! @returns: true if an event was completed
+//!************************************************************************
+bool SyncLossDetector::update
+    (
+    const SampleHistory&    aHistory    //!< history, with the new sample pushed last
+    )
+{
+    if( 0 == aHistory.size() )
+    {
+        return false;
+    }
+
+    const MetricSample& sample = aHistory.newest();
+    const double count = sample.Values[METRIC_LOSS_OF_SYNC_COUNT];
+    const bool increment = !isnan( count ) && mHasPreviousCount && count > mPreviousCount;
+
+    if( mPendingActive )
+    {
+        appendPoint( sample );
+
+        if( increment )
+        {
+            mPending.Increment = static_cast<uint16_t>( mPending.Increment + ( count - mPreviousCount ) );
+            mPending.LossOfSyncCount = static_cast<uint32_t>( count );
+        }
+    }
+    else if( increment )
+    {
+        mPending = Event();
+        mPending.TimeMs = sample.TimeMs;
+        mPending.LossOfSyncCount = static_cast<uint32_t>( count );
+        mPending.Increment = static_cast<uint16_t>( count - mPreviousCount );
+
+        const size_t preCount = aHistory.size() > static_cast<size_t>( PRE_SAMPLES + 1 ) ? PRE_SAMPLES + 1 : aHistory.size();
+
+        for( size_t i = aHistory.size() - preCount; i < aHistory.size(); i++ )
+        {
+            appendPoint( aHistory.at( i ) );
+        }
+
+        mPending.TriggerIndex = static_cast<uint16_t>( mPending.PointCount - 1 );
+        mPendingActive = true;
+        mPostRemaining = POST_SAMPLES + 1;
+    }
+
+    if( !isnan( count ) )
+    {
+        mPreviousCount = count;
+        mHasPreviousCount = true;
+    }
+
+    if( mPendingActive && 0 == --mPostRemaining )
+    {
+        finishEvent();
+        return true;
+    }
+
+    return false;
+}
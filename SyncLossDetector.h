@@ -0,0 +1,106 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+SyncLossDetector.h
+
+This file contains the definitions for the detection of loss-of-sync
+events.
+*/
+
+#ifndef SyncLossDetector_h
+#define SyncLossDetector_h
+
+#include <cstdint>
+#include <vector>
+
+#include "SampleHistory.h"
+
+
+//************************************************************************
+// Class for detecting increments of the loss-of-sync count. Each
+// increment is recorded with the SNR, Rx power and Tx power of the
+// samples around it, so that a sync loss after a slow fade of both the
+// SNR and the Rx power (e.g. rain) can be told apart from one without a
+// fade (e.g. pointing or cabling).
+//************************************************************************
+class SyncLossDetector
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        static const int PRE_SAMPLES = 20;                                  //!< samples recorded before the increment
+        static const int POST_SAMPLES = 20;                                 //!< samples recorded after the increment
+        static const int WINDOW_SIZE = PRE_SAMPLES + 1 + POST_SAMPLES;      //!< samples recorded per event
+
+        typedef struct
+        {
+            int64_t                     TimeMs;                     //!< time of the sample showing the increment
+            uint32_t                    LossOfSyncCount;            //!< count after the last increment of the event
+            uint16_t                    Increment;                  //!< count increase during the event
+            uint16_t                    PointCount;                 //!< number of recorded samples
+            uint16_t                    TriggerIndex;               //!< index of the sample showing the increment
+            int32_t                     OffsetMs[WINDOW_SIZE];      //!< time of each sample, relative to TimeMs
+            float                       RxSnrDb[WINDOW_SIZE];       //!< Rx SNR of each sample [dB]
+            float                       RxPwrDbm[WINDOW_SIZE];      //!< Rx power of each sample [dBm]
+            float                       TxRfPwrDbm[WINDOW_SIZE];    //!< Tx RF power of each sample [dBm]
+            float                       SnrDropDb;                  //!< SNR drop from the start of the window to its minimum [dB]
+            float                       RxPwrDropDb;                //!< Rx power drop from the start of the window to its minimum [dB]
+        }Event;
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        SyncLossDetector();
+
+        const std::vector<Event>& events() const;
+
+        bool update
+            (
+            const SampleHistory&    aHistory    //!< history, with the new sample pushed last
+            );
+
+    private:
+        void appendPoint
+            (
+            const MetricSample&     aSample     //!< sample to record
+            );
+
+        void finishEvent();
+
+        static float dropOf
+            (
+            const float*            aValues,    //!< recorded values
+            const int               aCount,     //!< number of recorded values
+            const int               aTrigger    //!< index of the sample showing the increment
+            );
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        std::vector<Event>          mEvents;            //!< completed events, in time order
+        Event                       mPending;           //!< event waiting for its post samples
+        bool                        mPendingActive;     //!< true if mPending is being recorded
+        int                         mPostRemaining;     //!< post samples still to record
+        double                      mPreviousCount;     //!< loss-of-sync count of the previous sample
+        bool                        mHasPreviousCount;  //!< true if mPreviousCount is set
+};
+
+#endif // SyncLossDetector_h
@@ -0,0 +1,214 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+WorkStealingPool.cpp
+
+This file contains the sources for the work-stealing thread pool.
+*/
+
+#include "WorkStealingPool.h"
+
+
+//!************************************************************************
+//! Constructor
+//!************************************************************************
+WorkStealingPool::WorkStealingPool
+    (
+    const unsigned aThreadCount     //!< number of threads, 0 for one per core
+    )
+    : mPending( 0 )
+    , mQueued( 0 )
+    , mNextWorker( 0 )
+    , mStopping( false )
+{
+    unsigned threadCount = aThreadCount;
+
+    if( 0 == threadCount )
+    {
+        threadCount = std::thread::hardware_concurrency();
+    }
+
+    if( 0 == threadCount )
+    {
+        threadCount = 1;
+    }
+
+    for( unsigned i = 0; i < threadCount; i++ )
+    {
+        mWorkers.push_back( new Worker );
+    }
+
+    for( unsigned i = 0; i < threadCount; i++ )
+    {
+        mThreads.push_back( std::thread( &WorkStealingPool::run, this, i ) );
+    }
+}
+
+//!************************************************************************
+//! Destructor. Pending tasks are completed before the threads exit.
+//!************************************************************************
+WorkStealingPool::~WorkStealingPool()
+{
+    wait();
+
+    {
+        std::lock_guard<std::mutex> lock( mStateMutex );
+        mStopping = true;
+    }
+
+    mWorkAvailable.notify_all();
+
+    for( size_t i = 0; i < mThreads.size(); i++ )
+    {
+        mThreads[i].join();
+    }
+
+    for( size_t i = 0; i < mWorkers.size(); i++ )
+    {
+        delete mWorkers[i];
+    }
+}
+
+//!************************************************************************
+//! Worker thread loop
+//!
+//! @returns: nothing
+//!************************************************************************
+void WorkStealingPool::run
+    (
+    const unsigned aIndex   //!< index of the worker thread
+    )
+{
+    for( ;; )
+    {
+        Task task;
+
+        if( takeTask( aIndex, task ) )
+        {
+            task();
+
+            if( 1 == mPending.fetch_sub( 1 ) )
+            {
+                std::lock_guard<std::mutex> lock( mStateMutex );
+                mIdle.notify_all();
+            }
+
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock( mStateMutex );
+        mWorkAvailable.wait( lock, [this]{ return mStopping || mQueued.load() > 0; } );
+
+        if( mStopping && 0 == mQueued.load() )
+        {
+            return;
+        }
+    }
+}
+
+//!************************************************************************
+//! Queue a task. Tasks are spread over the threads round robin; a task
+//! may submit further tasks.
+//!
+//! @returns: nothing
+//!************************************************************************
+void WorkStealingPool::submit
+    (
+    const Task& aTask   //!< task to run
+    )
+{
+    Worker* worker = mWorkers[mNextWorker.fetch_add( 1 ) % mWorkers.size()];
+
+    // counted before being queued, so that the counters never run below
+    // the number of tasks a thread can take
+    mPending.fetch_add( 1 );
+
+    {
+        std::lock_guard<std::mutex> lock( mStateMutex );
+        mQueued.fetch_add( 1 );
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( worker->Mutex );
+        worker->Queue.push_back( aTask );
+    }
+
+    mWorkAvailable.notify_one();
+}
+
+//!************************************************************************
+//! Take the newest task of the own queue, or else steal the oldest task
+//! of another queue
+//!
+//! @returns: true if a task was taken
+//!************************************************************************
+bool WorkStealingPool::takeTask
+    (
+    const unsigned  aIndex,     //!< index of the worker thread
+    Task&           aTask       //!< task taken
+    )
+{
+    const size_t count = mWorkers.size();
+
+    for( size_t i = 0; i < count; i++ )
+    {
+        Worker* worker = mWorkers[( aIndex + i ) % count];
+        std::lock_guard<std::mutex> lock( worker->Mutex );
+
+        if( !worker->Queue.empty() )
+        {
+            if( 0 == i )
+            {
+                aTask = worker->Queue.back();
+                worker->Queue.pop_back();
+            }
+            else
+            {
+                aTask = worker->Queue.front();
+                worker->Queue.pop_front();
+            }
+
+            mQueued.fetch_sub( 1 );
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//!************************************************************************
+//! Get the number of worker threads
+//!
+//! @returns: the number of threads
+//!************************************************************************
+unsigned WorkStealingPool::threadCount() const
+{
+    return static_cast<unsigned>( mThreads.size() );
+}
+
+//!************************************************************************
+//! Block until all submitted tasks, including the tasks they submitted,
+//! have completed. Must not be called from a task.
+//!
+//! @returns: nothing
+//!************************************************************************
+void WorkStealingPool::wait()
+{
+    std::unique_lock<std::mutex> lock( mStateMutex );
+    mIdle.wait( lock, [this]{ return 0 == mPending.load(); } );
+}
@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+WorkStealingPool.h
+
+This file contains the definitions for the work-stealing thread pool.
+*/
+
+#ifndef WorkStealingPool_h
+#define WorkStealingPool_h
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+//************************************************************************
+// Class for running tasks on a fixed set of threads. Each thread has its
+// own task queue and takes its newest task first; a thread running out of
+// tasks steals the oldest task of another thread, so uneven tasks (e.g.
+// capture files of different sizes) still keep all cores busy.
+//************************************************************************
+class WorkStealingPool
+{
+    //************************************************************************
+    // constants and types
+    //************************************************************************
+    public:
+        typedef std::function<void()> Task;
+
+    private:
+        typedef struct
+        {
+            std::mutex                  Mutex;      //!< guards the queue
+            std::deque<Task>            Queue;      //!< pending tasks, newest at the back
+        }Worker;
+
+    //************************************************************************
+    // functions
+    //************************************************************************
+    public:
+        explicit WorkStealingPool
+            (
+            const unsigned aThreadCount = 0     //!< number of threads, 0 for one per core
+            );
+
+        ~WorkStealingPool();
+
+        void submit
+            (
+            const Task& aTask                   //!< task to run
+            );
+
+        unsigned threadCount() const;
+
+        void wait();
+
+    private:
+        void run
+            (
+            const unsigned aIndex               //!< index of the worker thread
+            );
+
+        bool takeTask
+            (
+            const unsigned  aIndex,             //!< index of the worker thread
+            Task&           aTask               //!< task taken
+            );
+
+    //************************************************************************
+    // variables
+    //************************************************************************
+    private:
+        std::vector<Worker*>        mWorkers;           //!< per thread task queues
+        std::vector<std::thread>    mThreads;           //!< worker threads
+
+        std::mutex                  mStateMutex;        //!< guards the wake-up and idle conditions
+        std::condition_variable     mWorkAvailable;     //!< signalled when a task is submitted
+        std::condition_variable     mIdle;              //!< signalled when the last pending task completes
+
+        std::atomic<size_t>         mPending;           //!< tasks submitted and not yet completed
+        std::atomic<size_t>         mQueued;            //!< tasks submitted and not yet taken
+        std::atomic<unsigned>       mNextWorker;        //!< round robin queue for the next submitted task
+        bool                        mStopping;          //!< set when the threads must exit
+};
+
+#endif // WorkStealingPool_h
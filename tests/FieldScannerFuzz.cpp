@@ -0,0 +1,158 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2021 Mihai Ursu                                                 //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+// (at your option) any later version.                                           //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+/*
+FieldScannerFuzz.cpp
+
+This file contains a randomised check of the vector implementations of
+the "##" delimiter scanner against the scalar one.
+
+Usage: FieldScannerFuzz [iterations] [seed]
+*/
+
+#include "FieldScanner.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+
+static const int DEFAULT_ITERATIONS = 200000;   //!< payloads checked by default
+static const int MAX_LENGTH = 300;              //!< longest payload, spanning several AVX2 steps
+static const int MAX_OFFSET = 32;               //!< largest misalignment of the payload
+
+
+//!************************************************************************
+//! Get the next pseudo random number (xorshift64)
+//!
+//! @returns: the next number
+//!************************************************************************
+static uint64_t nextRandom
+    (
+    uint64_t&   aState          //!< generator state
+    )
+{
+    aState ^= aState << 13;
+    aState ^= aState >> 7;
+    aState ^= aState << 17;
+    return aState;
+}
+
+//!************************************************************************
+//! Fill a payload with mostly '#', in runs of random length, so that odd
+//! and even runs straddle the vector boundaries
+//!
+//! @returns: nothing
+//!************************************************************************
+static void makePayload
+    (
+    uint64_t&   aState,         //!< generator state
+    char*       aData,          //!< payload bytes
+    const int   aLength         //!< payload length
+    )
+{
+    const char OTHER_CHARACTERS[] = { 'a', '0', '.', ' ', '\0', '\xA3' };
+
+    int i = 0;
+
+    while( i < aLength )
+    {
+        const int run = 1 + static_cast<int>( nextRandom( aState ) % 6 );
+        const bool hashes = ( nextRandom( aState ) % 4 ) != 0;
+
+        for( int j = 0; j < run && i < aLength; j++, i++ )
+        {
+            aData[i] = hashes ? '#' : OTHER_CHARACTERS[nextRandom( aState ) % sizeof( OTHER_CHARACTERS )];
+        }
+    }
+}
+
+//!************************************************************************
+//! Main function
+//!
+//! @returns: 0 if every implementation matched the scalar one
+//!************************************************************************
+int main
+    (
+    int     argc,
+    char*   argv[]
+    )
+{
+    const char* const NAMES[FieldScanner::IMPLEMENTATION_COUNT] = { "scalar", "SSE2", "AVX2", "NEON" };
+
+    const int iterations = ( argc > 1 ) ? atoi( argv[1] ) : DEFAULT_ITERATIONS;
+    uint64_t state = ( argc > 2 ) ? strtoull( argv[2], nullptr, 10 ) : 0x9E3779B97F4A7C15ull;
+
+    if( 0 == state )
+    {
+        state = 1;
+    }
+
+    std::vector<char> buffer( MAX_OFFSET + MAX_LENGTH );
+    std::vector<int> expected;
+    std::vector<int> actual;
+    int failures = 0;
+
+    for( int implementation = FieldScanner::IMPLEMENTATION_SCALAR + 1; implementation < FieldScanner::IMPLEMENTATION_COUNT; implementation++ )
+    {
+        printf( "%s: %s\n", NAMES[implementation],
+                FieldScanner::isSupported( static_cast<FieldScanner::Implementation>( implementation ) ) ? "checked" : "not supported, skipped" );
+    }
+
+    for( int i = 0; i < iterations && failures < 10; i++ )
+    {
+        const int offset = static_cast<int>( nextRandom( state ) % MAX_OFFSET );
+        const int length = static_cast<int>( nextRandom( state ) % ( MAX_LENGTH + 1 ) );
+        char* const data = buffer.data() + offset;
+
+        makePayload( state, data, length );
+
+        expected.clear();
+        FieldScanner::scan( FieldScanner::IMPLEMENTATION_SCALAR, data, length, expected );
+
+        for( int implementation = FieldScanner::IMPLEMENTATION_SCALAR + 1; implementation < FieldScanner::IMPLEMENTATION_COUNT; implementation++ )
+        {
+            if( !FieldScanner::isSupported( static_cast<FieldScanner::Implementation>( implementation ) ) )
+            {
+                continue;
+            }
+
+            actual.clear();
+            FieldScanner::scan( static_cast<FieldScanner::Implementation>( implementation ), data, length, actual );
+
+            if( actual != expected )
+            {
+                // unprintable bytes are shown as '~'
+                std::string payload( data, length );
+
+                for( size_t j = 0; j < payload.size(); j++ )
+                {
+                    payload[j] = ( payload[j] >= ' ' && payload[j] <= '}' ) ? payload[j] : '~';
+                }
+
+                failures++;
+                printf( "%s mismatch at iteration %d: offset %d, length %d, %zu fields instead of %zu\n  payload: %s\n",
+                        NAMES[implementation], i, offset, length, actual.size(), expected.size(), payload.c_str() );
+            }
+        }
+    }
+
+    printf( "%d payloads, %d mismatches\n", iterations, failures );
+    return failures > 0 ? 1 : 0;
+}